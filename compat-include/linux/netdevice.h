@@ -104,12 +104,16 @@ static inline int batadv_netdev_set_master(struct net_device *slave,
 /* alloc_netdev() was defined differently before 2.6.38 */
 #undef alloc_netdev
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2, 6, 38)
-#define alloc_netdev(sizeof_priv, name, name_assign_type, setup) \
-	alloc_netdev_mq(sizeof_priv, name, setup, 1)
+#define alloc_netdev_mqs(sizeof_priv, name, name_assign_type, setup, txqs, \
+			 rxqs) \
+	alloc_netdev_mq(sizeof_priv, name, setup, txqs)
 #else
-#define alloc_netdev(sizeof_priv, name, name_assign_type, setup) \
-	alloc_netdev_mqs(sizeof_priv, name, setup, 1, 1)
+#define alloc_netdev_mqs(sizeof_priv, name, name_assign_type, setup, txqs, \
+			 rxqs) \
+	alloc_netdev_mqs(sizeof_priv, name, setup, txqs, rxqs)
 #endif /* nested < KERNEL_VERSION(2, 6, 38) */
+#define alloc_netdev(sizeof_priv, name, name_assign_type, setup) \
+	alloc_netdev_mqs(sizeof_priv, name, name_assign_type, setup, 1, 1)
 
 #endif /* < KERNEL_VERSION(3, 17, 0) */
 
@@ -119,6 +123,16 @@ static inline int batadv_netdev_set_master(struct net_device *slave,
 
 #endif /* < KERNEL_VERSION(3, 19, 0) */
 
+#if LINUX_VERSION_CODE < KERNEL_VERSION(4, 0, 0)
+
+/* rtnl_link_ops->get_link_net() is missing, the parent of a device is always
+ * looked up in the fallback net namespace given to batadv_getlink_net()
+ */
+#define get_link_net get_size || 1 ? fallback_net : \
+	(struct net *)netdev->rtnl_link_ops->get_size
+
+#endif /* < KERNEL_VERSION(4, 0, 0) */
+
 #if LINUX_VERSION_CODE < KERNEL_VERSION(3, 9, 0)
 
 #define netdev_master_upper_dev_link(dev, upper_dev, upper_priv, upper_info) \
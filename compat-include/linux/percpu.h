@@ -45,4 +45,12 @@ static inline void batadv_this_cpu_add(u64 *count_ptr, size_t count)
 
 #endif /* < KERNEL_VERSION(2, 6, 33) */
 
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3, 18, 0)
+
+/* per cpu memory can only be allocated atomically since 3.18 */
+#define __alloc_percpu_gfp(size, align, gfp) \
+	(((gfp) & __GFP_WAIT) ? __alloc_percpu(size, align) : NULL)
+
+#endif /* < KERNEL_VERSION(3, 18, 0) */
+
 #endif	/* _NET_BATMAN_ADV_COMPAT_LINUX_PERCPU_H_ */
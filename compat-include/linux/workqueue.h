@@ -0,0 +1,45 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ * This file contains macros for maintaining compatibility with older versions
+ * of the Linux kernel.
+ */
+
+#ifndef _NET_BATMAN_ADV_COMPAT_LINUX_WORKQUEUE_H_
+#define _NET_BATMAN_ADV_COMPAT_LINUX_WORKQUEUE_H_
+
+#include <linux/version.h>
+#include_next <linux/workqueue.h>
+
+#include <linux/types.h>
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3, 7, 0)
+
+#define mod_delayed_work(__wq, __dwork, __delay) \
+	batadv_mod_delayed_work(__wq, __dwork, __delay)
+
+static inline bool batadv_mod_delayed_work(struct workqueue_struct *wq,
+					   struct delayed_work *dwork,
+					   unsigned long delay)
+{
+	bool pending = cancel_delayed_work(dwork);
+
+	queue_delayed_work(wq, dwork, delay);
+
+	return pending;
+}
+
+#endif /* < KERNEL_VERSION(3, 7, 0) */
+
+#endif	/* _NET_BATMAN_ADV_COMPAT_LINUX_WORKQUEUE_H_ */
@@ -0,0 +1,204 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _UAPI_LINUX_BATMAN_ADV_H_
+#define _UAPI_LINUX_BATMAN_ADV_H_
+
+#define BATADV_NL_NAME "batadv"
+
+/**
+ * enum batadv_nl_attrs - batman-adv netlink attributes
+ *
+ * @BATADV_ATTR_UNSPEC: unspecified attribute to catch errors
+ * @BATADV_ATTR_MESH_IFINDEX: index of the batman-adv interface (u32)
+ * @BATADV_ATTR_HARD_IFINDEX: index of the outgoing/incoming hard interface
+ *  (u32)
+ * @BATADV_ATTR_ORIG_ADDRESS: originator mac address (6 bytes)
+ * @BATADV_ATTR_NEIGH_ADDRESS: neighbor mac address (6 bytes)
+ * @BATADV_ATTR_LAST_SEEN_MSECS: milliseconds since the entry was last seen or
+ *  updated (u32)
+ * @BATADV_ATTR_TQ: B.A.T.M.A.N. IV link quality towards the originator (u8)
+ * @BATADV_ATTR_THROUGHPUT: B.A.T.M.A.N. V estimated throughput towards the
+ *  originator in 100 kbit/s (u32)
+ * @BATADV_ATTR_FLAG_BEST: flag marking the selected router or gateway
+ * @BATADV_ATTR_TT_ADDRESS: client mac address (6 bytes)
+ * @BATADV_ATTR_TT_TTVN: translation table version of the announcement (u8)
+ * @BATADV_ATTR_TT_LAST_TTVN: current translation table version of the
+ *  announcing originator (u8)
+ * @BATADV_ATTR_TT_CRC32: crc32 of the announcing originator's vlan table (u32)
+ * @BATADV_ATTR_TT_VID: vlan of the client (u16, BATADV_VLAN_HAS_TAG encoded)
+ * @BATADV_ATTR_TT_FLAGS: BATADV_TT_CLIENT_* flags of the client (u32)
+ * @BATADV_ATTR_BLA_OWN: flag marking claims of our own backbone gateway
+ * @BATADV_ATTR_BLA_ADDRESS: claimed client mac address (6 bytes)
+ * @BATADV_ATTR_BLA_VID: vlan of the claim (u16, BATADV_VLAN_HAS_TAG encoded)
+ * @BATADV_ATTR_BLA_BACKBONE: backbone gateway owning the claim (6 bytes)
+ * @BATADV_ATTR_BLA_CRC: crc16 of all claims of the backbone gateway (u16)
+ * @BATADV_ATTR_DAT_CACHE_IP4ADDRESS: IPv4 address of the entry (be32)
+ * @BATADV_ATTR_DAT_CACHE_HWADDRESS: mac address of the entry (6 bytes)
+ * @BATADV_ATTR_DAT_CACHE_VID: vlan of the entry (u16, BATADV_VLAN_HAS_TAG
+ *  encoded)
+ * @BATADV_ATTR_BANDWIDTH_DOWN: announced gateway download bandwidth in
+ *  100 kbit/s (u32)
+ * @BATADV_ATTR_BANDWIDTH_UP: announced gateway upload bandwidth in
+ *  100 kbit/s (u32)
+ * @BATADV_ATTR_ROUTER: next hop towards the gateway (6 bytes)
+ * @BATADV_ATTR_FILTER_ORIG: dump request filter - only report entries of this
+ *  originator (6 bytes)
+ * @BATADV_ATTR_FILTER_VID: dump request filter - only report entries of this
+ *  vlan (u16, BATADV_VLAN_HAS_TAG encoded)
+ * @BATADV_ATTR_FILTER_TTVN: dump request filter - only report translation
+ *  table entries announced with a ttvn newer than this one (u8)
+ * @BATADV_ATTR_DAT_CACHE_IP6ADDRESS: IPv6 address of the entry (16 bytes)
+ * @BATADV_ATTR_TPMETER_COOKIE: identifier of a throughput meter session (u32)
+ * @BATADV_ATTR_TPMETER_TEST_TIME: requested duration of a throughput test or
+ *  time the test has been running so far (u32, milliseconds)
+ * @BATADV_ATTR_TPMETER_RESULT: reason why a throughput test stopped (u8, see
+ *  enum batadv_tp_meter_reason). Absent while the test is running
+ * @BATADV_ATTR_TPMETER_BYTES: payload bytes acknowledged by the receiver
+ *  (u64)
+ * @BATADV_ATTR_TPMETER_RTT: smoothed round trip time (u32, microseconds)
+ * @BATADV_ATTR_TPMETER_PACKETS: test packets sent including retransmissions
+ *  (u32)
+ * @BATADV_ATTR_TPMETER_RETRANSMITS: test packets sent again because they were
+ *  considered lost (u32)
+ * @BATADV_ATTR_ORIG_TX_PACKETS: unicast packets originated by this node and
+ *  sent towards the originator (u64)
+ * @BATADV_ATTR_ORIG_TX_BYTES: bytes of the BATADV_ATTR_ORIG_TX_PACKETS (u64)
+ * @BATADV_ATTR_ORIG_FWD_PACKETS: unicast packets forwarded towards the
+ *  originator (u64)
+ * @BATADV_ATTR_ORIG_FWD_BYTES: bytes of the BATADV_ATTR_ORIG_FWD_PACKETS (u64)
+ * @BATADV_ATTR_NEIGH_TX_PACKETS: unicast packets originated by this node and
+ *  sent via the neighbor (u64)
+ * @BATADV_ATTR_NEIGH_TX_BYTES: bytes of the BATADV_ATTR_NEIGH_TX_PACKETS (u64)
+ * @BATADV_ATTR_NEIGH_FWD_PACKETS: unicast packets forwarded via the neighbor
+ *  (u64)
+ * @BATADV_ATTR_NEIGH_FWD_BYTES: bytes of the BATADV_ATTR_NEIGH_FWD_PACKETS
+ *  (u64)
+ * @__BATADV_ATTR_AFTER_LAST: internal use
+ * @NUM_BATADV_ATTR: total number of batadv_nl_attrs available
+ * @BATADV_ATTR_MAX: highest attribute number currently defined
+ */
+enum batadv_nl_attrs {
+	BATADV_ATTR_UNSPEC,
+	BATADV_ATTR_MESH_IFINDEX,
+	BATADV_ATTR_HARD_IFINDEX,
+	BATADV_ATTR_ORIG_ADDRESS,
+	BATADV_ATTR_NEIGH_ADDRESS,
+	BATADV_ATTR_LAST_SEEN_MSECS,
+	BATADV_ATTR_TQ,
+	BATADV_ATTR_THROUGHPUT,
+	BATADV_ATTR_FLAG_BEST,
+	BATADV_ATTR_TT_ADDRESS,
+	BATADV_ATTR_TT_TTVN,
+	BATADV_ATTR_TT_LAST_TTVN,
+	BATADV_ATTR_TT_CRC32,
+	BATADV_ATTR_TT_VID,
+	BATADV_ATTR_TT_FLAGS,
+	BATADV_ATTR_BLA_OWN,
+	BATADV_ATTR_BLA_ADDRESS,
+	BATADV_ATTR_BLA_VID,
+	BATADV_ATTR_BLA_BACKBONE,
+	BATADV_ATTR_BLA_CRC,
+	BATADV_ATTR_DAT_CACHE_IP4ADDRESS,
+	BATADV_ATTR_DAT_CACHE_HWADDRESS,
+	BATADV_ATTR_DAT_CACHE_VID,
+	BATADV_ATTR_BANDWIDTH_DOWN,
+	BATADV_ATTR_BANDWIDTH_UP,
+	BATADV_ATTR_ROUTER,
+	BATADV_ATTR_FILTER_ORIG,
+	BATADV_ATTR_FILTER_VID,
+	BATADV_ATTR_FILTER_TTVN,
+	BATADV_ATTR_DAT_CACHE_IP6ADDRESS,
+	BATADV_ATTR_TPMETER_COOKIE,
+	BATADV_ATTR_TPMETER_TEST_TIME,
+	BATADV_ATTR_TPMETER_RESULT,
+	BATADV_ATTR_TPMETER_BYTES,
+	BATADV_ATTR_TPMETER_RTT,
+	BATADV_ATTR_TPMETER_PACKETS,
+	BATADV_ATTR_TPMETER_RETRANSMITS,
+	BATADV_ATTR_ORIG_TX_PACKETS,
+	BATADV_ATTR_ORIG_TX_BYTES,
+	BATADV_ATTR_ORIG_FWD_PACKETS,
+	BATADV_ATTR_ORIG_FWD_BYTES,
+	BATADV_ATTR_NEIGH_TX_PACKETS,
+	BATADV_ATTR_NEIGH_TX_BYTES,
+	BATADV_ATTR_NEIGH_FWD_PACKETS,
+	BATADV_ATTR_NEIGH_FWD_BYTES,
+	/* add attributes above here, update the policy in netlink.c */
+	__BATADV_ATTR_AFTER_LAST,
+	NUM_BATADV_ATTR = __BATADV_ATTR_AFTER_LAST,
+	BATADV_ATTR_MAX = __BATADV_ATTR_AFTER_LAST - 1
+};
+
+/**
+ * enum batadv_nl_commands - supported batman-adv netlink commands
+ *
+ * All GET commands only support dumps. The request must carry
+ * BATADV_ATTR_MESH_IFINDEX and may carry BATADV_ATTR_FILTER_* attributes. A
+ * dump which doesn't fit into one message is resumed where it stopped.
+ *
+ * The throughput meter commands need BATADV_ATTR_MESH_IFINDEX and
+ * BATADV_ATTR_ORIG_ADDRESS to select the remote end of the test.
+ *
+ * @BATADV_CMD_UNSPEC: unspecified command to catch errors
+ * @BATADV_CMD_GET_ORIGINATORS: dump one message per originator and potential
+ *  next hop. With CONFIG_BATMAN_ADV_TRAFFIC the traffic counters of both are
+ *  included
+ * @BATADV_CMD_GET_TRANSTABLE_GLOBAL: dump one message per global translation
+ *  table client and announcing originator
+ * @BATADV_CMD_GET_BLA_CLAIM: dump the bridge loop avoidance claim table
+ * @BATADV_CMD_GET_DAT_CACHE: dump the distributed arp table cache
+ * @BATADV_CMD_GET_GATEWAYS: dump the list of known gateways
+ * @BATADV_CMD_TP_METER: start a throughput test of
+ *  BATADV_ATTR_TPMETER_TEST_TIME milliseconds. The reply carries the
+ *  BATADV_ATTR_TPMETER_COOKIE of the new session
+ * @BATADV_CMD_TP_METER_CANCEL: stop a running throughput test
+ * @BATADV_CMD_GET_TP_METER: dump the state and results of the throughput
+ *  tests started by this node
+ * @__BATADV_CMD_AFTER_LAST: internal use
+ * @BATADV_CMD_MAX: highest used command number
+ */
+enum batadv_nl_commands {
+	BATADV_CMD_UNSPEC,
+	BATADV_CMD_GET_ORIGINATORS,
+	BATADV_CMD_GET_TRANSTABLE_GLOBAL,
+	BATADV_CMD_GET_BLA_CLAIM,
+	BATADV_CMD_GET_DAT_CACHE,
+	BATADV_CMD_GET_GATEWAYS,
+	BATADV_CMD_TP_METER,
+	BATADV_CMD_TP_METER_CANCEL,
+	BATADV_CMD_GET_TP_METER,
+	/* add new commands above here */
+	__BATADV_CMD_AFTER_LAST,
+	BATADV_CMD_MAX = __BATADV_CMD_AFTER_LAST - 1
+};
+
+/**
+ * enum batadv_tp_meter_reason - reason of a throughput test termination
+ * @BATADV_TP_REASON_COMPLETE: sender finished the test successfully
+ * @BATADV_TP_REASON_CANCEL: the test was cancelled by userspace
+ * @BATADV_TP_REASON_DST_UNREACHABLE: receiver could not be reached or didn't
+ *  answer
+ * @BATADV_TP_REASON_RESEND_LIMIT: too many retransmissions without progress
+ */
+enum batadv_tp_meter_reason {
+	BATADV_TP_REASON_COMPLETE		= 3,
+	BATADV_TP_REASON_CANCEL			= 4,
+	/* error status >= 128 */
+	BATADV_TP_REASON_DST_UNREACHABLE	= 128,
+	BATADV_TP_REASON_RESEND_LIMIT		= 129,
+};
+
+#endif /* _UAPI_LINUX_BATMAN_ADV_H_ */
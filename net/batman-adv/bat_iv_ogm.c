@@ -30,8 +30,11 @@
 #include <linux/if_ether.h>
 #include <linux/init.h>
 #include <linux/jiffies.h>
+#include <linux/kernel.h>
+#include <linux/ktime.h>
 #include <linux/list.h>
 #include <linux/kref.h>
+#include <linux/lockdep.h>
 #include <linux/netdevice.h>
 #include <linux/pkt_sched.h>
 #include <linux/printk.h>
@@ -46,10 +49,13 @@
 #include <linux/string.h>
 #include <linux/types.h>
 #include <linux/workqueue.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "bitarray.h"
 #include "hard-interface.h"
 #include "hash.h"
+#include "latency.h"
 #include "network-coding.h"
 #include "originator.h"
 #include "packet.h"
@@ -125,53 +131,75 @@ static void batadv_iv_ogm_orig_free(struct batadv_orig_node *orig_node)
 {
 	kfree(orig_node->bat_iv.bcast_own);
 	kfree(orig_node->bat_iv.bcast_own_sum);
+	kfree(orig_node->bat_iv.own_slides);
 }
 
 /**
- * batadv_iv_ogm_orig_add_if - change the private structures of the orig_node to
- *  include the new hard-interface
+ * batadv_iv_ogm_orig_own_grow - make sure the per interface windows of an
+ *  orig_node cover the given interface
  * @orig_node: the orig_node that has to be changed
- * @max_if_num: the current amount of interfaces
+ * @if_num: the interface number which has to be covered
  *
- * Return: 0 on success, a negative error code otherwise.
+ * Interfaces joining the mesh do not touch the originators. Instead, the per
+ * interface arrays of an orig_node are only enlarged when a window of an
+ * interface not covered yet is accessed. The new slots start out empty.
+ *
+ * Return: true if the arrays cover @if_num, false if the allocation failed.
  */
-static int batadv_iv_ogm_orig_add_if(struct batadv_orig_node *orig_node,
-				     int max_if_num)
+static bool batadv_iv_ogm_orig_own_grow(struct batadv_orig_node *orig_node,
+					int if_num)
 {
+	struct batadv_orig_bat_iv *bat_iv = &orig_node->bat_iv;
+	size_t chunk_size = sizeof(unsigned long) * BATADV_NUM_WORDS;
+	unsigned int old_num = bat_iv->num_ifaces;
+	unsigned int new_num;
 	void *data_ptr;
-	size_t old_size;
-	int ret = -ENOMEM;
 
-	spin_lock_bh(&orig_node->bat_iv.ogm_cnt_lock);
+	lockdep_assert_held(&bat_iv->ogm_cnt_lock);
 
-	old_size = (max_if_num - 1) * sizeof(unsigned long) * BATADV_NUM_WORDS;
-	data_ptr = kmalloc_array(max_if_num,
-				 BATADV_NUM_WORDS * sizeof(unsigned long),
-				 GFP_ATOMIC);
-	if (!data_ptr)
-		goto unlock;
+	if (if_num < 0)
+		return false;
 
-	memcpy(data_ptr, orig_node->bat_iv.bcast_own, old_size);
-	kfree(orig_node->bat_iv.bcast_own);
-	orig_node->bat_iv.bcast_own = data_ptr;
+	if (if_num < old_num)
+		return true;
 
-	data_ptr = kmalloc_array(max_if_num, sizeof(u8), GFP_ATOMIC);
-	if (!data_ptr) {
-		kfree(orig_node->bat_iv.bcast_own);
-		goto unlock;
-	}
+	/* leave room for the other interfaces of the mesh right away */
+	new_num = max_t(unsigned int, if_num + 1,
+			orig_node->bat_priv->num_ifaces);
 
-	memcpy(data_ptr, orig_node->bat_iv.bcast_own_sum,
-	       (max_if_num - 1) * sizeof(u8));
-	kfree(orig_node->bat_iv.bcast_own_sum);
-	orig_node->bat_iv.bcast_own_sum = data_ptr;
+	/* the old arrays stay valid (and are kept) when krealloc fails.
+	 * Arrays which were already enlarged are simply reused next time
+	 */
+	data_ptr = krealloc(bat_iv->bcast_own, new_num * chunk_size,
+			    GFP_ATOMIC);
+	if (!data_ptr)
+		return false;
+	bat_iv->bcast_own = data_ptr;
 
-	ret = 0;
+	data_ptr = krealloc(bat_iv->bcast_own_sum, new_num * sizeof(u8),
+			    GFP_ATOMIC);
+	if (!data_ptr)
+		return false;
+	bat_iv->bcast_own_sum = data_ptr;
 
-unlock:
-	spin_unlock_bh(&orig_node->bat_iv.ogm_cnt_lock);
+	data_ptr = krealloc(bat_iv->own_slides, new_num * sizeof(u32),
+			    GFP_ATOMIC);
+	if (!data_ptr)
+		return false;
+	bat_iv->own_slides = data_ptr;
 
-	return ret;
+	/* an empty window stays empty no matter how far it is shifted, hence
+	 * the new slots can start from any slide count
+	 */
+	memset((char *)bat_iv->bcast_own + old_num * chunk_size, 0,
+	       (new_num - old_num) * chunk_size);
+	memset(bat_iv->bcast_own_sum + old_num, 0,
+	       (new_num - old_num) * sizeof(u8));
+	memset(bat_iv->own_slides + old_num, 0,
+	       (new_num - old_num) * sizeof(u32));
+	bat_iv->num_ifaces = new_num;
+
+	return true;
 }
 
 /**
@@ -181,65 +209,135 @@ unlock:
  * @max_if_num: the current amount of interfaces
  * @del_if_num: the index of the interface being removed
  *
+ * The windows of the interfaces following the removed one are moved down by one
+ * slot inside the existing arrays to follow the interface renumbering. Nothing
+ * is reallocated.
+ *
  * Return: 0 on success, a negative error code otherwise.
  */
 static int batadv_iv_ogm_orig_del_if(struct batadv_orig_node *orig_node,
 				     int max_if_num, int del_if_num)
 {
-	int ret = -ENOMEM;
-	size_t chunk_size, if_offset;
-	void *data_ptr = NULL;
-
-	spin_lock_bh(&orig_node->bat_iv.ogm_cnt_lock);
+	struct batadv_orig_bat_iv *bat_iv = &orig_node->bat_iv;
+	size_t chunk_size = sizeof(unsigned long) * BATADV_NUM_WORDS;
+	unsigned int last, move_num;
+	char *bcast_own;
 
-	/* last interface was removed */
-	if (max_if_num == 0)
-		goto free_bcast_own;
+	spin_lock_bh(&bat_iv->ogm_cnt_lock);
 
-	chunk_size = sizeof(unsigned long) * BATADV_NUM_WORDS;
-	data_ptr = kmalloc_array(max_if_num, chunk_size, GFP_ATOMIC);
-	if (!data_ptr)
+	if (del_if_num >= bat_iv->num_ifaces)
 		goto unlock;
 
-	/* copy first part */
-	memcpy(data_ptr, orig_node->bat_iv.bcast_own, del_if_num * chunk_size);
+	last = bat_iv->num_ifaces - 1;
+	move_num = last - del_if_num;
+	bcast_own = (char *)bat_iv->bcast_own;
+
+	memmove(bcast_own + del_if_num * chunk_size,
+		bcast_own + (del_if_num + 1) * chunk_size,
+		move_num * chunk_size);
+	memmove(bat_iv->bcast_own_sum + del_if_num,
+		bat_iv->bcast_own_sum + del_if_num + 1,
+		move_num * sizeof(u8));
+	memmove(bat_iv->own_slides + del_if_num,
+		bat_iv->own_slides + del_if_num + 1,
+		move_num * sizeof(u32));
+
+	/* the interface now owning the last slot had no window stored yet */
+	memset(bcast_own + last * chunk_size, 0, chunk_size);
+	bat_iv->bcast_own_sum[last] = 0;
+	bat_iv->own_slides[last] = 0;
 
-	/* copy second part */
-	if_offset = (del_if_num + 1) * chunk_size;
-	memcpy((char *)data_ptr + del_if_num * chunk_size,
-	       (uint8_t *)orig_node->bat_iv.bcast_own + if_offset,
-	       (max_if_num - del_if_num) * chunk_size);
+unlock:
+	spin_unlock_bh(&bat_iv->ogm_cnt_lock);
 
-free_bcast_own:
-	kfree(orig_node->bat_iv.bcast_own);
-	orig_node->bat_iv.bcast_own = data_ptr;
+	return 0;
+}
+
+/**
+ * batadv_iv_ogm_orig_sync_own - apply pending own OGM window slides
+ * @orig_node: the orig_node owning the window
+ * @hard_iface: the interface the window refers to
+ *
+ * Shift the bcast_own bitfield of the given interface by the amount of slides
+ * performed on hard_iface since the last synchronisation and refresh the
+ * matching bcast_own_sum. Has to be called with orig_node->bat_iv.ogm_cnt_lock
+ * held before the window or its sum are accessed.
+ *
+ * Return: true if the window of hard_iface is available, false otherwise.
+ */
+static bool batadv_iv_ogm_orig_sync_own(struct batadv_orig_node *orig_node,
+					struct batadv_hard_iface *hard_iface)
+{
+	int if_num = hard_iface->if_num;
+	unsigned long *word;
+	u32 slides, delta;
 
-	if (max_if_num == 0)
-		goto free_own_sum;
+	if (!batadv_iv_ogm_orig_own_grow(orig_node, if_num))
+		return false;
 
-	data_ptr = kmalloc_array(max_if_num, sizeof(u8), GFP_ATOMIC);
-	if (!data_ptr) {
-		kfree(orig_node->bat_iv.bcast_own);
-		goto unlock;
-	}
+	slides = (u32)atomic_read(&hard_iface->bat_iv.own_slides);
+	delta = slides - orig_node->bat_iv.own_slides[if_num];
+	if (delta == 0)
+		return true;
 
-	memcpy(data_ptr, orig_node->bat_iv.bcast_own_sum,
-	       del_if_num * sizeof(u8));
+	word = &orig_node->bat_iv.bcast_own[if_num * BATADV_NUM_WORDS];
+	if (delta >= BATADV_TQ_LOCAL_WINDOW_SIZE)
+		bitmap_zero(word, BATADV_TQ_LOCAL_WINDOW_SIZE);
+	else
+		bitmap_shift_left(word, word, delta,
+				  BATADV_TQ_LOCAL_WINDOW_SIZE);
 
-	if_offset = (del_if_num + 1) * sizeof(u8);
-	memcpy((char *)data_ptr + del_if_num * sizeof(u8),
-	       orig_node->bat_iv.bcast_own_sum + if_offset,
-	       (max_if_num - del_if_num) * sizeof(u8));
+	orig_node->bat_iv.bcast_own_sum[if_num] =
+		bitmap_weight(word, BATADV_TQ_LOCAL_WINDOW_SIZE);
+	orig_node->bat_iv.own_slides[if_num] = slides;
 
-free_own_sum:
-	kfree(orig_node->bat_iv.bcast_own_sum);
-	orig_node->bat_iv.bcast_own_sum = data_ptr;
+	return true;
+}
 
-	ret = 0;
-unlock:
+/**
+ * batadv_iv_ogm_orig_own_sum - get the number of own OGMs an orig_node echoed
+ * @orig_node: the orig_node which rebroadcasted the OGMs
+ * @hard_iface: the interface the OGMs were sent on
+ *
+ * Return: the bcast_own_sum of orig_node for hard_iface.
+ */
+static u8 batadv_iv_ogm_orig_own_sum(struct batadv_orig_node *orig_node,
+				     struct batadv_hard_iface *hard_iface)
+{
+	u8 sum = 0;
+
+	spin_lock_bh(&orig_node->bat_iv.ogm_cnt_lock);
+	if (batadv_iv_ogm_orig_sync_own(orig_node, hard_iface))
+		sum = orig_node->bat_iv.bcast_own_sum[hard_iface->if_num];
 	spin_unlock_bh(&orig_node->bat_iv.ogm_cnt_lock);
 
-	return ret;
+	return sum;
+}
+
+/**
+ * batadv_iv_ogm_orig_own_mark - record an own OGM echoed by an orig_node
+ * @orig_node: the orig_node which rebroadcasted the OGM
+ * @hard_iface: the interface the OGM was sent on
+ * @bit_pos: position of the OGM in the window of hard_iface
+ */
+static void batadv_iv_ogm_orig_own_mark(struct batadv_orig_node *orig_node,
+					struct batadv_hard_iface *hard_iface,
+					s32 bit_pos)
+{
+	int if_num = hard_iface->if_num;
+	unsigned long *word;
+
+	spin_lock_bh(&orig_node->bat_iv.ogm_cnt_lock);
+	if (!batadv_iv_ogm_orig_sync_own(orig_node, hard_iface))
+		goto unlock;
+
+	word = &orig_node->bat_iv.bcast_own[if_num * BATADV_NUM_WORDS];
+	batadv_set_bit(word, bit_pos);
+	orig_node->bat_iv.bcast_own_sum[if_num] =
+		bitmap_weight(word, BATADV_TQ_LOCAL_WINDOW_SIZE);
+
+unlock:
+	spin_unlock_bh(&orig_node->bat_iv.ogm_cnt_lock);
 }
 
 /**
@@ -277,6 +375,13 @@ batadv_iv_ogm_orig_get(struct batadv_priv *bat_priv, const u8 *addr)
 	if (!orig_node->bat_iv.bcast_own_sum)
 		goto free_orig_node;
 
+	size = bat_priv->num_ifaces * sizeof(u32);
+	orig_node->bat_iv.own_slides = kzalloc(size, GFP_ATOMIC);
+	if (!orig_node->bat_iv.own_slides)
+		goto free_orig_node;
+
+	orig_node->bat_iv.num_ifaces = bat_priv->num_ifaces;
+
 	hash_added = batadv_hash_add(bat_priv->orig_hash, batadv_compare_orig,
 				     batadv_choose_orig, orig_node,
 				     &orig_node->hash_entry);
@@ -367,18 +472,29 @@ batadv_iv_ogm_primary_iface_set(struct batadv_hard_iface *hard_iface)
 	batadv_ogm_packet->ttl = BATADV_TTL;
 }
 
-/* when do we schedule our own ogm to be sent */
-static unsigned long
-batadv_iv_ogm_emit_send_time(const struct batadv_priv *bat_priv)
+/* when is our own ogm sent if it is scheduled with the given interval */
+static unsigned long batadv_iv_ogm_interval_send_time(unsigned int interval)
 {
 	unsigned int msecs;
 
-	msecs = atomic_read(&bat_priv->orig_interval) - BATADV_JITTER;
+	msecs = interval - BATADV_JITTER;
 	msecs += prandom_u32() % (2 * BATADV_JITTER);
 
 	return jiffies + msecs_to_jiffies(msecs);
 }
 
+/* when do we schedule our own ogm to be sent */
+static unsigned long
+batadv_iv_ogm_emit_send_time(struct batadv_priv *bat_priv,
+			     struct batadv_hard_iface *hard_iface)
+{
+	unsigned int interval;
+
+	interval = batadv_ogm_interval_next(bat_priv, hard_iface);
+
+	return batadv_iv_ogm_interval_send_time(interval);
+}
+
 /* when do we schedule a ogm packet to be sent */
 static unsigned long batadv_iv_ogm_fwd_send_time(void)
 {
@@ -671,7 +787,7 @@ static void batadv_iv_ogm_aggregate_new(const unsigned char *packet_buff,
 
 	skb_size += ETH_HLEN;
 
-	forw_packet_aggr->skb = netdev_alloc_skb_ip_align(NULL, skb_size);
+	forw_packet_aggr->skb = batadv_skb_alloc(bat_priv, NULL, skb_size);
 	if (!forw_packet_aggr->skb)
 		goto out_free_forw_packet;
 	forw_packet_aggr->skb->priority = TC_PRIO_CONTROL;
@@ -866,37 +982,16 @@ static void batadv_iv_ogm_forward(struct batadv_orig_node *orig_node,
  * batadv_iv_ogm_slide_own_bcast_window - bitshift own OGM broadcast windows for
  * the given interface
  * @hard_iface: the interface for which the windows have to be shifted
+ *
+ * The windows kept by the originators are not touched here: they catch up with
+ * the slides they missed the next time they are accessed through
+ * batadv_iv_ogm_orig_sync_own(). This keeps the OGM schedule independent of the
+ * size of the originator table.
  */
 static void
 batadv_iv_ogm_slide_own_bcast_window(struct batadv_hard_iface *hard_iface)
 {
-	struct batadv_priv *bat_priv = netdev_priv(hard_iface->soft_iface);
-	struct batadv_hashtable *hash = bat_priv->orig_hash;
-	struct hlist_head *head;
-	struct batadv_orig_node *orig_node;
-	unsigned long *word;
-	u32 i;
-	size_t word_index;
-	u8 *w;
-	int if_num;
-
-	for (i = 0; i < hash->size; i++) {
-		head = &hash->table[i];
-
-		rcu_read_lock();
-		hlist_for_each_entry_rcu(orig_node, head, hash_entry) {
-			spin_lock_bh(&orig_node->bat_iv.ogm_cnt_lock);
-			word_index = hard_iface->if_num * BATADV_NUM_WORDS;
-			word = &orig_node->bat_iv.bcast_own[word_index];
-
-			batadv_bit_get_packet(bat_priv, word, 1, 0);
-			if_num = hard_iface->if_num;
-			w = &orig_node->bat_iv.bcast_own_sum[if_num];
-			*w = bitmap_weight(word, BATADV_TQ_LOCAL_WINDOW_SIZE);
-			spin_unlock_bh(&orig_node->bat_iv.ogm_cnt_lock);
-		}
-		rcu_read_unlock();
-	}
+	atomic_inc(&hard_iface->bat_iv.own_slides);
 }
 
 static void batadv_iv_ogm_schedule(struct batadv_hard_iface *hard_iface)
@@ -905,7 +1000,10 @@ static void batadv_iv_ogm_schedule(struct batadv_hard_iface *hard_iface)
 	unsigned char **ogm_buff = &hard_iface->bat_iv.ogm_buff;
 	struct batadv_ogm_packet *batadv_ogm_packet;
 	struct batadv_hard_iface *primary_if, *tmp_hard_iface;
+	struct batadv_hardif_array_entry *entry;
+	struct batadv_hardif_array *hardif_array;
 	int *ogm_buff_len = &hard_iface->bat_iv.ogm_buff_len;
+	unsigned int i;
 	u32 seqno;
 	u16 tvlv_len = 0;
 	unsigned long send_time;
@@ -932,7 +1030,7 @@ static void batadv_iv_ogm_schedule(struct batadv_hard_iface *hard_iface)
 
 	batadv_iv_ogm_slide_own_bcast_window(hard_iface);
 
-	send_time = batadv_iv_ogm_emit_send_time(bat_priv);
+	send_time = batadv_iv_ogm_emit_send_time(bat_priv, hard_iface);
 
 	if (hard_iface != primary_if) {
 		/* OGMs from secondary interfaces are only scheduled on their
@@ -947,9 +1045,13 @@ static void batadv_iv_ogm_schedule(struct batadv_hard_iface *hard_iface)
 	 * interfaces.
 	 */
 	rcu_read_lock();
-	list_for_each_entry_rcu(tmp_hard_iface, &batadv_hardif_list, list) {
-		if (tmp_hard_iface->soft_iface != hard_iface->soft_iface)
+	hardif_array = rcu_dereference(bat_priv->hardif_array);
+	for (i = 0; hardif_array && i < hardif_array->num; i++) {
+		entry = &hardif_array->ifaces[i];
+		tmp_hard_iface = ACCESS_ONCE(entry->hard_iface);
+		if (!tmp_hard_iface)
 			continue;
+
 		batadv_iv_ogm_queue_add(bat_priv, *ogm_buff,
 					*ogm_buff_len, hard_iface,
 					tmp_hard_iface, 1, send_time);
@@ -961,6 +1063,44 @@ out:
 		batadv_hardif_put(primary_if);
 }
 
+/**
+ * batadv_iv_ogm_reschedule - send the pending own OGMs of an interface earlier
+ * @bat_priv: the bat priv with all the soft interface information
+ * @hard_iface: the interface which scheduled the OGMs
+ * @interval: OGM interval in milliseconds (without jitter)
+ *
+ * All copies of the own OGM of @hard_iface which are due after @interval are
+ * moved forward. Packets whose work could not be cancelled are already about
+ * to be sent and are left alone.
+ */
+static void batadv_iv_ogm_reschedule(struct batadv_priv *bat_priv,
+				     struct batadv_hard_iface *hard_iface,
+				     unsigned int interval)
+{
+	struct batadv_forw_packet *forw_packet;
+	unsigned long send_time;
+
+	send_time = batadv_iv_ogm_interval_send_time(interval);
+
+	spin_lock_bh(&bat_priv->forw_bat_list_lock);
+	hlist_for_each_entry(forw_packet, &bat_priv->forw_bat_list, list) {
+		if (!forw_packet->own || forw_packet->if_incoming != hard_iface)
+			continue;
+
+		if (!time_after(forw_packet->send_time, send_time))
+			continue;
+
+		if (!cancel_delayed_work(&forw_packet->delayed_work))
+			continue;
+
+		forw_packet->send_time = send_time;
+		queue_delayed_work(batadv_event_workqueue,
+				   &forw_packet->delayed_work,
+				   send_time - jiffies);
+	}
+	spin_unlock_bh(&bat_priv->forw_bat_list_lock);
+}
+
 /**
  * batadv_iv_ogm_orig_update - use OGM to update corresponding data in an
  *  originator
@@ -988,8 +1128,6 @@ batadv_iv_ogm_orig_update(struct batadv_priv *bat_priv,
 	struct batadv_neigh_node *neigh_node = NULL;
 	struct batadv_neigh_node *tmp_neigh_node = NULL;
 	struct batadv_neigh_node *router = NULL;
-	struct batadv_orig_node *orig_node_tmp;
-	int if_num;
 	u8 sum_orig, sum_neigh;
 	u8 *neigh_addr;
 	u8 tq_avg;
@@ -1093,17 +1231,10 @@ batadv_iv_ogm_orig_update(struct batadv_priv *bat_priv,
 	 */
 	if (router_ifinfo &&
 	    neigh_ifinfo->bat_iv.tq_avg == router_ifinfo->bat_iv.tq_avg) {
-		orig_node_tmp = router->orig_node;
-		spin_lock_bh(&orig_node_tmp->bat_iv.ogm_cnt_lock);
-		if_num = router->if_incoming->if_num;
-		sum_orig = orig_node_tmp->bat_iv.bcast_own_sum[if_num];
-		spin_unlock_bh(&orig_node_tmp->bat_iv.ogm_cnt_lock);
-
-		orig_node_tmp = neigh_node->orig_node;
-		spin_lock_bh(&orig_node_tmp->bat_iv.ogm_cnt_lock);
-		if_num = neigh_node->if_incoming->if_num;
-		sum_neigh = orig_node_tmp->bat_iv.bcast_own_sum[if_num];
-		spin_unlock_bh(&orig_node_tmp->bat_iv.ogm_cnt_lock);
+		sum_orig = batadv_iv_ogm_orig_own_sum(router->orig_node,
+						      router->if_incoming);
+		sum_neigh = batadv_iv_ogm_orig_own_sum(neigh_node->orig_node,
+						       neigh_node->if_incoming);
 
 		if (sum_orig >= sum_neigh)
 			goto out;
@@ -1147,7 +1278,7 @@ static int batadv_iv_ogm_calc_tq(struct batadv_orig_node *orig_node,
 	u8 total_count;
 	u8 orig_eq_count, neigh_rq_count, neigh_rq_inv, tq_own;
 	unsigned int neigh_rq_inv_cube, neigh_rq_max_cube;
-	int tq_asym_penalty, inv_asym_penalty, if_num, ret = 0;
+	int tq_asym_penalty, inv_asym_penalty, ret = 0;
 	unsigned int combined_tq;
 	int tq_iface_penalty;
 
@@ -1186,9 +1317,10 @@ static int batadv_iv_ogm_calc_tq(struct batadv_orig_node *orig_node,
 	orig_node->last_seen = jiffies;
 
 	/* find packet count of corresponding one hop neighbor */
+	orig_eq_count = batadv_iv_ogm_orig_own_sum(orig_neigh_node,
+						   if_incoming);
+
 	spin_lock_bh(&orig_node->bat_iv.ogm_cnt_lock);
-	if_num = if_incoming->if_num;
-	orig_eq_count = orig_neigh_node->bat_iv.bcast_own_sum[if_num];
 	neigh_ifinfo = batadv_neigh_ifinfo_new(neigh_node, if_outgoing);
 	if (neigh_ifinfo) {
 		neigh_rq_count = neigh_ifinfo->bat_iv.real_packet_count;
@@ -1590,9 +1722,12 @@ static void batadv_iv_ogm_process(const struct sk_buff *skb, int ogm_offset,
 {
 	struct batadv_priv *bat_priv = netdev_priv(if_incoming->soft_iface);
 	struct batadv_orig_node *orig_neigh_node, *orig_node;
+	struct batadv_hardif_array_entry *entry;
+	struct batadv_hardif_array *hardif_array;
 	struct batadv_hard_iface *hard_iface;
 	struct batadv_ogm_packet *ogm_packet;
 	u32 if_incoming_seqno;
+	unsigned int i;
 	bool has_directlink_flag;
 	struct ethhdr *ethhdr;
 	bool is_my_oldorig = false;
@@ -1634,23 +1769,20 @@ static void batadv_iv_ogm_process(const struct sk_buff *skb, int ogm_offset,
 		   ogm_packet->version, has_directlink_flag);
 
 	rcu_read_lock();
-	list_for_each_entry_rcu(hard_iface, &batadv_hardif_list, list) {
-		if (hard_iface->if_status != BATADV_IF_ACTIVE)
+	hardif_array = rcu_dereference(bat_priv->hardif_array);
+	for (i = 0; hardif_array && i < hardif_array->num; i++) {
+		entry = &hardif_array->ifaces[i];
+		hard_iface = ACCESS_ONCE(entry->hard_iface);
+		if (!hard_iface || hard_iface->if_status != BATADV_IF_ACTIVE)
 			continue;
 
-		if (hard_iface->soft_iface != if_incoming->soft_iface)
-			continue;
-
-		if (batadv_compare_eth(ethhdr->h_source,
-				       hard_iface->net_dev->dev_addr))
+		if (batadv_compare_eth(ethhdr->h_source, entry->addr))
 			is_my_addr = true;
 
-		if (batadv_compare_eth(ogm_packet->orig,
-				       hard_iface->net_dev->dev_addr))
+		if (batadv_compare_eth(ogm_packet->orig, entry->addr))
 			is_my_orig = true;
 
-		if (batadv_compare_eth(ogm_packet->prev_sender,
-				       hard_iface->net_dev->dev_addr))
+		if (batadv_compare_eth(ogm_packet->prev_sender, entry->addr))
 			is_my_oldorig = true;
 	}
 	rcu_read_unlock();
@@ -1663,11 +1795,7 @@ static void batadv_iv_ogm_process(const struct sk_buff *skb, int ogm_offset,
 	}
 
 	if (is_my_orig) {
-		unsigned long *word;
-		int offset;
 		s32 bit_pos;
-		s16 if_num;
-		u8 *weight;
 
 		orig_neigh_node = batadv_iv_ogm_orig_get(bat_priv,
 							 ethhdr->h_source);
@@ -1681,18 +1809,10 @@ static void batadv_iv_ogm_process(const struct sk_buff *skb, int ogm_offset,
 		if (has_directlink_flag &&
 		    batadv_compare_eth(if_incoming->net_dev->dev_addr,
 				       ogm_packet->orig)) {
-			if_num = if_incoming->if_num;
-			offset = if_num * BATADV_NUM_WORDS;
-
-			spin_lock_bh(&orig_neigh_node->bat_iv.ogm_cnt_lock);
-			word = &orig_neigh_node->bat_iv.bcast_own[offset];
 			bit_pos = if_incoming_seqno - 2;
 			bit_pos -= ntohl(ogm_packet->seqno);
-			batadv_set_bit(word, bit_pos);
-			weight = &orig_neigh_node->bat_iv.bcast_own_sum[if_num];
-			*weight = bitmap_weight(word,
-						BATADV_TQ_LOCAL_WINDOW_SIZE);
-			spin_unlock_bh(&orig_neigh_node->bat_iv.ogm_cnt_lock);
+			batadv_iv_ogm_orig_own_mark(orig_neigh_node,
+						    if_incoming, bit_pos);
 		}
 
 		batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
@@ -1723,11 +1843,10 @@ static void batadv_iv_ogm_process(const struct sk_buff *skb, int ogm_offset,
 					if_incoming, BATADV_IF_DEFAULT);
 
 	rcu_read_lock();
-	list_for_each_entry_rcu(hard_iface, &batadv_hardif_list, list) {
-		if (hard_iface->if_status != BATADV_IF_ACTIVE)
-			continue;
-
-		if (hard_iface->soft_iface != bat_priv->soft_iface)
+	hardif_array = rcu_dereference(bat_priv->hardif_array);
+	for (i = 0; hardif_array && i < hardif_array->num; i++) {
+		hard_iface = ACCESS_ONCE(hardif_array->ifaces[i].hard_iface);
+		if (!hard_iface || hard_iface->if_status != BATADV_IF_ACTIVE)
 			continue;
 
 		batadv_iv_ogm_process_per_outif(skb, ogm_offset, orig_node,
@@ -1745,6 +1864,7 @@ static int batadv_iv_ogm_receive(struct sk_buff *skb,
 	struct batadv_ogm_packet *ogm_packet;
 	u8 *packet_pos;
 	int ogm_offset;
+	ktime_t start;
 	bool ret;
 
 	ret = batadv_check_management_packet(skb, if_incoming, BATADV_OGM_HLEN);
@@ -1754,8 +1874,10 @@ static int batadv_iv_ogm_receive(struct sk_buff *skb,
 	/* did we receive a B.A.T.M.A.N. IV OGM packet on an interface
 	 * that does not have B.A.T.M.A.N. IV enabled ?
 	 */
-	if (bat_priv->bat_algo_ops->bat_ogm_emit != batadv_iv_ogm_emit)
+	if (bat_priv->bat_algo_ops->bat_ogm_emit != batadv_iv_ogm_emit) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_DISABLED);
 		return NET_RX_DROP;
+	}
 
 	batadv_inc_counter(bat_priv, BATADV_CNT_MGMT_RX);
 	batadv_add_counter(bat_priv, BATADV_CNT_MGMT_RX_BYTES,
@@ -1767,7 +1889,9 @@ static int batadv_iv_ogm_receive(struct sk_buff *skb,
 	/* unpack the aggregated packets and process them one by one */
 	while (batadv_iv_ogm_aggr_packet(ogm_offset, skb_headlen(skb),
 					 ogm_packet->tvlv_len)) {
+		start = batadv_latency_start();
 		batadv_iv_ogm_process(skb, ogm_offset, if_incoming);
+		batadv_latency_stop(bat_priv, BATADV_LATENCY_OGM, start);
 
 		ogm_offset += BATADV_OGM_HLEN;
 		ogm_offset += ntohs(ogm_packet->tvlv_len);
@@ -1931,6 +2055,35 @@ static void batadv_iv_neigh_print(struct batadv_priv *bat_priv,
 		seq_puts(seq, "No batman nodes in range ...\n");
 }
 
+/**
+ * batadv_iv_ogm_neigh_dump_metric - add the TQ of a neighbor to a netlink
+ *  message
+ * @msg: netlink message to fill
+ * @neigh: the neighbor to report
+ * @if_outgoing: outgoing interface the TQ was measured for
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int
+batadv_iv_ogm_neigh_dump_metric(struct sk_buff *msg,
+				struct batadv_neigh_node *neigh,
+				struct batadv_hard_iface *if_outgoing)
+{
+	struct batadv_neigh_ifinfo *n_ifinfo;
+	int ret = 0;
+
+	n_ifinfo = batadv_neigh_ifinfo_get(neigh, if_outgoing);
+	if (!n_ifinfo)
+		return 0;
+
+	if (nla_put_u8(msg, BATADV_ATTR_TQ, n_ifinfo->bat_iv.tq_avg))
+		ret = -EMSGSIZE;
+
+	batadv_neigh_ifinfo_put(n_ifinfo);
+
+	return ret;
+}
+
 /**
  * batadv_iv_ogm_neigh_cmp - compare the metrics of two neighbors
  * @neigh1: the first neighbor object of the comparison
@@ -2022,12 +2175,13 @@ static struct batadv_algo_ops batadv_batman_iv __read_mostly = {
 	.bat_primary_iface_set = batadv_iv_ogm_primary_iface_set,
 	.bat_ogm_schedule = batadv_iv_ogm_schedule,
 	.bat_ogm_emit = batadv_iv_ogm_emit,
+	.bat_ogm_reschedule = batadv_iv_ogm_reschedule,
 	.bat_neigh_cmp = batadv_iv_ogm_neigh_cmp,
 	.bat_neigh_is_similar_or_better = batadv_iv_ogm_neigh_is_sob,
 	.bat_neigh_print = batadv_iv_neigh_print,
+	.bat_neigh_dump_metric = batadv_iv_ogm_neigh_dump_metric,
 	.bat_orig_print = batadv_iv_ogm_orig_print,
 	.bat_orig_free = batadv_iv_ogm_orig_free,
-	.bat_orig_add_if = batadv_iv_ogm_orig_add_if,
 	.bat_orig_del_if = batadv_iv_ogm_orig_del_if,
 };
 
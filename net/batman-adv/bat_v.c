@@ -27,8 +27,11 @@
 #include <linux/rculist.h>
 #include <linux/rcupdate.h>
 #include <linux/seq_file.h>
+#include <linux/skbuff.h>
 #include <linux/types.h>
 #include <linux/workqueue.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "bat_v_elp.h"
 #include "bat_v_ogm.h"
@@ -58,6 +61,7 @@ static int batadv_v_iface_enable(struct batadv_hard_iface *hard_iface)
 
 static void batadv_v_iface_disable(struct batadv_hard_iface *hard_iface)
 {
+	batadv_v_ogm_iface_disable(hard_iface);
 	batadv_v_elp_iface_disable(hard_iface);
 }
 
@@ -171,6 +175,35 @@ static void batadv_v_neigh_print(struct batadv_priv *bat_priv,
 		seq_puts(seq, "No batman nodes in range ...\n");
 }
 
+/**
+ * batadv_v_neigh_dump_metric - add the throughput of a neighbor to a netlink
+ *  message
+ * @msg: netlink message to fill
+ * @neigh: the neighbor to report
+ * @if_outgoing: outgoing interface the throughput was estimated for
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int batadv_v_neigh_dump_metric(struct sk_buff *msg,
+				      struct batadv_neigh_node *neigh,
+				      struct batadv_hard_iface *if_outgoing)
+{
+	struct batadv_neigh_ifinfo *n_ifinfo;
+	int ret = 0;
+
+	n_ifinfo = batadv_neigh_ifinfo_get(neigh, if_outgoing);
+	if (!n_ifinfo)
+		return 0;
+
+	if (nla_put_u32(msg, BATADV_ATTR_THROUGHPUT,
+			n_ifinfo->bat_v.throughput))
+		ret = -EMSGSIZE;
+
+	batadv_neigh_ifinfo_put(n_ifinfo);
+
+	return ret;
+}
+
 /**
  * batadv_v_orig_print - print the originator table
  * @bat_priv: the bat priv with all the soft interface information
@@ -281,10 +314,12 @@ static struct batadv_algo_ops batadv_batman_v __read_mostly = {
 	.bat_hardif_neigh_init = batadv_v_hardif_neigh_init,
 	.bat_ogm_emit = batadv_v_ogm_emit,
 	.bat_ogm_schedule = batadv_v_ogm_schedule,
+	.bat_ogm_reschedule = batadv_v_ogm_reschedule,
 	.bat_orig_print = batadv_v_orig_print,
 	.bat_neigh_cmp = batadv_v_neigh_cmp,
 	.bat_neigh_is_similar_or_better = batadv_v_neigh_is_sob,
 	.bat_neigh_print = batadv_v_neigh_print,
+	.bat_neigh_dump_metric = batadv_v_neigh_dump_metric,
 };
 
 /**
@@ -164,6 +164,36 @@ void batadv_v_elp_throughput_metric_update(struct work_struct *work)
 	batadv_hardif_neigh_put(neigh);
 }
 
+/**
+ * batadv_v_elp_skb_copy - create a new ELP packet from the interface template
+ * @hard_iface: the interface holding the ELP template
+ * @len: the length of the resulting ELP packet (without ethernet header)
+ *
+ * The template is copied into a newly allocated buffer. If len is larger than
+ * the template, the rest of the packet is zero padded.
+ *
+ * Return: the new ELP packet or NULL in case of allocation failure
+ */
+static struct sk_buff *
+batadv_v_elp_skb_copy(struct batadv_hard_iface *hard_iface, unsigned int len)
+{
+	struct batadv_priv *bat_priv = netdev_priv(hard_iface->soft_iface);
+	struct sk_buff *elp_skb = hard_iface->bat_v.elp_skb;
+	struct sk_buff *skb;
+	unsigned char *skb_buff;
+
+	skb = batadv_skb_alloc(bat_priv, NULL, ETH_HLEN + len);
+	if (!skb)
+		return NULL;
+
+	skb_reserve(skb, ETH_HLEN);
+	skb_buff = skb_put(skb, len);
+	memcpy(skb_buff, elp_skb->data, elp_skb->len);
+	memset(skb_buff + elp_skb->len, 0, len - elp_skb->len);
+
+	return skb;
+}
+
 /**
  * batadv_v_elp_wifi_neigh_probe - send link probing packets to a neighbour
  * @neigh: the neighbour to probe
@@ -183,7 +213,6 @@ batadv_v_elp_wifi_neigh_probe(struct batadv_hardif_neigh_node *neigh)
 	unsigned long last_tx_diff;
 	struct sk_buff *skb;
 	int probe_len, i;
-	int elp_skb_len;
 
 	/* this probing routine is for Wifi neighbours only */
 	if (!batadv_is_wifi_netdev(hard_iface->net_dev))
@@ -204,19 +233,13 @@ batadv_v_elp_wifi_neigh_probe(struct batadv_hardif_neigh_node *neigh)
 			  BATADV_ELP_MIN_PROBE_SIZE);
 
 	for (i = 0; i < BATADV_ELP_PROBES_PER_NODE; i++) {
-		elp_skb_len = hard_iface->bat_v.elp_skb->len;
-		skb = skb_copy_expand(hard_iface->bat_v.elp_skb, 0,
-				      probe_len - elp_skb_len,
-				      GFP_ATOMIC);
+		/* the packet has to be exactly of probe_len size to make the
+		 * link throughput estimation effective
+		 */
+		skb = batadv_v_elp_skb_copy(hard_iface, probe_len);
 		if (!skb)
 			return false;
 
-		/* Tell the skb to get as big as the allocated space (we want
-		 * the packet to be exactly of that size to make the link
-		 * throughput estimation effective.
-		 */
-		skb_put(skb, probe_len - hard_iface->bat_v.elp_skb->len);
-
 		batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
 			   "Sending unicast (probe) ELP packet on interface %s to %pM\n",
 			   hard_iface->net_dev->name, neigh->addr);
@@ -259,7 +282,8 @@ static void batadv_v_elp_periodic_work(struct work_struct *work)
 	if (hard_iface->if_status != BATADV_IF_ACTIVE)
 		goto restart_timer;
 
-	skb = skb_copy(hard_iface->bat_v.elp_skb, GFP_ATOMIC);
+	skb = batadv_v_elp_skb_copy(hard_iface,
+				    hard_iface->bat_v.elp_skb->len);
 	if (!skb)
 		goto restart_timer;
 
@@ -484,14 +508,18 @@ int batadv_v_elp_packet_recv(struct sk_buff *skb,
 	if (!ret)
 		return NET_RX_DROP;
 
-	if (batadv_is_my_mac(bat_priv, ethhdr->h_source))
+	if (batadv_is_my_mac(bat_priv, ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_OWN);
 		return NET_RX_DROP;
+	}
 
 	/* did we receive a B.A.T.M.A.N. V ELP packet on an interface
 	 * that does not have B.A.T.M.A.N. V ELP enabled ?
 	 */
-	if (strcmp(bat_priv->bat_algo_ops->name, "BATMAN_V") != 0)
+	if (strcmp(bat_priv->bat_algo_ops->name, "BATMAN_V") != 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_DISABLED);
 		return NET_RX_DROP;
+	}
 
 	elp_packet = (struct batadv_elp_packet *)skb->data;
 
@@ -26,20 +26,24 @@
 #include <linux/if_ether.h>
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
+#include <linux/ktime.h>
 #include <linux/list.h>
+#include <linux/lockdep.h>
 #include <linux/netdevice.h>
 #include <linux/random.h>
-#include <linux/rculist.h>
 #include <linux/rcupdate.h>
 #include <linux/skbuff.h>
 #include <linux/slab.h>
+#include <linux/spinlock.h>
 #include <linux/stddef.h>
 #include <linux/string.h>
+#include <linux/timer.h>
 #include <linux/types.h>
 #include <linux/workqueue.h>
 
 #include "hard-interface.h"
 #include "hash.h"
+#include "latency.h"
 #include "originator.h"
 #include "packet.h"
 #include "routing.h"
@@ -85,22 +89,63 @@ struct batadv_orig_node *batadv_v_ogm_orig_get(struct batadv_priv *bat_priv,
 }
 
 /**
- * batadv_v_ogm_start_timer - restart the OGM sending timer
- * @bat_priv: the bat priv with all the soft interface information
+ * batadv_v_ogm_delay - get the jittered delay until the next own OGM
+ * @interval: OGM interval in milliseconds (without jitter)
+ *
+ * Return: the delay in jiffies
  */
-static void batadv_v_ogm_start_timer(struct batadv_priv *bat_priv)
+static unsigned long batadv_v_ogm_delay(unsigned int interval)
 {
 	unsigned long msecs;
+
+	msecs = interval - BATADV_JITTER;
+	msecs += prandom_u32() % (2 * BATADV_JITTER);
+
+	return msecs_to_jiffies(msecs);
+}
+
+/**
+ * batadv_v_ogm_start_timer - restart the OGM sending timer of an interface
+ * @hard_iface: the interface for which the timer has to be reset
+ * @interval: OGM interval in milliseconds (without jitter)
+ */
+static void batadv_v_ogm_start_timer(struct batadv_hard_iface *hard_iface,
+				     unsigned int interval)
+{
 	/* this function may be invoked in different contexts (ogm rescheduling
 	 * or hard_iface activation), but the work timer should not be reset
 	 */
-	if (delayed_work_pending(&bat_priv->bat_v.ogm_wq))
+	if (delayed_work_pending(&hard_iface->bat_v.ogm_wq))
 		return;
 
-	msecs = atomic_read(&bat_priv->orig_interval) - BATADV_JITTER;
-	msecs += prandom_u32() % (2 * BATADV_JITTER);
-	queue_delayed_work(batadv_event_workqueue, &bat_priv->bat_v.ogm_wq,
-			   msecs_to_jiffies(msecs));
+	queue_delayed_work(batadv_event_workqueue, &hard_iface->bat_v.ogm_wq,
+			   batadv_v_ogm_delay(interval));
+}
+
+/**
+ * batadv_v_ogm_reschedule - send the pending own OGM of an interface earlier
+ * @bat_priv: the bat priv with all the soft interface information
+ * @hard_iface: the interface to reschedule the OGM for
+ * @interval: OGM interval in milliseconds (without jitter)
+ *
+ * Called by batadv_ogm_interval_churn() under rcu_read_lock, which
+ * batadv_v_ogm_iface_disable() waits for before the work is cancelled.
+ */
+void batadv_v_ogm_reschedule(struct batadv_priv *bat_priv,
+			     struct batadv_hard_iface *hard_iface,
+			     unsigned int interval)
+{
+	struct delayed_work *ogm_wq = &hard_iface->bat_v.ogm_wq;
+	unsigned long delay = batadv_v_ogm_delay(interval);
+
+	/* a running worker reschedules itself with the new interval */
+	if (!delayed_work_pending(ogm_wq))
+		return;
+
+	if (time_before_eq(ogm_wq->timer.expires, jiffies + delay))
+		return;
+
+	mod_delayed_work(batadv_event_workqueue, ogm_wq, delay);
 }
 
 /**
@@ -113,8 +158,10 @@ static void batadv_v_ogm_send_to_if(struct sk_buff *skb,
 {
 	struct batadv_priv *bat_priv = netdev_priv(hard_iface->soft_iface);
 
-	if (hard_iface->if_status != BATADV_IF_ACTIVE)
+	if (hard_iface->if_status != BATADV_IF_ACTIVE) {
+		kfree_skb(skb);
 		return;
+	}
 
 	batadv_inc_counter(bat_priv, BATADV_CNT_MGMT_TX);
 	batadv_add_counter(bat_priv, BATADV_CNT_MGMT_TX_BYTES,
@@ -124,25 +171,36 @@ static void batadv_v_ogm_send_to_if(struct sk_buff *skb,
 }
 
 /**
- * batadv_v_ogm_send - periodic worker broadcasting the own OGM
- * @work: work queue item
+ * batadv_v_ogm_get - get a copy of the current own OGM
+ * @bat_priv: the bat priv with all the soft interface information
+ * @hard_iface: the interface the OGM is sent on
+ *
+ * The own OGM, including a new sequence number and the TVLV data, is built at
+ * most once per ogm_interval_min of @hard_iface and then shared by all
+ * interfaces which are scheduled before it expires. The expiry time leaves
+ * room for the jitter so that every interface gets a new OGM in each of its
+ * intervals.
+ *
+ * Return: a clone of the current own OGM or NULL in case of allocation
+ * failure.
  */
-static void batadv_v_ogm_send(struct work_struct *work)
+static struct sk_buff *batadv_v_ogm_get(struct batadv_priv *bat_priv,
+					struct batadv_hard_iface *hard_iface)
 {
-	struct batadv_hard_iface *hard_iface;
-	struct batadv_priv_bat_v *bat_v;
-	struct batadv_priv *bat_priv;
 	struct batadv_ogm2_packet *ogm_packet;
-	struct sk_buff *skb, *skb_tmp;
 	unsigned char *ogm_buff, *pkt_buff;
+	unsigned int max_age;
+	struct sk_buff *skb;
 	int ogm_buff_len;
-	u16 tvlv_len = 0;
+	u16 tvlv_len;
 
-	bat_v = container_of(work, struct batadv_priv_bat_v, ogm_wq.work);
-	bat_priv = container_of(bat_v, struct batadv_priv, bat_v);
+	lockdep_assert_held(&bat_priv->bat_v.ogm_buff_lock);
 
-	if (atomic_read(&bat_priv->mesh_state) == BATADV_MESH_DEACTIVATING)
-		goto out;
+	max_age = batadv_ogm_interval_min(bat_priv, hard_iface);
+	max_age -= 2 * BATADV_JITTER;
+	skb = bat_priv->bat_v.ogm_skb;
+	if (skb && !batadv_has_timed_out(bat_priv->bat_v.ogm_skb_time, max_age))
+		return skb_clone(skb, GFP_ATOMIC);
 
 	ogm_buff = bat_priv->bat_v.ogm_buff;
 	ogm_buff_len = bat_priv->bat_v.ogm_buff_len;
@@ -157,9 +215,9 @@ static void batadv_v_ogm_send(struct work_struct *work)
 	bat_priv->bat_v.ogm_buff = ogm_buff;
 	bat_priv->bat_v.ogm_buff_len = ogm_buff_len;
 
-	skb = netdev_alloc_skb_ip_align(NULL, ETH_HLEN + ogm_buff_len);
+	skb = batadv_skb_alloc(bat_priv, NULL, ETH_HLEN + ogm_buff_len);
 	if (!skb)
-		goto reschedule;
+		return NULL;
 
 	skb_reserve(skb, ETH_HLEN);
 	pkt_buff = skb_put(skb, ogm_buff_len);
@@ -170,32 +228,63 @@ static void batadv_v_ogm_send(struct work_struct *work)
 	atomic_inc(&bat_priv->bat_v.ogm_seqno);
 	ogm_packet->tvlv_len = htons(tvlv_len);
 
-	/* broadcast on every interface */
-	rcu_read_lock();
-	list_for_each_entry_rcu(hard_iface, &batadv_hardif_list, list) {
-		if (hard_iface->soft_iface != bat_priv->soft_iface)
-			continue;
+	/* the previous OGM was only cloned for transmission */
+	consume_skb(bat_priv->bat_v.ogm_skb);
+	bat_priv->bat_v.ogm_skb = skb;
+	bat_priv->bat_v.ogm_skb_time = jiffies;
 
-		batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
-			   "Sending own OGM2 packet (originator %pM, seqno %u, throughput %u, TTL %d) on interface %s [%pM]\n",
-			   ogm_packet->orig, ntohl(ogm_packet->seqno),
-			   ntohl(ogm_packet->throughput), ogm_packet->ttl,
-			   hard_iface->net_dev->name,
-			   hard_iface->net_dev->dev_addr);
-
-		/* this skb gets consumed by batadv_v_ogm_send_to_if() */
-		skb_tmp = skb_clone(skb, GFP_ATOMIC);
-		if (!skb_tmp)
-			break;
-
-		batadv_v_ogm_send_to_if(skb_tmp, hard_iface);
-	}
-	rcu_read_unlock();
+	return skb_clone(skb, GFP_ATOMIC);
+}
 
-	consume_skb(skb);
+/**
+ * batadv_v_ogm_send - periodic worker broadcasting the own OGM on an interface
+ * @work: work queue item
+ */
+static void batadv_v_ogm_send(struct work_struct *work)
+{
+	struct batadv_hard_iface_bat_v *bat_v;
+	struct batadv_hard_iface *hard_iface;
+	struct batadv_ogm2_packet *ogm_packet;
+	struct batadv_priv *bat_priv;
+	unsigned int interval;
+	struct sk_buff *skb;
+
+	bat_v = container_of(work, struct batadv_hard_iface_bat_v, ogm_wq.work);
+	hard_iface = container_of(bat_v, struct batadv_hard_iface, bat_v);
+	bat_priv = netdev_priv(hard_iface->soft_iface);
+
+	if (atomic_read(&bat_priv->mesh_state) == BATADV_MESH_DEACTIVATING)
+		goto out;
+
+	/* we are in the process of shutting this interface down */
+	if ((hard_iface->if_status == BATADV_IF_NOT_IN_USE) ||
+	    (hard_iface->if_status == BATADV_IF_TO_BE_REMOVED))
+		goto out;
+
+	/* the interface was enabled but may not be ready yet */
+	if (hard_iface->if_status != BATADV_IF_ACTIVE)
+		goto reschedule;
+
+	spin_lock_bh(&bat_priv->bat_v.ogm_buff_lock);
+	skb = batadv_v_ogm_get(bat_priv, hard_iface);
+	spin_unlock_bh(&bat_priv->bat_v.ogm_buff_lock);
+
+	if (!skb)
+		goto reschedule;
+
+	ogm_packet = (struct batadv_ogm2_packet *)skb->data;
+	batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
+		   "Sending own OGM2 packet (originator %pM, seqno %u, throughput %u, TTL %d) on interface %s [%pM]\n",
+		   ogm_packet->orig, ntohl(ogm_packet->seqno),
+		   ntohl(ogm_packet->throughput), ogm_packet->ttl,
+		   hard_iface->net_dev->name, hard_iface->net_dev->dev_addr);
+
+	/* this skb gets consumed by batadv_v_ogm_send_to_if() */
+	batadv_v_ogm_send_to_if(skb, hard_iface);
 
 reschedule:
-	batadv_v_ogm_start_timer(bat_priv);
+	interval = batadv_ogm_interval_next(bat_priv, hard_iface);
+	batadv_v_ogm_start_timer(hard_iface, interval);
 out:
 	return;
 }
@@ -210,13 +299,26 @@ out:
  */
 int batadv_v_ogm_iface_enable(struct batadv_hard_iface *hard_iface)
 {
-	struct batadv_priv *bat_priv = netdev_priv(hard_iface->soft_iface);
-
-	batadv_v_ogm_start_timer(bat_priv);
+	INIT_DELAYED_WORK(&hard_iface->bat_v.ogm_wq, batadv_v_ogm_send);
+	batadv_v_ogm_start_timer(hard_iface,
+				 atomic_read(&hard_iface->ogm_interval));
 
 	return 0;
 }
 
+/**
+ * batadv_v_ogm_iface_disable - stop the OGM sending routine of an interface
+ * @hard_iface: the interface to stop
+ */
+void batadv_v_ogm_iface_disable(struct batadv_hard_iface *hard_iface)
+{
+	/* the interface is not active anymore, wait for
+	 * batadv_v_ogm_reschedule() calls which may still have seen it active
+	 */
+	synchronize_rcu();
+	cancel_delayed_work_sync(&hard_iface->bat_v.ogm_wq);
+}
+
 /**
  * batadv_v_ogm_primary_iface_set - set a new primary interface
  * @primary_iface: the new primary interface
@@ -226,11 +328,19 @@ void batadv_v_ogm_primary_iface_set(struct batadv_hard_iface *primary_iface)
 	struct batadv_priv *bat_priv = netdev_priv(primary_iface->soft_iface);
 	struct batadv_ogm2_packet *ogm_packet;
 
+	spin_lock_bh(&bat_priv->bat_v.ogm_buff_lock);
 	if (!bat_priv->bat_v.ogm_buff)
-		return;
+		goto unlock;
 
 	ogm_packet = (struct batadv_ogm2_packet *)bat_priv->bat_v.ogm_buff;
 	ether_addr_copy(ogm_packet->orig, primary_iface->net_dev->dev_addr);
+
+	/* the shared OGM still carries the old originator address */
+	consume_skb(bat_priv->bat_v.ogm_skb);
+	bat_priv->bat_v.ogm_skb = NULL;
+
+unlock:
+	spin_unlock_bh(&bat_priv->bat_v.ogm_buff_lock);
 }
 
 /**
@@ -341,8 +451,8 @@ static void batadv_v_ogm_forward(struct batadv_priv *bat_priv,
 	tvlv_len = ntohs(ogm_received->tvlv_len);
 
 	packet_len = BATADV_OGM2_HLEN + tvlv_len;
-	skb = netdev_alloc_skb_ip_align(if_outgoing->net_dev,
-					ETH_HLEN + packet_len);
+	skb = batadv_skb_alloc(bat_priv, if_outgoing->net_dev,
+				ETH_HLEN + packet_len);
 	if (!skb)
 		goto out;
 
@@ -639,9 +749,11 @@ static void batadv_v_ogm_process(const struct sk_buff *skb, int ogm_offset,
 	struct batadv_orig_node *orig_node = NULL;
 	struct batadv_hardif_neigh_node *hardif_neigh = NULL;
 	struct batadv_neigh_node *neigh_node = NULL;
+	struct batadv_hardif_array *hardif_array;
 	struct batadv_hard_iface *hard_iface;
 	struct batadv_ogm2_packet *ogm_packet;
 	u32 ogm_throughput, link_throughput, path_throughput;
+	unsigned int i;
 
 	ethhdr = eth_hdr(skb);
 	ogm_packet = (struct batadv_ogm2_packet *)(skb->data + ogm_offset);
@@ -697,11 +809,10 @@ static void batadv_v_ogm_process(const struct sk_buff *skb, int ogm_offset,
 				       BATADV_IF_DEFAULT);
 
 	rcu_read_lock();
-	list_for_each_entry_rcu(hard_iface, &batadv_hardif_list, list) {
-		if (hard_iface->if_status != BATADV_IF_ACTIVE)
-			continue;
-
-		if (hard_iface->soft_iface != bat_priv->soft_iface)
+	hardif_array = rcu_dereference(bat_priv->hardif_array);
+	for (i = 0; hardif_array && i < hardif_array->num; i++) {
+		hard_iface = ACCESS_ONCE(hardif_array->ifaces[i].hard_iface);
+		if (!hard_iface || hard_iface->if_status != BATADV_IF_ACTIVE)
 			continue;
 
 		batadv_v_ogm_process_per_outif(bat_priv, ethhdr, ogm_packet,
@@ -734,24 +845,31 @@ int batadv_v_ogm_packet_recv(struct sk_buff *skb,
 	struct ethhdr *ethhdr = eth_hdr(skb);
 	int ogm_offset;
 	u8 *packet_pos;
+	ktime_t start;
 	int ret = NET_RX_DROP;
 
 	/* did we receive a OGM2 packet on an interface that does not have
 	 * B.A.T.M.A.N. V enabled ?
 	 */
-	if (strcmp(bat_priv->bat_algo_ops->name, "BATMAN_V") != 0)
+	if (strcmp(bat_priv->bat_algo_ops->name, "BATMAN_V") != 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_DISABLED);
 		return NET_RX_DROP;
+	}
 
 	if (!batadv_check_management_packet(skb, if_incoming, BATADV_OGM2_HLEN))
 		return NET_RX_DROP;
 
-	if (batadv_is_my_mac(bat_priv, ethhdr->h_source))
+	if (batadv_is_my_mac(bat_priv, ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_OWN);
 		return NET_RX_DROP;
+	}
 
 	ogm_packet = (struct batadv_ogm2_packet *)skb->data;
 
-	if (batadv_is_my_mac(bat_priv, ogm_packet->orig))
+	if (batadv_is_my_mac(bat_priv, ogm_packet->orig)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_OWN);
 		return NET_RX_DROP;
+	}
 
 	batadv_inc_counter(bat_priv, BATADV_CNT_MGMT_RX);
 	batadv_add_counter(bat_priv, BATADV_CNT_MGMT_RX_BYTES,
@@ -762,7 +880,9 @@ int batadv_v_ogm_packet_recv(struct sk_buff *skb,
 
 	while (batadv_v_ogm_aggr_packet(ogm_offset, skb_headlen(skb),
 					ogm_packet->tvlv_len)) {
+		start = batadv_latency_start();
 		batadv_v_ogm_process(skb, ogm_offset, if_incoming);
+		batadv_latency_stop(bat_priv, BATADV_LATENCY_OGM, start);
 
 		ogm_offset += BATADV_OGM2_HLEN;
 		ogm_offset += ntohs(ogm_packet->tvlv_len);
@@ -805,7 +925,7 @@ int batadv_v_ogm_init(struct batadv_priv *bat_priv)
 	/* randomize initial seqno to avoid collision */
 	get_random_bytes(&random_seqno, sizeof(random_seqno));
 	atomic_set(&bat_priv->bat_v.ogm_seqno, random_seqno);
-	INIT_DELAYED_WORK(&bat_priv->bat_v.ogm_wq, batadv_v_ogm_send);
+	spin_lock_init(&bat_priv->bat_v.ogm_buff_lock);
 
 	return 0;
 }
@@ -816,7 +936,8 @@ int batadv_v_ogm_init(struct batadv_priv *bat_priv)
  */
 void batadv_v_ogm_free(struct batadv_priv *bat_priv)
 {
-	cancel_delayed_work_sync(&bat_priv->bat_v.ogm_wq);
+	consume_skb(bat_priv->bat_v.ogm_skb);
+	bat_priv->bat_v.ogm_skb = NULL;
 
 	kfree(bat_priv->bat_v.ogm_buff);
 	bat_priv->bat_v.ogm_buff = NULL;
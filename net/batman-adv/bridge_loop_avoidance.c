@@ -35,6 +35,7 @@
 #include <linux/list.h>
 #include <linux/lockdep.h>
 #include <linux/netdevice.h>
+#include <linux/netlink.h>
 #include <linux/rculist.h>
 #include <linux/rcupdate.h>
 #include <linux/seq_file.h>
@@ -45,9 +46,13 @@
 #include <linux/string.h>
 #include <linux/workqueue.h>
 #include <net/arp.h>
+#include <net/genetlink.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "hard-interface.h"
 #include "hash.h"
+#include "netlink.h"
 #include "originator.h"
 #include "packet.h"
 #include "translation-table.h"
@@ -86,11 +91,12 @@ static inline u32 batadv_choose_claim(const void *data, u32 size)
  */
 static inline u32 batadv_choose_backbone_gw(const void *data, u32 size)
 {
-	const struct batadv_bla_claim *claim = (struct batadv_bla_claim *)data;
+	const struct batadv_bla_backbone_gw *gw;
 	u32 hash = 0;
 
-	hash = jhash(&claim->addr, sizeof(claim->addr), hash);
-	hash = jhash(&claim->vid, sizeof(claim->vid), hash);
+	gw = (struct batadv_bla_backbone_gw *)data;
+	hash = jhash(&gw->orig, sizeof(gw->orig), hash);
+	hash = jhash(&gw->vid, sizeof(gw->vid), hash);
 
 	return hash % size;
 }
@@ -194,20 +200,22 @@ static void batadv_claim_put(struct batadv_bla_claim *claim)
 }
 
 /**
- * batadv_claim_hash_find - looks for a claim in the claim hash
+ * batadv_claim_hash_find_rcu - looks for a claim in the claim hash
  * @bat_priv: the bat priv with all the soft interface information
  * @data: search data (may be local/static data)
  *
+ * No reference is taken for the returned claim. It may only be accessed until
+ * the rcu_read_lock() of the caller is released.
+ *
  * Return: claim if found or NULL otherwise.
  */
-static struct batadv_bla_claim
-*batadv_claim_hash_find(struct batadv_priv *bat_priv,
-			struct batadv_bla_claim *data)
+static struct batadv_bla_claim *
+batadv_claim_hash_find_rcu(struct batadv_priv *bat_priv,
+			   struct batadv_bla_claim *data)
 {
 	struct batadv_hashtable *hash = bat_priv->bla.claim_hash;
-	struct hlist_head *head;
 	struct batadv_bla_claim *claim;
-	struct batadv_bla_claim *claim_tmp = NULL;
+	struct hlist_head *head;
 	int index;
 
 	if (!hash)
@@ -216,38 +224,54 @@ static struct batadv_bla_claim
 	index = batadv_choose_claim(data, hash->size);
 	head = &hash->table[index];
 
-	rcu_read_lock();
 	hlist_for_each_entry_rcu(claim, head, hash_entry) {
-		if (!batadv_compare_claim(&claim->hash_entry, data))
-			continue;
+		if (batadv_compare_claim(&claim->hash_entry, data))
+			return claim;
+	}
 
-		if (!kref_get_unless_zero(&claim->refcount))
-			continue;
+	return NULL;
+}
 
-		claim_tmp = claim;
-		break;
-	}
+/**
+ * batadv_claim_hash_find - looks for a claim in the claim hash
+ * @bat_priv: the bat priv with all the soft interface information
+ * @data: search data (may be local/static data)
+ *
+ * Return: claim if found or NULL otherwise.
+ */
+static struct batadv_bla_claim
+*batadv_claim_hash_find(struct batadv_priv *bat_priv,
+			struct batadv_bla_claim *data)
+{
+	struct batadv_bla_claim *claim;
+
+	rcu_read_lock();
+	claim = batadv_claim_hash_find_rcu(bat_priv, data);
+	if (claim && !kref_get_unless_zero(&claim->refcount))
+		claim = NULL;
 	rcu_read_unlock();
 
-	return claim_tmp;
+	return claim;
 }
 
 /**
- * batadv_backbone_hash_find - looks for a backbone gateway in the hash
+ * batadv_backbone_hash_find_rcu - looks for a backbone gateway in the hash
  * @bat_priv: the bat priv with all the soft interface information
  * @addr: the address of the originator
  * @vid: the VLAN ID
  *
+ * No reference is taken for the returned backbone gateway. It may only be
+ * accessed until the rcu_read_lock() of the caller is released.
+ *
  * Return: backbone gateway if found or NULL otherwise
  */
 static struct batadv_bla_backbone_gw *
-batadv_backbone_hash_find(struct batadv_priv *bat_priv, u8 *addr,
-			  unsigned short vid)
+batadv_backbone_hash_find_rcu(struct batadv_priv *bat_priv, u8 *addr,
+			      unsigned short vid)
 {
 	struct batadv_hashtable *hash = bat_priv->bla.backbone_hash;
-	struct hlist_head *head;
 	struct batadv_bla_backbone_gw search_entry, *backbone_gw;
-	struct batadv_bla_backbone_gw *backbone_gw_tmp = NULL;
+	struct hlist_head *head;
 	int index;
 
 	if (!hash)
@@ -259,21 +283,57 @@ batadv_backbone_hash_find(struct batadv_priv *bat_priv, u8 *addr,
 	index = batadv_choose_backbone_gw(&search_entry, hash->size);
 	head = &hash->table[index];
 
-	rcu_read_lock();
 	hlist_for_each_entry_rcu(backbone_gw, head, hash_entry) {
-		if (!batadv_compare_backbone_gw(&backbone_gw->hash_entry,
-						&search_entry))
-			continue;
+		if (batadv_compare_backbone_gw(&backbone_gw->hash_entry,
+					       &search_entry))
+			return backbone_gw;
+	}
 
-		if (!kref_get_unless_zero(&backbone_gw->refcount))
-			continue;
+	return NULL;
+}
 
-		backbone_gw_tmp = backbone_gw;
-		break;
-	}
+/**
+ * batadv_backbone_hash_find - looks for a backbone gateway in the hash
+ * @bat_priv: the bat priv with all the soft interface information
+ * @addr: the address of the originator
+ * @vid: the VLAN ID
+ *
+ * Return: backbone gateway if found or NULL otherwise
+ */
+static struct batadv_bla_backbone_gw *
+batadv_backbone_hash_find(struct batadv_priv *bat_priv, u8 *addr,
+			  unsigned short vid)
+{
+	struct batadv_bla_backbone_gw *backbone_gw;
+
+	rcu_read_lock();
+	backbone_gw = batadv_backbone_hash_find_rcu(bat_priv, addr, vid);
+	if (backbone_gw && !kref_get_unless_zero(&backbone_gw->refcount))
+		backbone_gw = NULL;
 	rcu_read_unlock();
 
-	return backbone_gw_tmp;
+	return backbone_gw;
+}
+
+/**
+ * batadv_bla_lasttime_touch - refresh a liveness timestamp
+ * @lasttime: the timestamp of a claim or backbone gateway
+ *
+ * The timestamps are only compared against timeouts of several seconds. They
+ * are therefore only written when they are older than
+ * BATADV_BLA_LASTTIME_INTERVAL. This keeps the cacheline shared between all
+ * CPUs processing frames of the same client or backbone gateway.
+ */
+static void batadv_bla_lasttime_touch(unsigned long *lasttime)
+{
+	unsigned long now = jiffies;
+	unsigned long interval;
+
+	interval = msecs_to_jiffies(BATADV_BLA_LASTTIME_INTERVAL);
+	if (time_before(now, ACCESS_ONCE(*lasttime) + interval))
+		return;
+
+	ACCESS_ONCE(*lasttime) = now;
 }
 
 /**
@@ -515,10 +575,21 @@ batadv_bla_update_own_backbone_gw(struct batadv_priv *bat_priv,
 				  unsigned short vid)
 {
 	struct batadv_bla_backbone_gw *backbone_gw;
+	u8 *primary_addr = primary_if->net_dev->dev_addr;
 
-	backbone_gw = batadv_bla_get_backbone_gw(bat_priv,
-						 primary_if->net_dev->dev_addr,
-						 vid, true);
+	/* fast path: the own backbone gw of this vlan usually exists already */
+	rcu_read_lock();
+	backbone_gw = batadv_backbone_hash_find_rcu(bat_priv, primary_addr,
+						    vid);
+	if (likely(backbone_gw)) {
+		batadv_bla_lasttime_touch(&backbone_gw->lasttime);
+		rcu_read_unlock();
+		return;
+	}
+	rcu_read_unlock();
+
+	backbone_gw = batadv_bla_get_backbone_gw(bat_priv, primary_addr, vid,
+						 true);
 	if (unlikely(!backbone_gw))
 		return;
 
@@ -1512,32 +1583,17 @@ out:
 bool batadv_bla_is_backbone_gw_orig(struct batadv_priv *bat_priv, u8 *orig,
 				    unsigned short vid)
 {
-	struct batadv_hashtable *hash = bat_priv->bla.backbone_hash;
-	struct hlist_head *head;
 	struct batadv_bla_backbone_gw *backbone_gw;
-	int i;
 
 	if (!atomic_read(&bat_priv->bridge_loop_avoidance))
 		return false;
 
-	if (!hash)
-		return false;
-
-	for (i = 0; i < hash->size; i++) {
-		head = &hash->table[i];
-
-		rcu_read_lock();
-		hlist_for_each_entry_rcu(backbone_gw, head, hash_entry) {
-			if (batadv_compare_eth(backbone_gw->orig, orig) &&
-			    backbone_gw->vid == vid) {
-				rcu_read_unlock();
-				return true;
-			}
-		}
-		rcu_read_unlock();
-	}
+	/* the backbone hash is indexed by originator and vid */
+	rcu_read_lock();
+	backbone_gw = batadv_backbone_hash_find_rcu(bat_priv, orig, vid);
+	rcu_read_unlock();
 
-	return false;
+	return !!backbone_gw;
 }
 
 /**
@@ -1565,13 +1621,12 @@ int batadv_bla_is_backbone_gw(struct sk_buff *skb,
 	vid = batadv_get_vid(skb, hdr_size);
 
 	/* see if this originator is a backbone gw for this VLAN */
-	backbone_gw = batadv_backbone_hash_find(orig_node->bat_priv,
-						orig_node->orig, vid);
-	if (!backbone_gw)
-		return 0;
+	rcu_read_lock();
+	backbone_gw = batadv_backbone_hash_find_rcu(orig_node->bat_priv,
+						    orig_node->orig, vid);
+	rcu_read_unlock();
 
-	batadv_backbone_gw_put(backbone_gw);
-	return 1;
+	return !!backbone_gw;
 }
 
 /**
@@ -1620,14 +1675,21 @@ void batadv_bla_free(struct batadv_priv *bat_priv)
 int batadv_bla_rx(struct batadv_priv *bat_priv, struct sk_buff *skb,
 		  unsigned short vid, bool is_bcast)
 {
-	struct ethhdr *ethhdr;
-	struct batadv_bla_claim search_claim, *claim = NULL;
+	struct batadv_bla_claim search_claim, *claim;
+	struct batadv_bla_backbone_gw *backbone_gw;
 	struct batadv_hard_iface *primary_if;
+	struct ethhdr *ethhdr;
+	u8 *primary_addr;
 	int ret;
 
 	ethhdr = eth_hdr(skb);
 
-	primary_if = batadv_primary_if_get_selected(bat_priv);
+	/* the primary_if, the claim and its backbone_gw are only accessed
+	 * within this rcu protected section - no reference counting needed
+	 */
+	rcu_read_lock();
+
+	primary_if = rcu_dereference(bat_priv->primary_if);
 	if (!primary_if)
 		goto handled;
 
@@ -1639,26 +1701,31 @@ int batadv_bla_rx(struct batadv_priv *bat_priv, struct sk_buff *skb,
 		if (is_multicast_ether_addr(ethhdr->h_dest) && is_bcast)
 			goto handled;
 
+	primary_addr = primary_if->net_dev->dev_addr;
+
 	ether_addr_copy(search_claim.addr, ethhdr->h_source);
 	search_claim.vid = vid;
-	claim = batadv_claim_hash_find(bat_priv, &search_claim);
+	claim = batadv_claim_hash_find_rcu(bat_priv, &search_claim);
 
 	if (!claim) {
 		/* possible optimization: race for a claim */
 		/* No claim exists yet, claim it for us!
 		 */
-		batadv_handle_claim(bat_priv, primary_if,
-				    primary_if->net_dev->dev_addr,
+		batadv_handle_claim(bat_priv, primary_if, primary_addr,
 				    ethhdr->h_source, vid);
 		goto allow;
 	}
 
 	/* if it is our own claim ... */
-	if (batadv_compare_eth(claim->backbone_gw->orig,
-			       primary_if->net_dev->dev_addr)) {
-		/* ... allow it in any case */
-		claim->lasttime = jiffies;
-		goto allow;
+	backbone_gw = claim->backbone_gw;
+	if (batadv_compare_eth(backbone_gw->orig, primary_addr)) {
+		/* ... allow it in any case. The backbone gw of an own claim
+		 * is the own backbone gw of this vlan - no need to look it up
+		 */
+		batadv_bla_lasttime_touch(&claim->lasttime);
+		batadv_bla_lasttime_touch(&backbone_gw->lasttime);
+		ret = 0;
+		goto out;
 	}
 
 	/* if it is a broadcast ... */
@@ -1675,8 +1742,7 @@ int batadv_bla_rx(struct batadv_priv *bat_priv, struct sk_buff *skb,
 		 * send a claim and update the claim table
 		 * immediately.
 		 */
-		batadv_handle_claim(bat_priv, primary_if,
-				    primary_if->net_dev->dev_addr,
+		batadv_handle_claim(bat_priv, primary_if, primary_addr,
 				    ethhdr->h_source, vid);
 		goto allow;
 	}
@@ -1690,10 +1756,7 @@ handled:
 	ret = 1;
 
 out:
-	if (primary_if)
-		batadv_hardif_put(primary_if);
-	if (claim)
-		batadv_claim_put(claim);
+	rcu_read_unlock();
 	return ret;
 }
 
@@ -1717,12 +1780,18 @@ out:
 int batadv_bla_tx(struct batadv_priv *bat_priv, struct sk_buff *skb,
 		  unsigned short vid)
 {
-	struct ethhdr *ethhdr;
-	struct batadv_bla_claim search_claim, *claim = NULL;
+	struct batadv_bla_claim search_claim, *claim;
 	struct batadv_hard_iface *primary_if;
+	struct ethhdr *ethhdr;
+	u8 *primary_addr;
 	int ret = 0;
 
-	primary_if = batadv_primary_if_get_selected(bat_priv);
+	/* the primary_if and the claim are only accessed within this rcu
+	 * protected section - no reference counting needed
+	 */
+	rcu_read_lock();
+
+	primary_if = rcu_dereference(bat_priv->primary_if);
 	if (!primary_if)
 		goto out;
 
@@ -1739,23 +1808,23 @@ int batadv_bla_tx(struct batadv_priv *bat_priv, struct sk_buff *skb,
 		if (is_multicast_ether_addr(ethhdr->h_dest))
 			goto handled;
 
+	primary_addr = primary_if->net_dev->dev_addr;
+
 	ether_addr_copy(search_claim.addr, ethhdr->h_source);
 	search_claim.vid = vid;
 
-	claim = batadv_claim_hash_find(bat_priv, &search_claim);
+	claim = batadv_claim_hash_find_rcu(bat_priv, &search_claim);
 
 	/* if no claim exists, allow it. */
 	if (!claim)
 		goto allow;
 
 	/* check if we are responsible. */
-	if (batadv_compare_eth(claim->backbone_gw->orig,
-			       primary_if->net_dev->dev_addr)) {
+	if (batadv_compare_eth(claim->backbone_gw->orig, primary_addr)) {
 		/* if yes, the client has roamed and we have
 		 * to unclaim it.
 		 */
-		batadv_handle_unclaim(bat_priv, primary_if,
-				      primary_if->net_dev->dev_addr,
+		batadv_handle_unclaim(bat_priv, primary_if, primary_addr,
 				      ethhdr->h_source, vid);
 		goto allow;
 	}
@@ -1779,10 +1848,7 @@ allow:
 handled:
 	ret = 1;
 out:
-	if (primary_if)
-		batadv_hardif_put(primary_if);
-	if (claim)
-		batadv_claim_put(claim);
+	rcu_read_unlock();
 	return ret;
 }
 
@@ -1842,6 +1908,118 @@ out:
 	return 0;
 }
 
+/**
+ * batadv_bla_claim_dump_entry - add a claim to a netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @primary_addr: mac address of the own primary interface
+ * @claim: the claim to add
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int
+batadv_bla_claim_dump_entry(struct sk_buff *msg, struct netlink_callback *cb,
+			    u8 *primary_addr, struct batadv_bla_claim *claim)
+{
+	u8 *backbone_addr = claim->backbone_gw->orig;
+	u16 backbone_crc;
+	bool is_own;
+	void *hdr;
+
+	is_own = batadv_compare_eth(backbone_addr, primary_addr);
+
+	spin_lock_bh(&claim->backbone_gw->crc_lock);
+	backbone_crc = claim->backbone_gw->crc;
+	spin_unlock_bh(&claim->backbone_gw->crc_lock);
+
+	hdr = batadv_netlink_hdr_put(msg, cb, BATADV_CMD_GET_BLA_CLAIM);
+	if (!hdr)
+		return -EMSGSIZE;
+
+	if (nla_put(msg, BATADV_ATTR_BLA_ADDRESS, ETH_ALEN, claim->addr) ||
+	    nla_put_u16(msg, BATADV_ATTR_BLA_VID, claim->vid) ||
+	    nla_put(msg, BATADV_ATTR_BLA_BACKBONE, ETH_ALEN, backbone_addr) ||
+	    nla_put_u16(msg, BATADV_ATTR_BLA_CRC, backbone_crc))
+		goto nla_put_failure;
+
+	if (is_own && nla_put_flag(msg, BATADV_ATTR_BLA_OWN))
+		goto nla_put_failure;
+
+	genlmsg_end(msg, hdr);
+	return 0;
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	return -EMSGSIZE;
+}
+
+/**
+ * batadv_bla_claim_dump - dump the claim table to a netlink socket
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @filter: filter of the dump request (originator matches the backbone gw)
+ *
+ * Return: 0 on success or a negative error number in case of failure. The
+ * dump position is kept in cb->args.
+ */
+int batadv_bla_claim_dump(struct sk_buff *msg, struct netlink_callback *cb,
+			  struct batadv_priv *bat_priv,
+			  const struct batadv_netlink_filter *filter)
+{
+	struct batadv_hashtable *hash = bat_priv->bla.claim_hash;
+	struct batadv_hard_iface *primary_if;
+	struct batadv_bla_claim *claim;
+	u32 bucket = cb->args[0];
+	int idx_s = cb->args[1];
+	struct hlist_head *head;
+	u8 *primary_addr;
+	int idx;
+
+	primary_if = batadv_primary_if_get_selected(bat_priv);
+	if (!primary_if)
+		return -ENOENT;
+
+	primary_addr = primary_if->net_dev->dev_addr;
+
+	for (; bucket < hash->size; bucket++) {
+		head = &hash->table[bucket];
+		idx = 0;
+
+		rcu_read_lock();
+		hlist_for_each_entry_rcu(claim, head, hash_entry) {
+			if (idx++ < idx_s)
+				continue;
+
+			if (filter->vid_set && claim->vid != filter->vid)
+				continue;
+
+			if (filter->orig_set &&
+			    !batadv_compare_eth(claim->backbone_gw->orig,
+						filter->orig))
+				continue;
+
+			if (batadv_bla_claim_dump_entry(msg, cb, primary_addr,
+							claim)) {
+				rcu_read_unlock();
+				idx_s = idx - 1;
+				goto out;
+			}
+		}
+		rcu_read_unlock();
+
+		idx_s = 0;
+	}
+
+out:
+	cb->args[0] = bucket;
+	cb->args[1] = idx_s;
+
+	batadv_hardif_put(primary_if);
+
+	return 0;
+}
+
 /**
  * batadv_bla_backbone_table_seq_print_text - print the backbone table in a seq
  *  file
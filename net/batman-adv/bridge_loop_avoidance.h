@@ -20,9 +20,11 @@
 
 #include "main.h"
 
+#include <linux/errno.h>
 #include <linux/types.h>
 
 struct net_device;
+struct netlink_callback;
 struct seq_file;
 struct sk_buff;
 
@@ -34,6 +36,9 @@ int batadv_bla_tx(struct batadv_priv *bat_priv, struct sk_buff *skb,
 int batadv_bla_is_backbone_gw(struct sk_buff *skb,
 			      struct batadv_orig_node *orig_node, int hdr_size);
 int batadv_bla_claim_table_seq_print_text(struct seq_file *seq, void *offset);
+int batadv_bla_claim_dump(struct sk_buff *msg, struct netlink_callback *cb,
+			  struct batadv_priv *bat_priv,
+			  const struct batadv_netlink_filter *filter);
 int batadv_bla_backbone_table_seq_print_text(struct seq_file *seq,
 					     void *offset);
 bool batadv_bla_is_backbone_gw_orig(struct batadv_priv *bat_priv, u8 *orig,
@@ -76,6 +81,14 @@ static inline int batadv_bla_claim_table_seq_print_text(struct seq_file *seq,
 	return 0;
 }
 
+static inline int
+batadv_bla_claim_dump(struct sk_buff *msg, struct netlink_callback *cb,
+		      struct batadv_priv *bat_priv,
+		      const struct batadv_netlink_filter *filter)
+{
+	return -EOPNOTSUPP;
+}
+
 static inline int batadv_bla_backbone_table_seq_print_text(struct seq_file *seq,
 							   void *offset)
 {
@@ -37,6 +37,7 @@
 #include <linux/spinlock.h>
 #include <linux/stat.h>
 #include <linux/stddef.h>
+#include <linux/string.h>
 #include <linux/stringify.h>
 #include <linux/sysfs.h>
 #include <linux/types.h>
@@ -48,6 +49,7 @@
 #include "distributed-arp-table.h"
 #include "gateway_client.h"
 #include "icmp_socket.h"
+#include "latency.h"
 #include "network-coding.h"
 #include "originator.h"
 #include "translation-table.h"
@@ -65,55 +67,58 @@ static char *batadv_log_char_addr(struct batadv_priv_debug_log *debug_log,
 	return &debug_log->log_buff[idx & BATADV_LOG_BUFF_MASK];
 }
 
-static void batadv_emit_log_char(struct batadv_priv_debug_log *debug_log,
-				 char c)
+static void batadv_emit_log_buf(struct batadv_priv_debug_log *debug_log,
+				const char *buf, size_t len)
 {
-	char *char_addr;
+	size_t idx, chunk;
+
+	/* only the tail of an overlong message survives anyway */
+	if (len > batadv_log_buff_len) {
+		buf += len - batadv_log_buff_len;
+		len = batadv_log_buff_len;
+	}
 
-	char_addr = batadv_log_char_addr(debug_log, debug_log->log_end);
-	*char_addr = c;
-	debug_log->log_end++;
+	while (len > 0) {
+		idx = debug_log->log_end & BATADV_LOG_BUFF_MASK;
+		chunk = min_t(size_t, len, batadv_log_buff_len - idx);
+
+		memcpy(batadv_log_char_addr(debug_log, idx), buf, chunk);
+		debug_log->log_end += chunk;
+		buf += chunk;
+		len -= chunk;
+	}
 
 	if (debug_log->log_end - debug_log->log_start > batadv_log_buff_len)
 		debug_log->log_start = debug_log->log_end - batadv_log_buff_len;
 }
 
-__printf(2, 3)
-static int batadv_fdebug_log(struct batadv_priv_debug_log *debug_log,
-			     const char *fmt, ...)
+int batadv_debug_log(struct batadv_priv *bat_priv, const char *fmt, ...)
 {
+	struct batadv_priv_debug_log *debug_log = bat_priv->debug_log;
+	char log_buf[256];
 	va_list args;
-	static char debug_log_buf[256];
-	char *p;
+	int len;
 
 	if (!debug_log)
 		return 0;
 
-	spin_lock_bh(&debug_log->lock);
+	/* format the complete line once and outside of the lock - only the
+	 * copy into the ring buffer has to be serialized
+	 */
+	len = scnprintf(log_buf, sizeof(log_buf), "[%10u] ",
+			jiffies_to_msecs(jiffies));
 	va_start(args, fmt);
-	vscnprintf(debug_log_buf, sizeof(debug_log_buf), fmt, args);
+	len += vscnprintf(log_buf + len, sizeof(log_buf) - len, fmt, args);
 	va_end(args);
 
-	for (p = debug_log_buf; *p != 0; p++)
-		batadv_emit_log_char(debug_log, *p);
-
+	spin_lock_bh(&debug_log->lock);
+	batadv_emit_log_buf(debug_log, log_buf, len);
 	spin_unlock_bh(&debug_log->lock);
 
-	wake_up(&debug_log->queue_wait);
-
-	return 0;
-}
-
-int batadv_debug_log(struct batadv_priv *bat_priv, const char *fmt, ...)
-{
-	va_list args;
-	char tmp_log_buf[256];
-
-	va_start(args, fmt);
-	vscnprintf(tmp_log_buf, sizeof(tmp_log_buf), fmt, args);
-	batadv_fdebug_log(bat_priv->debug_log, "[%10u] %s",
-			  jiffies_to_msecs(jiffies), tmp_log_buf);
-	va_end(args);
+	/* pairs with the barrier in prepare_to_wait() of the readers */
+	smp_mb();
+	if (waitqueue_active(&debug_log->queue_wait))
+		wake_up(&debug_log->queue_wait);
 
 	return 0;
 }
@@ -306,6 +311,13 @@ static int batadv_transtable_global_open(struct inode *inode, struct file *file)
 	return single_open(file, batadv_tt_global_seq_print_text, net_dev);
 }
 
+static int batadv_transtable_stats_open(struct inode *inode, struct file *file)
+{
+	struct net_device *net_dev = (struct net_device *)inode->i_private;
+
+	return single_open(file, batadv_tt_stats_seq_print_text, net_dev);
+}
+
 #ifdef CONFIG_BATMAN_ADV_BLA
 static int batadv_bla_claim_table_open(struct inode *inode, struct file *file)
 {
@@ -363,6 +375,35 @@ static int batadv_nc_nodes_open(struct inode *inode, struct file *file)
 }
 #endif
 
+#ifdef CONFIG_BATMAN_ADV_LATENCY
+static int batadv_latency_open(struct inode *inode, struct file *file)
+{
+	struct net_device *net_dev = (struct net_device *)inode->i_private;
+
+	return single_open(file, batadv_latency_seq_print_text, net_dev);
+}
+
+/**
+ * batadv_latency_write - reset the latency histograms
+ * @file: the debugfs file which was written to
+ * @buff: the written data (ignored)
+ * @count: the number of written bytes
+ * @ppos: file position (ignored)
+ *
+ * Return: count, all data is consumed
+ */
+static ssize_t batadv_latency_write(struct file *file, const char __user *buff,
+				    size_t count, loff_t *ppos)
+{
+	struct seq_file *seq = file->private_data;
+	struct net_device *net_dev = (struct net_device *)seq->private;
+
+	batadv_latency_reset(netdev_priv(net_dev));
+
+	return count;
+}
+#endif
+
 #define BATADV_DEBUGINFO(_name, _mode, _open)		\
 struct batadv_debuginfo batadv_debuginfo_##_name = {	\
 	.attr = { .name = __stringify(_name),		\
@@ -391,6 +432,8 @@ static BATADV_DEBUGINFO(originators, S_IRUGO, batadv_originators_open);
 static BATADV_DEBUGINFO(gateways, S_IRUGO, batadv_gateways_open);
 static BATADV_DEBUGINFO(transtable_global, S_IRUGO,
 			batadv_transtable_global_open);
+static BATADV_DEBUGINFO(transtable_stats, S_IRUGO,
+			batadv_transtable_stats_open);
 #ifdef CONFIG_BATMAN_ADV_BLA
 static BATADV_DEBUGINFO(bla_claim_table, S_IRUGO, batadv_bla_claim_table_open);
 static BATADV_DEBUGINFO(bla_backbone_table, S_IRUGO,
@@ -404,12 +447,26 @@ static BATADV_DEBUGINFO(transtable_local, S_IRUGO,
 #ifdef CONFIG_BATMAN_ADV_NC
 static BATADV_DEBUGINFO(nc_nodes, S_IRUGO, batadv_nc_nodes_open);
 #endif
+#ifdef CONFIG_BATMAN_ADV_LATENCY
+static struct batadv_debuginfo batadv_debuginfo_latency = {
+	.attr = { .name = "latency",
+		  .mode = S_IRUGO | S_IWUSR, },
+	.fops = { .owner = THIS_MODULE,
+		  .open = batadv_latency_open,
+		  .read	= seq_read,
+		  .write = batadv_latency_write,
+		  .llseek = seq_lseek,
+		  .release = single_release,
+		}
+};
+#endif
 
 static struct batadv_debuginfo *batadv_mesh_debuginfos[] = {
 	&batadv_debuginfo_neighbors,
 	&batadv_debuginfo_originators,
 	&batadv_debuginfo_gateways,
 	&batadv_debuginfo_transtable_global,
+	&batadv_debuginfo_transtable_stats,
 #ifdef CONFIG_BATMAN_ADV_BLA
 	&batadv_debuginfo_bla_claim_table,
 	&batadv_debuginfo_bla_backbone_table,
@@ -420,6 +477,9 @@ static struct batadv_debuginfo *batadv_mesh_debuginfos[] = {
 	&batadv_debuginfo_transtable_local,
 #ifdef CONFIG_BATMAN_ADV_NC
 	&batadv_debuginfo_nc_nodes,
+#endif
+#ifdef CONFIG_BATMAN_ADV_LATENCY
+	&batadv_debuginfo_latency,
 #endif
 	NULL,
 };
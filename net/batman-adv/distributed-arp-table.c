@@ -21,17 +21,24 @@
 #include <linux/atomic.h>
 #include <linux/bitops.h>
 #include <linux/byteorder/generic.h>
+#include <linux/compiler.h>
 #include <linux/errno.h>
 #include <linux/etherdevice.h>
 #include <linux/fs.h>
 #include <linux/if_arp.h>
 #include <linux/if_ether.h>
+#include <linux/icmpv6.h>
 #include <linux/if_vlan.h>
 #include <linux/in.h>
+#include <linux/in6.h>
+#include <linux/ipv6.h>
+#include <linux/jhash.h>
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
 #include <linux/kref.h>
 #include <linux/list.h>
+#include <linux/netdevice.h>
+#include <linux/netlink.h>
 #include <linux/rculist.h>
 #include <linux/rcupdate.h>
 #include <linux/seq_file.h>
@@ -41,10 +48,18 @@
 #include <linux/stddef.h>
 #include <linux/string.h>
 #include <linux/workqueue.h>
+#include <net/addrconf.h>
 #include <net/arp.h>
+#include <net/genetlink.h>
+#include <net/ip6_checksum.h>
+#include <net/ipv6.h>
+#include <net/ndisc.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "hard-interface.h"
 #include "hash.h"
+#include "netlink.h"
 #include "originator.h"
 #include "send.h"
 #include "translation-table.h"
@@ -98,6 +113,61 @@ static bool batadv_dat_to_purge(struct batadv_dat_entry *dat_entry)
 				    BATADV_DAT_ENTRY_TIMEOUT);
 }
 
+/**
+ * batadv_dat_bloom_key - compute the bloom filter key of a DAT entry
+ * @dat: the entry (or lookup key) to hash
+ *
+ * Entries are only compared by their IP address (see batadv_compare_dat), so
+ * the vid is not part of the key either.
+ *
+ * Return: 32 bit hash of the IP address of @dat
+ */
+static u32 batadv_dat_bloom_key(const struct batadv_dat_entry *dat)
+{
+	if (dat->family == AF_INET6)
+		return jhash2((const u32 *)dat->ip6.s6_addr32,
+			      ARRAY_SIZE(dat->ip6.s6_addr32), AF_INET6);
+
+	return jhash_1word((__force u32)dat->ip, 0);
+}
+
+/**
+ * batadv_dat_dbg_entry - print a debug message about a DAT entry
+ * @bat_priv: the bat priv with all the soft interface information
+ * @msg: the message to prefix the entry with
+ * @dat_entry: the entry to print
+ */
+static void batadv_dat_dbg_entry(struct batadv_priv *bat_priv, const char *msg,
+				 const struct batadv_dat_entry *dat_entry)
+{
+	if (dat_entry->family == AF_INET6)
+		batadv_dbg(BATADV_DBG_DAT, bat_priv,
+			   "%s: %pI6c %pM (vid: %d)\n", msg, &dat_entry->ip6,
+			   dat_entry->mac_addr,
+			   BATADV_PRINT_VID(dat_entry->vid));
+	else
+		batadv_dbg(BATADV_DBG_DAT, bat_priv,
+			   "%s: %pI4 %pM (vid: %d)\n", msg, &dat_entry->ip,
+			   dat_entry->mac_addr,
+			   BATADV_PRINT_VID(dat_entry->vid));
+}
+
+/**
+ * batadv_dat_entry_unhash - remove an entry from the DAT local storage
+ * @bat_priv: the bat priv with all the soft interface information
+ * @dat_entry: the entry to remove
+ *
+ * The caller must hold the lock of the hash bucket @dat_entry is stored in.
+ */
+static void batadv_dat_entry_unhash(struct batadv_priv *bat_priv,
+				    struct batadv_dat_entry *dat_entry)
+{
+	hlist_del_rcu(&dat_entry->hash_entry);
+	batadv_bloom_del(bat_priv->dat.bloom, batadv_dat_bloom_key(dat_entry));
+	atomic_dec(&bat_priv->dat.num_entries);
+	batadv_dat_entry_put(dat_entry);
+}
+
 /**
  * __batadv_dat_purge - delete entries from the DAT local storage
  * @bat_priv: the bat priv with all the soft interface information
@@ -134,11 +204,95 @@ static void __batadv_dat_purge(struct batadv_priv *bat_priv,
 			if (to_purge && !to_purge(dat_entry))
 				continue;
 
-			hlist_del_rcu(&dat_entry->hash_entry);
-			batadv_dat_entry_put(dat_entry);
+			batadv_dat_entry_unhash(bat_priv, dat_entry);
+		}
+		spin_unlock_bh(list_lock);
+	}
+}
+
+/**
+ * batadv_dat_evict - make room for a new entry in the DAT local storage
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Deletes entries until the local storage holds less than dat_max_entries
+ * entries. Victims are chosen with the CLOCK (second chance) algorithm: the
+ * hash buckets form the clock face and entries which were looked up since
+ * the clock hand passed them last time are spared for one more round.
+ *
+ * Only one context evicts at a time, concurrent callers return immediately.
+ * The configured size therefore is a soft limit which can be exceeded by a
+ * few entries for a short time.
+ */
+static void batadv_dat_evict(struct batadv_priv *bat_priv)
+{
+	struct batadv_hashtable *hash = bat_priv->dat.hash;
+	spinlock_t *list_lock; /* protects write access to the hash lists */
+	struct batadv_dat_entry *dat_entry;
+	struct hlist_node *node_tmp;
+	struct hlist_head *head;
+	int max_entries;
+	u32 i, bucket;
+
+	if (!spin_trylock_bh(&bat_priv->dat.evict_lock))
+		return;
+
+	max_entries = atomic_read(&bat_priv->dat_max_entries);
+
+	/* the first round clears all referenced flags, the second one is
+	 * guaranteed to find victims. The scan is bounded to two rounds
+	 * over the buckets because it may run in softirq context (from the
+	 * ARP snooping receive path): the evict_lock is only trylocked and
+	 * every bucket lock is held for one bucket at a time, so a caller
+	 * never spins for more than these 2 * hash->size short walks
+	 */
+	for (i = 0; i < 2 * hash->size; i++) {
+		if (atomic_read(&bat_priv->dat.num_entries) < max_entries)
+			break;
+
+		bucket = bat_priv->dat.clock_hand;
+		bat_priv->dat.clock_hand = (bucket + 1) % hash->size;
+
+		head = &hash->table[bucket];
+		list_lock = &hash->list_locks[bucket];
+
+		spin_lock_bh(list_lock);
+		hlist_for_each_entry_safe(dat_entry, node_tmp, head,
+					  hash_entry) {
+			if (atomic_read(&bat_priv->dat.num_entries) <
+			    max_entries)
+				break;
+
+			if (ACCESS_ONCE(dat_entry->referenced)) {
+				ACCESS_ONCE(dat_entry->referenced) = false;
+				continue;
+			}
+
+			batadv_dat_dbg_entry(bat_priv, "Entry evicted",
+					     dat_entry);
+
+			batadv_dat_entry_unhash(bat_priv, dat_entry);
+			batadv_inc_counter(bat_priv,
+					   BATADV_CNT_DAT_CACHE_EVICT);
 		}
 		spin_unlock_bh(list_lock);
 	}
+
+	spin_unlock_bh(&bat_priv->dat.evict_lock);
+}
+
+/**
+ * batadv_dat_max_entries_update - shrink the DAT local storage after its
+ *  maximum size was changed
+ * @net_dev: the soft interface net device
+ */
+void batadv_dat_max_entries_update(struct net_device *net_dev)
+{
+	struct batadv_priv *bat_priv = netdev_priv(net_dev);
+
+	if (!bat_priv->dat.hash)
+		return;
+
+	batadv_dat_evict(bat_priv);
 }
 
 /**
@@ -169,10 +323,17 @@ static void batadv_dat_purge(struct work_struct *work)
  */
 static int batadv_compare_dat(const struct hlist_node *node, const void *data2)
 {
-	const void *data1 = container_of(node, struct batadv_dat_entry,
-					 hash_entry);
+	const struct batadv_dat_entry *dat1, *dat2 = data2;
+
+	dat1 = container_of(node, struct batadv_dat_entry, hash_entry);
+
+	if (dat1->family != dat2->family)
+		return 0;
+
+	if (dat1->family == AF_INET6)
+		return ipv6_addr_equal(&dat1->ip6, &dat2->ip6) ? 1 : 0;
 
-	return memcmp(data1, data2, sizeof(__be32)) == 0 ? 1 : 0;
+	return dat1->ip == dat2->ip ? 1 : 0;
 }
 
 /**
@@ -240,10 +401,17 @@ static u32 batadv_hash_dat(const void *data, u32 size)
 	u32 hash = 0;
 	const struct batadv_dat_entry *dat = data;
 	const unsigned char *key;
-	u32 i;
+	u32 i, key_len;
+
+	if (dat->family == AF_INET6) {
+		key = (const unsigned char *)&dat->ip6;
+		key_len = sizeof(dat->ip6);
+	} else {
+		key = (const unsigned char *)&dat->ip;
+		key_len = sizeof(dat->ip);
+	}
 
-	key = (const unsigned char *)&dat->ip;
-	for (i = 0; i < sizeof(dat->ip); i++) {
+	for (i = 0; i < key_len; i++) {
 		hash += key[i];
 		hash += (hash << 10);
 		hash ^= (hash >> 6);
@@ -264,103 +432,213 @@ static u32 batadv_hash_dat(const void *data, u32 size)
 }
 
 /**
- * batadv_dat_entry_hash_find - look for a given dat_entry in the local hash
+ * __batadv_dat_entry_hash_find - look for a given dat_entry in the local hash
  * table
  * @bat_priv: the bat priv with all the soft interface information
- * @ip: search key
- * @vid: VLAN identifier
+ * @to_find: search key (family, address and vid have to be set)
  *
  * Return: the dat_entry if found, NULL otherwise.
  */
 static struct batadv_dat_entry *
-batadv_dat_entry_hash_find(struct batadv_priv *bat_priv, __be32 ip,
-			   unsigned short vid)
+__batadv_dat_entry_hash_find(struct batadv_priv *bat_priv,
+			     const struct batadv_dat_entry *to_find)
 {
 	struct hlist_head *head;
-	struct batadv_dat_entry to_find, *dat_entry, *dat_entry_tmp = NULL;
+	struct batadv_dat_entry *dat_entry, *dat_entry_tmp = NULL;
 	struct batadv_hashtable *hash = bat_priv->dat.hash;
 	u32 index;
 
 	if (!hash)
 		return NULL;
 
-	to_find.ip = ip;
-	to_find.vid = vid;
+	if (!batadv_bloom_may_contain(bat_priv->dat.bloom,
+				      batadv_dat_bloom_key(to_find))) {
+		batadv_inc_counter(bat_priv, BATADV_CNT_DAT_BLOOM_SKIP);
+		return NULL;
+	}
 
-	index = batadv_hash_dat(&to_find, hash->size);
+	index = batadv_hash_dat(to_find, hash->size);
 	head = &hash->table[index];
 
 	rcu_read_lock();
 	hlist_for_each_entry_rcu(dat_entry, head, hash_entry) {
-		if (dat_entry->ip != ip)
+		if (!batadv_compare_dat(&dat_entry->hash_entry, to_find))
 			continue;
 
 		if (!kref_get_unless_zero(&dat_entry->refcount))
 			continue;
 
+		/* avoid dirtying the cache line when the flag is already set */
+		if (!ACCESS_ONCE(dat_entry->referenced))
+			ACCESS_ONCE(dat_entry->referenced) = true;
+
 		dat_entry_tmp = dat_entry;
 		break;
 	}
 	rcu_read_unlock();
 
+	if (!dat_entry_tmp)
+		batadv_inc_counter(bat_priv, BATADV_CNT_DAT_BLOOM_FALSE_POS);
+
 	return dat_entry_tmp;
 }
 
 /**
- * batadv_dat_entry_add - add a new dat entry or update it if already exists
+ * batadv_dat_entry_hash_find - look for a given IPv4 dat_entry in the local
+ * hash table
  * @bat_priv: the bat priv with all the soft interface information
- * @ip: ipv4 to add/edit
- * @mac_addr: mac address to assign to the given ipv4
+ * @ip: search key
  * @vid: VLAN identifier
+ *
+ * Return: the dat_entry if found, NULL otherwise.
  */
-static void batadv_dat_entry_add(struct batadv_priv *bat_priv, __be32 ip,
-				 u8 *mac_addr, unsigned short vid)
+static struct batadv_dat_entry *
+batadv_dat_entry_hash_find(struct batadv_priv *bat_priv, __be32 ip,
+			   unsigned short vid)
+{
+	struct batadv_dat_entry to_find;
+
+	to_find.family = AF_INET;
+	to_find.ip = ip;
+	to_find.vid = vid;
+
+	return __batadv_dat_entry_hash_find(bat_priv, &to_find);
+}
+
+/**
+ * batadv_dat_entry6_hash_find - look for a given IPv6 dat_entry in the local
+ * hash table
+ * @bat_priv: the bat priv with all the soft interface information
+ * @ip6: search key
+ * @vid: VLAN identifier
+ *
+ * Return: the dat_entry if found, NULL otherwise.
+ */
+static struct batadv_dat_entry *
+batadv_dat_entry6_hash_find(struct batadv_priv *bat_priv,
+			    const struct in6_addr *ip6, unsigned short vid)
+{
+	struct batadv_dat_entry to_find;
+
+	to_find.family = AF_INET6;
+	to_find.ip6 = *ip6;
+	to_find.vid = vid;
+
+	return __batadv_dat_entry_hash_find(bat_priv, &to_find);
+}
+
+/**
+ * __batadv_dat_entry_add - add a new dat entry or update it if already exists
+ * @bat_priv: the bat priv with all the soft interface information
+ * @key: family, address and vid of the entry to add/edit
+ * @mac_addr: mac address to assign to the given address
+ */
+static void __batadv_dat_entry_add(struct batadv_priv *bat_priv,
+				   const struct batadv_dat_entry *key,
+				   u8 *mac_addr)
 {
 	struct batadv_dat_entry *dat_entry;
 	int hash_added;
+	u32 bloom_key;
 
-	dat_entry = batadv_dat_entry_hash_find(bat_priv, ip, vid);
+	dat_entry = __batadv_dat_entry_hash_find(bat_priv, key);
 	/* if this entry is already known, just update it */
 	if (dat_entry) {
 		if (!batadv_compare_eth(dat_entry->mac_addr, mac_addr))
 			ether_addr_copy(dat_entry->mac_addr, mac_addr);
 		dat_entry->last_update = jiffies;
-		batadv_dbg(BATADV_DBG_DAT, bat_priv,
-			   "Entry updated: %pI4 %pM (vid: %d)\n",
-			   &dat_entry->ip, dat_entry->mac_addr,
-			   BATADV_PRINT_VID(vid));
+		batadv_dat_dbg_entry(bat_priv, "Entry updated", dat_entry);
 		goto out;
 	}
 
+	if (atomic_read(&bat_priv->dat.num_entries) >=
+	    atomic_read(&bat_priv->dat_max_entries))
+		batadv_dat_evict(bat_priv);
+
 	dat_entry = kmalloc(sizeof(*dat_entry), GFP_ATOMIC);
 	if (!dat_entry)
 		goto out;
 
-	dat_entry->ip = ip;
-	dat_entry->vid = vid;
+	dat_entry->family = key->family;
+	if (key->family == AF_INET6)
+		dat_entry->ip6 = key->ip6;
+	else
+		dat_entry->ip = key->ip;
+	dat_entry->router = false;
+	dat_entry->vid = key->vid;
 	ether_addr_copy(dat_entry->mac_addr, mac_addr);
 	dat_entry->last_update = jiffies;
+	dat_entry->last_refresh = jiffies;
+	dat_entry->referenced = false;
 	kref_init(&dat_entry->refcount);
 	kref_get(&dat_entry->refcount);
 
+	atomic_inc(&bat_priv->dat.num_entries);
+
+	/* the bloom filter must know the entry before lookups can find it */
+	bloom_key = batadv_dat_bloom_key(dat_entry);
+	batadv_bloom_add(bat_priv->dat.bloom, bloom_key);
+
 	hash_added = batadv_hash_add(bat_priv->dat.hash, batadv_compare_dat,
 				     batadv_hash_dat, dat_entry,
 				     &dat_entry->hash_entry);
 
 	if (unlikely(hash_added != 0)) {
+		batadv_bloom_del(bat_priv->dat.bloom, bloom_key);
+		atomic_dec(&bat_priv->dat.num_entries);
 		/* remove the reference for the hash */
 		batadv_dat_entry_put(dat_entry);
 		goto out;
 	}
 
-	batadv_dbg(BATADV_DBG_DAT, bat_priv, "New entry added: %pI4 %pM (vid: %d)\n",
-		   &dat_entry->ip, dat_entry->mac_addr, BATADV_PRINT_VID(vid));
+	batadv_dat_dbg_entry(bat_priv, "New entry added", dat_entry);
 
 out:
 	if (dat_entry)
 		batadv_dat_entry_put(dat_entry);
 }
 
+/**
+ * batadv_dat_entry_add - add a new IPv4 dat entry or update it if already
+ *  exists
+ * @bat_priv: the bat priv with all the soft interface information
+ * @ip: ipv4 to add/edit
+ * @mac_addr: mac address to assign to the given ipv4
+ * @vid: VLAN identifier
+ */
+static void batadv_dat_entry_add(struct batadv_priv *bat_priv, __be32 ip,
+				 u8 *mac_addr, unsigned short vid)
+{
+	struct batadv_dat_entry key;
+
+	key.family = AF_INET;
+	key.ip = ip;
+	key.vid = vid;
+
+	__batadv_dat_entry_add(bat_priv, &key, mac_addr);
+}
+
+/**
+ * batadv_dat_entry6_add - add a new IPv6 dat entry or update it if already
+ *  exists
+ * @bat_priv: the bat priv with all the soft interface information
+ * @ip6: ipv6 to add/edit
+ * @mac_addr: mac address to assign to the given ipv6
+ * @vid: VLAN identifier
+ */
+static void batadv_dat_entry6_add(struct batadv_priv *bat_priv,
+				  const struct in6_addr *ip6, u8 *mac_addr,
+				  unsigned short vid)
+{
+	struct batadv_dat_entry key;
+
+	key.family = AF_INET6;
+	key.ip6 = *ip6;
+	key.vid = vid;
+
+	__batadv_dat_entry_add(bat_priv, &key, mac_addr);
+}
+
 #ifdef CONFIG_BATMAN_ADV_DEBUG
 
 /**
@@ -567,16 +845,17 @@ static void batadv_choose_next_candidate(struct batadv_priv *bat_priv,
  * batadv_dat_select_candidates - select the nodes which the DHT message has to
  * be sent to
  * @bat_priv: the bat priv with all the soft interface information
- * @ip_dst: ipv4 to look up in the DHT
+ * @key: entry holding the ipv4 or ipv6 address to look up in the DHT
  *
  * An originator O is selected if and only if its DHT_ID value is one of three
  * closest values (from the LEFT, with wrap around if needed) then the hash
- * value of the key. ip_dst is the key.
+ * value of the key. The IP address of key is the key.
  *
  * Return: the candidate array of size BATADV_DAT_CANDIDATE_NUM.
  */
 static struct batadv_dat_candidate *
-batadv_dat_select_candidates(struct batadv_priv *bat_priv, __be32 ip_dst)
+batadv_dat_select_candidates(struct batadv_priv *bat_priv,
+			     const struct batadv_dat_entry *key)
 {
 	int select;
 	batadv_dat_addr_t last_max = BATADV_DAT_ADDR_MAX, ip_key;
@@ -591,14 +870,24 @@ batadv_dat_select_candidates(struct batadv_priv *bat_priv, __be32 ip_dst)
 	if (!res)
 		return NULL;
 
-	dat.ip = ip_dst;
+	/* the vid is not part of the DHT key */
+	dat.family = key->family;
+	if (key->family == AF_INET6)
+		dat.ip6 = key->ip6;
+	else
+		dat.ip = key->ip;
 	dat.vid = 0;
 	ip_key = (batadv_dat_addr_t)batadv_hash_dat(&dat,
 						    BATADV_DAT_ADDR_MAX);
 
-	batadv_dbg(BATADV_DBG_DAT, bat_priv,
-		   "dat_select_candidates(): IP=%pI4 hash(IP)=%u\n", &ip_dst,
-		   ip_key);
+	if (key->family == AF_INET6)
+		batadv_dbg(BATADV_DBG_DAT, bat_priv,
+			   "dat_select_candidates(): IP=%pI6c hash(IP)=%u\n",
+			   &key->ip6, ip_key);
+	else
+		batadv_dbg(BATADV_DBG_DAT, bat_priv,
+			   "dat_select_candidates(): IP=%pI4 hash(IP)=%u\n",
+			   &key->ip, ip_key);
 
 	for (select = 0; select < BATADV_DAT_CANDIDATES_NUM; select++)
 		batadv_choose_next_candidate(bat_priv, res, select, ip_key,
@@ -608,10 +897,10 @@ batadv_dat_select_candidates(struct batadv_priv *bat_priv, __be32 ip_dst)
 }
 
 /**
- * batadv_dat_send_data - send a payload to the selected candidates
+ * __batadv_dat_send_data - send a payload to the selected candidates
  * @bat_priv: the bat priv with all the soft interface information
  * @skb: payload to send
- * @ip: the DHT key
+ * @key: entry holding the DHT key (ipv4 or ipv6 address)
  * @packet_subtype: unicast4addr packet subtype to use
  *
  * This function copies the skb with pskb_copy() and is sent as unicast packet
@@ -620,9 +909,10 @@ batadv_dat_select_candidates(struct batadv_priv *bat_priv, __be32 ip_dst)
  * Return: true if the packet is sent to at least one candidate, false
  * otherwise.
  */
-static bool batadv_dat_send_data(struct batadv_priv *bat_priv,
-				 struct sk_buff *skb, __be32 ip,
-				 int packet_subtype)
+static bool __batadv_dat_send_data(struct batadv_priv *bat_priv,
+				   struct sk_buff *skb,
+				   const struct batadv_dat_entry *key,
+				   int packet_subtype)
 {
 	int i;
 	bool ret = false;
@@ -631,11 +921,16 @@ static bool batadv_dat_send_data(struct batadv_priv *bat_priv,
 	struct sk_buff *tmp_skb;
 	struct batadv_dat_candidate *cand;
 
-	cand = batadv_dat_select_candidates(bat_priv, ip);
+	cand = batadv_dat_select_candidates(bat_priv, key);
 	if (!cand)
 		goto out;
 
-	batadv_dbg(BATADV_DBG_DAT, bat_priv, "DHT_SEND for %pI4\n", &ip);
+	if (key->family == AF_INET6)
+		batadv_dbg(BATADV_DBG_DAT, bat_priv, "DHT_SEND for %pI6c\n",
+			   &key->ip6);
+	else
+		batadv_dbg(BATADV_DBG_DAT, bat_priv, "DHT_SEND for %pI4\n",
+			   &key->ip);
 
 	for (i = 0; i < BATADV_DAT_CANDIDATES_NUM; i++) {
 		if (cand[i].type == BATADV_DAT_CANDIDATE_NOT_FOUND)
@@ -682,6 +977,51 @@ out:
 	return ret;
 }
 
+/**
+ * batadv_dat_send_data - send a payload to the candidates of an ipv4 address
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: payload to send
+ * @ip: the DHT key
+ * @packet_subtype: unicast4addr packet subtype to use
+ *
+ * Return: true if the packet is sent to at least one candidate, false
+ * otherwise.
+ */
+static bool batadv_dat_send_data(struct batadv_priv *bat_priv,
+				 struct sk_buff *skb, __be32 ip,
+				 int packet_subtype)
+{
+	struct batadv_dat_entry key;
+
+	key.family = AF_INET;
+	key.ip = ip;
+
+	return __batadv_dat_send_data(bat_priv, skb, &key, packet_subtype);
+}
+
+/**
+ * batadv_dat_send_data6 - send a payload to the candidates of an ipv6 address
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: payload to send
+ * @ip6: the DHT key
+ * @packet_subtype: unicast4addr packet subtype to use
+ *
+ * Return: true if the packet is sent to at least one candidate, false
+ * otherwise.
+ */
+static bool batadv_dat_send_data6(struct batadv_priv *bat_priv,
+				  struct sk_buff *skb,
+				  const struct in6_addr *ip6,
+				  int packet_subtype)
+{
+	struct batadv_dat_entry key;
+
+	key.family = AF_INET6;
+	key.ip6 = *ip6;
+
+	return __batadv_dat_send_data(bat_priv, skb, &key, packet_subtype);
+}
+
 /**
  * batadv_dat_tvlv_container_update - update the dat tvlv container after dat
  *  setting change
@@ -747,8 +1087,10 @@ static void batadv_dat_hash_free(struct batadv_priv *bat_priv)
 	__batadv_dat_purge(bat_priv, NULL);
 
 	batadv_hash_destroy(bat_priv->dat.hash);
+	batadv_bloom_destroy(bat_priv->dat.bloom);
 
 	bat_priv->dat.hash = NULL;
+	bat_priv->dat.bloom = NULL;
 }
 
 /**
@@ -767,6 +1109,17 @@ int batadv_dat_init(struct batadv_priv *bat_priv)
 	if (!bat_priv->dat.hash)
 		return -ENOMEM;
 
+	atomic_set(&bat_priv->dat.num_entries, 0);
+	bat_priv->dat.clock_hand = 0;
+	spin_lock_init(&bat_priv->dat.evict_lock);
+
+	bat_priv->dat.bloom = batadv_bloom_new(BATADV_DAT_BLOOM_BITS);
+	if (!bat_priv->dat.bloom) {
+		batadv_hash_destroy(bat_priv->dat.hash);
+		bat_priv->dat.hash = NULL;
+		return -ENOMEM;
+	}
+
 	batadv_dat_start_timer(bat_priv);
 
 	batadv_tvlv_handler_register(bat_priv, batadv_dat_tvlv_ogm_handler_v1,
@@ -807,13 +1160,19 @@ int batadv_dat_cache_seq_print_text(struct seq_file *seq, void *offset)
 	struct hlist_head *head;
 	unsigned long last_seen_jiffies;
 	int last_seen_msecs, last_seen_secs, last_seen_mins;
+	int num_entries;
 	u32 i;
 
 	primary_if = batadv_seq_print_text_primary_if_get(seq);
 	if (!primary_if)
 		goto out;
 
-	seq_printf(seq, "Distributed ARP Table (%s):\n", net_dev->name);
+	num_entries = atomic_read(&bat_priv->dat.num_entries);
+	seq_printf(seq,
+		   "Distributed ARP Table (%s), %d/%d entries, %zu KiB:\n",
+		   net_dev->name, num_entries,
+		   atomic_read(&bat_priv->dat_max_entries),
+		   num_entries * sizeof(*dat_entry) / 1024);
 	seq_printf(seq, "          %-7s          %-9s %4s %11s\n", "IPv4",
 		   "MAC", "VID", "last-seen");
 
@@ -828,10 +1187,16 @@ int batadv_dat_cache_seq_print_text(struct seq_file *seq, void *offset)
 			last_seen_msecs = last_seen_msecs % 60000;
 			last_seen_secs = last_seen_msecs / 1000;
 
-			seq_printf(seq, " * %15pI4 %14pM %4i %6i:%02i\n",
-				   &dat_entry->ip, dat_entry->mac_addr,
-				   BATADV_PRINT_VID(dat_entry->vid),
-				   last_seen_mins, last_seen_secs);
+			if (dat_entry->family == AF_INET6)
+				seq_printf(seq, " * %pI6c %14pM %4i %6i:%02i\n",
+					   &dat_entry->ip6, dat_entry->mac_addr,
+					   BATADV_PRINT_VID(dat_entry->vid),
+					   last_seen_mins, last_seen_secs);
+			else
+				seq_printf(seq, " * %15pI4 %14pM %4i %6i:%02i\n",
+					   &dat_entry->ip, dat_entry->mac_addr,
+					   BATADV_PRINT_VID(dat_entry->vid),
+					   last_seen_mins, last_seen_secs);
 		}
 		rcu_read_unlock();
 	}
@@ -842,6 +1207,101 @@ out:
 	return 0;
 }
 
+/**
+ * batadv_dat_cache_dump_entry - add a DAT cache entry to a netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @dat_entry: the entry to add
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int
+batadv_dat_cache_dump_entry(struct sk_buff *msg, struct netlink_callback *cb,
+			    struct batadv_dat_entry *dat_entry)
+{
+	unsigned int last_seen_msecs;
+	void *hdr;
+
+	last_seen_msecs = jiffies_to_msecs(jiffies - dat_entry->last_update);
+
+	hdr = batadv_netlink_hdr_put(msg, cb, BATADV_CMD_GET_DAT_CACHE);
+	if (!hdr)
+		return -EMSGSIZE;
+
+	if (dat_entry->family == AF_INET6) {
+		if (nla_put(msg, BATADV_ATTR_DAT_CACHE_IP6ADDRESS,
+			    sizeof(dat_entry->ip6), &dat_entry->ip6))
+			goto nla_put_failure;
+	} else {
+		if (nla_put_be32(msg, BATADV_ATTR_DAT_CACHE_IP4ADDRESS,
+				 dat_entry->ip))
+			goto nla_put_failure;
+	}
+
+	if (nla_put(msg, BATADV_ATTR_DAT_CACHE_HWADDRESS, ETH_ALEN,
+		    dat_entry->mac_addr) ||
+	    nla_put_u16(msg, BATADV_ATTR_DAT_CACHE_VID, dat_entry->vid) ||
+	    nla_put_u32(msg, BATADV_ATTR_LAST_SEEN_MSECS, last_seen_msecs))
+		goto nla_put_failure;
+
+	genlmsg_end(msg, hdr);
+	return 0;
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	return -EMSGSIZE;
+}
+
+/**
+ * batadv_dat_cache_dump - dump the DAT cache to a netlink socket
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @filter: filter of the dump request (only the vlan is evaluated)
+ *
+ * Return: always 0 - the dump position is kept in cb->args
+ */
+int batadv_dat_cache_dump(struct sk_buff *msg, struct netlink_callback *cb,
+			  struct batadv_priv *bat_priv,
+			  const struct batadv_netlink_filter *filter)
+{
+	struct batadv_hashtable *hash = bat_priv->dat.hash;
+	struct batadv_dat_entry *dat_entry;
+	u32 bucket = cb->args[0];
+	int idx_s = cb->args[1];
+	struct hlist_head *head;
+	int idx;
+
+	for (; bucket < hash->size; bucket++) {
+		head = &hash->table[bucket];
+		idx = 0;
+
+		rcu_read_lock();
+		hlist_for_each_entry_rcu(dat_entry, head, hash_entry) {
+			if (idx++ < idx_s)
+				continue;
+
+			if (filter->vid_set && dat_entry->vid != filter->vid)
+				continue;
+
+			if (batadv_dat_cache_dump_entry(msg, cb, dat_entry)) {
+				rcu_read_unlock();
+				idx_s = idx - 1;
+				goto out;
+			}
+		}
+		rcu_read_unlock();
+
+		idx_s = 0;
+	}
+
+out:
+	cb->args[0] = bucket;
+	cb->args[1] = idx_s;
+
+	return 0;
+}
+
 /**
  * batadv_arp_get_type - parse an ARP packet and gets the type
  * @bat_priv: the bat priv with all the soft interface information
@@ -943,29 +1403,293 @@ static unsigned short batadv_dat_get_vid(struct sk_buff *skb, int *hdr_size)
 }
 
 /**
- * batadv_dat_snoop_outgoing_arp_request - snoop the ARP request and try to
- * answer using DAT
- * @bat_priv: the bat priv with all the soft interface information
- * @skb: packet to check
+ * batadv_nd_ip6hdr - get the IPv6 header of a neighbor discovery packet
+ * @skb: the packet
+ * @hdr_size: size of the possible header before the ethernet header
  *
- * Return: true if the message has been sent to the dht candidates, false
- * otherwise. In case of a positive return value the message has to be enqueued
- * to permit the fallback.
+ * Return: the IPv6 header behind the ethernet header of @skb.
  */
-bool batadv_dat_snoop_outgoing_arp_request(struct batadv_priv *bat_priv,
-					   struct sk_buff *skb)
+static struct ipv6hdr *batadv_nd_ip6hdr(struct sk_buff *skb, int hdr_size)
 {
-	u16 type = 0;
-	__be32 ip_dst, ip_src;
-	u8 *hw_src;
-	bool ret = false;
-	struct batadv_dat_entry *dat_entry = NULL;
-	struct sk_buff *skb_new;
-	int hdr_size = 0;
-	unsigned short vid;
+	return (struct ipv6hdr *)(skb->data + hdr_size + ETH_HLEN);
+}
 
-	if (!atomic_read(&bat_priv->distributed_arp_table))
-		goto out;
+/**
+ * batadv_nd_msg - get the neighbor discovery message of a packet
+ * @skb: the packet
+ * @hdr_size: size of the possible header before the ethernet header
+ *
+ * Return: the neighbor solicitation/advertisement following the IPv6 header.
+ */
+static struct nd_msg *batadv_nd_msg(struct sk_buff *skb, int hdr_size)
+{
+	return (struct nd_msg *)(batadv_nd_ip6hdr(skb, hdr_size) + 1);
+}
+
+/**
+ * batadv_nd_get_type - parse an IPv6 neighbor discovery packet and get the type
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: packet to analyse
+ * @hdr_size: size of the possible header before the ethernet header in the skb
+ * @lladdr: set to the link-layer address option of the message on success
+ *
+ * Only messages DAT can make use of are accepted: multicast neighbor
+ * solicitations carrying a source link-layer address option and neighbor
+ * advertisements carrying a target link-layer address option. Messages with
+ * IPv6 extension headers, duplicate address detection probes and unicast
+ * solicitations (used for neighbor unreachability detection) are ignored.
+ *
+ * Return: NDISC_NEIGHBOUR_SOLICITATION or NDISC_NEIGHBOUR_ADVERTISEMENT if the
+ * skb contains a valid message, 0 otherwise.
+ */
+static u8 batadv_nd_get_type(struct batadv_priv *bat_priv,
+			     struct sk_buff *skb, int hdr_size, u8 **lladdr)
+{
+	struct nd_opt_hdr *nd_opt;
+	struct ipv6hdr *ip6hdr;
+	struct ethhdr *ethhdr;
+	struct nd_msg *msg;
+	u8 *opt_lladdr = NULL;
+	int opt_len, opts_len;
+	u8 opt_type, type = 0;
+	u16 payload_len;
+
+	if (unlikely(!pskb_may_pull(skb, hdr_size + ETH_HLEN +
+				    sizeof(*ip6hdr))))
+		goto out;
+
+	ethhdr = (struct ethhdr *)(skb->data + hdr_size);
+
+	if (ethhdr->h_proto != htons(ETH_P_IPV6))
+		goto out;
+
+	ip6hdr = batadv_nd_ip6hdr(skb, hdr_size);
+	if (ip6hdr->version != 6 || ip6hdr->nexthdr != IPPROTO_ICMPV6)
+		goto out;
+
+	/* neighbor discovery messages never cross a router */
+	if (ip6hdr->hop_limit != 255)
+		goto out;
+
+	payload_len = ntohs(ip6hdr->payload_len);
+	if (payload_len < sizeof(*msg))
+		goto out;
+
+	/* pull the whole ICMPv6 message including its options */
+	if (unlikely(!pskb_may_pull(skb, hdr_size + ETH_HLEN +
+				    sizeof(*ip6hdr) + payload_len)))
+		goto out;
+
+	ip6hdr = batadv_nd_ip6hdr(skb, hdr_size);
+	msg = batadv_nd_msg(skb, hdr_size);
+
+	if (msg->icmph.icmp6_code != 0)
+		goto out;
+
+	switch (msg->icmph.icmp6_type) {
+	case NDISC_NEIGHBOUR_SOLICITATION:
+		if (!ipv6_addr_is_multicast(&ip6hdr->daddr))
+			goto out;
+
+		opt_type = ND_OPT_SOURCE_LL_ADDR;
+		break;
+	case NDISC_NEIGHBOUR_ADVERTISEMENT:
+		opt_type = ND_OPT_TARGET_LL_ADDR;
+		break;
+	default:
+		goto out;
+	}
+
+	/* Check for bad solicitations/advertisements. If the message is not
+	 * sane, DAT will simply ignore it
+	 */
+	if (ipv6_addr_any(&ip6hdr->saddr) ||
+	    ipv6_addr_is_multicast(&ip6hdr->saddr) ||
+	    ipv6_addr_loopback(&ip6hdr->saddr) ||
+	    ipv6_addr_any(&msg->target) ||
+	    ipv6_addr_is_multicast(&msg->target) ||
+	    ipv6_addr_loopback(&msg->target))
+		goto out;
+
+	nd_opt = (struct nd_opt_hdr *)msg->opt;
+	opts_len = payload_len - sizeof(*msg);
+	while (opts_len >= (int)sizeof(*nd_opt)) {
+		opt_len = nd_opt->nd_opt_len << 3;
+		if (opt_len == 0 || opt_len > opts_len)
+			goto out;
+
+		/* ethernet link-layer address options are 8 bytes long */
+		if (nd_opt->nd_opt_type == opt_type &&
+		    opt_len == sizeof(*nd_opt) + ETH_ALEN)
+			opt_lladdr = (u8 *)(nd_opt + 1);
+
+		nd_opt = (struct nd_opt_hdr *)((u8 *)nd_opt + opt_len);
+		opts_len -= opt_len;
+	}
+
+	if (!opt_lladdr || is_zero_ether_addr(opt_lladdr) ||
+	    is_multicast_ether_addr(opt_lladdr))
+		goto out;
+
+	*lladdr = opt_lladdr;
+	type = msg->icmph.icmp6_type;
+out:
+	return type;
+}
+
+/**
+ * batadv_nd_create_na - create a neighbor advertisement on behalf of a node
+ * @bat_priv: the bat priv with all the soft interface information
+ * @target: the IPv6 address being advertised
+ * @daddr: the IPv6 address of the soliciting node
+ * @hw_src: the mac address of the owner of @target
+ * @hw_dst: the mac address of the soliciting node
+ * @router: value of the router flag of the advertisement
+ *
+ * Return: the newly created advertisement (including its ethernet header) or
+ * NULL in case of allocation failure.
+ */
+static struct sk_buff *batadv_nd_create_na(struct batadv_priv *bat_priv,
+					   const struct in6_addr *target,
+					   const struct in6_addr *daddr,
+					   const u8 *hw_src, const u8 *hw_dst,
+					   bool router)
+{
+	struct net_device *soft_iface = bat_priv->soft_iface;
+	struct nd_opt_hdr *nd_opt;
+	struct ipv6hdr *ip6hdr;
+	struct ethhdr *ethhdr;
+	struct sk_buff *skb;
+	struct nd_msg *msg;
+	int len;
+
+	len = sizeof(*msg) + sizeof(*nd_opt) + ETH_ALEN;
+
+	skb = alloc_skb(LL_RESERVED_SPACE(soft_iface) + sizeof(*ip6hdr) + len +
+			soft_iface->needed_tailroom, GFP_ATOMIC);
+	if (!skb)
+		return NULL;
+
+	skb_reserve(skb, LL_RESERVED_SPACE(soft_iface));
+	skb_reset_network_header(skb);
+
+	ip6hdr = (struct ipv6hdr *)skb_put(skb, sizeof(*ip6hdr));
+	memset(ip6hdr, 0, sizeof(*ip6hdr));
+	ip6hdr->version = 6;
+	ip6hdr->payload_len = htons(len);
+	ip6hdr->nexthdr = IPPROTO_ICMPV6;
+	ip6hdr->hop_limit = 255;
+	ip6hdr->saddr = *target;
+	ip6hdr->daddr = *daddr;
+
+	msg = (struct nd_msg *)skb_put(skb, len);
+	memset(msg, 0, len);
+	msg->icmph.icmp6_type = NDISC_NEIGHBOUR_ADVERTISEMENT;
+	msg->icmph.icmp6_router = router;
+	msg->icmph.icmp6_solicited = 1;
+	msg->icmph.icmp6_override = 1;
+	msg->target = *target;
+
+	nd_opt = (struct nd_opt_hdr *)msg->opt;
+	nd_opt->nd_opt_type = ND_OPT_TARGET_LL_ADDR;
+	nd_opt->nd_opt_len = (sizeof(*nd_opt) + ETH_ALEN) >> 3;
+	ether_addr_copy((u8 *)(nd_opt + 1), hw_src);
+
+	msg->icmph.icmp6_cksum = csum_ipv6_magic(target, daddr, len,
+						 IPPROTO_ICMPV6,
+						 csum_partial(msg, len, 0));
+
+	ethhdr = (struct ethhdr *)skb_push(skb, ETH_HLEN);
+	ether_addr_copy(ethhdr->h_dest, hw_dst);
+	ether_addr_copy(ethhdr->h_source, hw_src);
+	ethhdr->h_proto = htons(ETH_P_IPV6);
+
+	skb->dev = soft_iface;
+	skb->protocol = htons(ETH_P_IPV6);
+
+	return skb;
+}
+
+/**
+ * batadv_dat_entry6_set_router - store the router flag of an IPv6 neighbor
+ * @bat_priv: the bat priv with all the soft interface information
+ * @ip6: the IPv6 address of the neighbor
+ * @vid: VLAN identifier
+ * @router: router flag of the last advertisement of the neighbor
+ */
+static void batadv_dat_entry6_set_router(struct batadv_priv *bat_priv,
+					 const struct in6_addr *ip6,
+					 unsigned short vid, bool router)
+{
+	struct batadv_dat_entry *dat_entry;
+
+	dat_entry = batadv_dat_entry6_hash_find(bat_priv, ip6, vid);
+	if (!dat_entry)
+		return;
+
+	dat_entry->router = router;
+	batadv_dat_entry_put(dat_entry);
+}
+
+/**
+ * batadv_dat_entry_refresh - ask the DHT for a fresh copy of an entry
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the ARP request or neighbor solicitation of a local client answered
+ *  from @dat_entry
+ * @dat_entry: the cache entry about to expire
+ *
+ * Requests answered from the local cache never reach the owner of the address,
+ * hence a hot entry is not refreshed by its own traffic and eventually expires.
+ * Once the entry has entered the last BATADV_DAT_REFRESH_WINDOW of its
+ * lifetime the request is additionally sent to the DHT, so that the reply
+ * updates the entry in the background before the clients notice.
+ */
+static void batadv_dat_entry_refresh(struct batadv_priv *bat_priv,
+				     struct sk_buff *skb,
+				     struct batadv_dat_entry *dat_entry)
+{
+	if (!batadv_has_timed_out(dat_entry->last_update,
+				  BATADV_DAT_ENTRY_TIMEOUT -
+				  BATADV_DAT_REFRESH_WINDOW))
+		return;
+
+	if (!batadv_has_timed_out(dat_entry->last_refresh,
+				  BATADV_DAT_REFRESH_INTERVAL))
+		return;
+
+	dat_entry->last_refresh = jiffies;
+
+	batadv_dat_dbg_entry(bat_priv, "Entry refresh", dat_entry);
+
+	if (__batadv_dat_send_data(bat_priv, skb, dat_entry,
+				   BATADV_P_DAT_DHT_GET))
+		batadv_inc_counter(bat_priv, BATADV_CNT_DAT_CACHE_REFRESH);
+}
+
+/**
+ * batadv_dat_snoop_outgoing_arp_request - snoop the ARP request and try to
+ * answer using DAT
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: packet to check
+ *
+ * Return: true if the message has been sent to the dht candidates, false
+ * otherwise. In case of a positive return value the message has to be enqueued
+ * to permit the fallback.
+ */
+bool batadv_dat_snoop_outgoing_arp_request(struct batadv_priv *bat_priv,
+					   struct sk_buff *skb)
+{
+	u16 type = 0;
+	__be32 ip_dst, ip_src;
+	u8 *hw_src;
+	bool ret = false;
+	struct batadv_dat_entry *dat_entry = NULL;
+	struct sk_buff *skb_new;
+	int hdr_size = 0;
+	unsigned short vid;
+
+	if (!atomic_read(&bat_priv->distributed_arp_table))
+		goto out;
 
 	vid = batadv_dat_get_vid(skb, &hdr_size);
 
@@ -1000,6 +1724,8 @@ bool batadv_dat_snoop_outgoing_arp_request(struct batadv_priv *bat_priv,
 			goto out;
 		}
 
+		batadv_dat_entry_refresh(bat_priv, skb, dat_entry);
+
 		skb_new = arp_create(ARPOP_REPLY, ETH_P_ARP, ip_src,
 				     bat_priv->soft_iface, ip_dst, hw_src,
 				     dat_entry->mac_addr, hw_src);
@@ -1212,6 +1938,305 @@ out:
 	return dropped;
 }
 
+/**
+ * batadv_dat_snoop_outgoing_nd_request - snoop the neighbor solicitation and
+ * try to answer using DAT
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: packet to check
+ *
+ * Return: true if the message has been sent to the dht candidates or answered
+ * locally, false otherwise. In case of a positive return value the message has
+ * to be enqueued to permit the fallback.
+ */
+bool batadv_dat_snoop_outgoing_nd_request(struct batadv_priv *bat_priv,
+					  struct sk_buff *skb)
+{
+	struct batadv_dat_entry *dat_entry = NULL;
+	struct ipv6hdr *ip6hdr;
+	struct sk_buff *skb_new;
+	struct nd_msg *msg;
+	int hdr_size = 0;
+	unsigned short vid;
+	bool ret = false;
+	u8 *hw_src;
+
+	if (!atomic_read(&bat_priv->distributed_arp_table))
+		goto out;
+
+	vid = batadv_dat_get_vid(skb, &hdr_size);
+
+	if (batadv_nd_get_type(bat_priv, skb, hdr_size, &hw_src) !=
+	    NDISC_NEIGHBOUR_SOLICITATION)
+		goto out;
+
+	ip6hdr = batadv_nd_ip6hdr(skb, hdr_size);
+	msg = batadv_nd_msg(skb, hdr_size);
+
+	batadv_dbg(BATADV_DBG_DAT, bat_priv,
+		   "Parsing outgoing NS: %pI6c asks for %pI6c\n",
+		   &ip6hdr->saddr, &msg->target);
+
+	batadv_dat_entry6_add(bat_priv, &ip6hdr->saddr, hw_src, vid);
+
+	dat_entry = batadv_dat_entry6_hash_find(bat_priv, &msg->target, vid);
+	if (dat_entry) {
+		/* the local client owning the address answers by itself */
+		if (batadv_is_my_client(bat_priv, dat_entry->mac_addr, vid)) {
+			ret = true;
+			goto out;
+		}
+
+		batadv_dat_entry_refresh(bat_priv, skb, dat_entry);
+
+		skb_new = batadv_nd_create_na(bat_priv, &msg->target,
+					      &ip6hdr->saddr,
+					      dat_entry->mac_addr, hw_src,
+					      dat_entry->router);
+		if (!skb_new)
+			goto out;
+
+		if (vid & BATADV_VLAN_HAS_TAG)
+			skb_new = vlan_insert_tag(skb_new, htons(ETH_P_8021Q),
+						  vid & VLAN_VID_MASK);
+
+		skb_reset_mac_header(skb_new);
+		skb_new->protocol = eth_type_trans(skb_new,
+						   bat_priv->soft_iface);
+		bat_priv->stats.rx_packets++;
+		bat_priv->stats.rx_bytes += skb->len + ETH_HLEN + hdr_size;
+		bat_priv->soft_iface->last_rx = jiffies;
+
+		netif_rx(skb_new);
+		batadv_inc_counter(bat_priv, BATADV_CNT_DAT_ND_CACHE_HIT);
+		batadv_dbg(BATADV_DBG_DAT, bat_priv, "NS replied locally\n");
+		ret = true;
+	} else {
+		batadv_inc_counter(bat_priv, BATADV_CNT_DAT_ND_CACHE_MISS);
+
+		/* Send the solicitation to the DHT */
+		ret = batadv_dat_send_data6(bat_priv, skb, &msg->target,
+					    BATADV_P_DAT_DHT_GET);
+	}
+out:
+	if (dat_entry)
+		batadv_dat_entry_put(dat_entry);
+	return ret;
+}
+
+/**
+ * batadv_dat_snoop_incoming_nd_request - snoop the neighbor solicitation and
+ * try to answer using the local DAT storage
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: packet to check
+ * @hdr_size: size of the encapsulation header
+ *
+ * Return: true if the request has been answered, false otherwise.
+ */
+bool batadv_dat_snoop_incoming_nd_request(struct batadv_priv *bat_priv,
+					  struct sk_buff *skb, int hdr_size)
+{
+	struct batadv_dat_entry *dat_entry = NULL;
+	struct ipv6hdr *ip6hdr;
+	struct sk_buff *skb_new;
+	struct nd_msg *msg;
+	unsigned short vid;
+	bool ret = false;
+	u8 *hw_src;
+	int err;
+
+	if (!atomic_read(&bat_priv->distributed_arp_table))
+		goto out;
+
+	vid = batadv_dat_get_vid(skb, &hdr_size);
+
+	if (batadv_nd_get_type(bat_priv, skb, hdr_size, &hw_src) !=
+	    NDISC_NEIGHBOUR_SOLICITATION)
+		goto out;
+
+	ip6hdr = batadv_nd_ip6hdr(skb, hdr_size);
+	msg = batadv_nd_msg(skb, hdr_size);
+
+	batadv_dbg(BATADV_DBG_DAT, bat_priv,
+		   "Parsing incoming NS: %pI6c asks for %pI6c\n",
+		   &ip6hdr->saddr, &msg->target);
+
+	batadv_dat_entry6_add(bat_priv, &ip6hdr->saddr, hw_src, vid);
+
+	dat_entry = batadv_dat_entry6_hash_find(bat_priv, &msg->target, vid);
+	if (!dat_entry)
+		goto out;
+
+	skb_new = batadv_nd_create_na(bat_priv, &msg->target, &ip6hdr->saddr,
+				      dat_entry->mac_addr, hw_src,
+				      dat_entry->router);
+	if (!skb_new)
+		goto out;
+
+	/* the rest of the TX path assumes that the mac_header offset pointing
+	 * to the inner Ethernet header has been set, therefore reset it now.
+	 */
+	skb_reset_mac_header(skb_new);
+
+	if (vid & BATADV_VLAN_HAS_TAG)
+		skb_new = vlan_insert_tag(skb_new, htons(ETH_P_8021Q),
+					  vid & VLAN_VID_MASK);
+
+	/* see batadv_dat_snoop_incoming_arp_request() */
+	if (hdr_size == sizeof(struct batadv_unicast_4addr_packet))
+		err = batadv_send_skb_via_tt_4addr(bat_priv, skb_new,
+						   BATADV_P_DAT_CACHE_REPLY,
+						   NULL, vid);
+	else
+		err = batadv_send_skb_via_tt(bat_priv, skb_new, NULL, vid);
+
+	if (err != NET_XMIT_DROP) {
+		batadv_inc_counter(bat_priv, BATADV_CNT_DAT_CACHED_REPLY_TX);
+		ret = true;
+	}
+out:
+	if (dat_entry)
+		batadv_dat_entry_put(dat_entry);
+	if (ret)
+		kfree_skb(skb);
+	return ret;
+}
+
+/**
+ * batadv_dat_snoop_outgoing_nd_reply - snoop the neighbor advertisement and
+ * fill the DHT
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: packet to check
+ */
+void batadv_dat_snoop_outgoing_nd_reply(struct batadv_priv *bat_priv,
+					struct sk_buff *skb)
+{
+	struct nd_msg *msg;
+	int hdr_size = 0;
+	unsigned short vid;
+	u8 *hw_src;
+
+	if (!atomic_read(&bat_priv->distributed_arp_table))
+		return;
+
+	vid = batadv_dat_get_vid(skb, &hdr_size);
+
+	if (batadv_nd_get_type(bat_priv, skb, hdr_size, &hw_src) !=
+	    NDISC_NEIGHBOUR_ADVERTISEMENT)
+		return;
+
+	msg = batadv_nd_msg(skb, hdr_size);
+
+	batadv_dbg(BATADV_DBG_DAT, bat_priv,
+		   "Parsing outgoing NA: %pI6c is at %pM\n", &msg->target,
+		   hw_src);
+
+	batadv_dat_entry6_add(bat_priv, &msg->target, hw_src, vid);
+	batadv_dat_entry6_set_router(bat_priv, &msg->target, vid,
+				     msg->icmph.icmp6_router);
+
+	/* Send the advertisement to the candidates of the advertised address */
+	batadv_dat_send_data6(bat_priv, skb, &msg->target,
+			      BATADV_P_DAT_DHT_PUT);
+}
+
+/**
+ * batadv_dat_snoop_incoming_nd_reply - snoop the neighbor advertisement and
+ * fill the local DAT storage only
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: packet to check
+ * @hdr_size: size of the encapsulation header
+ *
+ * Return: true if the packet was snooped and consumed by DAT. False if the
+ * packet has to be delivered to the interface
+ */
+bool batadv_dat_snoop_incoming_nd_reply(struct batadv_priv *bat_priv,
+					struct sk_buff *skb, int hdr_size)
+{
+	struct ethhdr *ethhdr;
+	struct nd_msg *msg;
+	bool dropped = false;
+	int eth_offset = hdr_size;
+	unsigned short vid;
+	u8 *hw_src;
+
+	if (!atomic_read(&bat_priv->distributed_arp_table))
+		goto out;
+
+	vid = batadv_dat_get_vid(skb, &hdr_size);
+
+	if (batadv_nd_get_type(bat_priv, skb, hdr_size, &hw_src) !=
+	    NDISC_NEIGHBOUR_ADVERTISEMENT)
+		goto out;
+
+	msg = batadv_nd_msg(skb, hdr_size);
+
+	batadv_dbg(BATADV_DBG_DAT, bat_priv,
+		   "Parsing incoming NA: %pI6c is at %pM\n", &msg->target,
+		   hw_src);
+
+	batadv_dat_entry6_add(bat_priv, &msg->target, hw_src, vid);
+	batadv_dat_entry6_set_router(bat_priv, &msg->target, vid,
+				     msg->icmph.icmp6_router);
+
+	/* unsolicited advertisements are meant for everyone */
+	ethhdr = (struct ethhdr *)(skb->data + eth_offset);
+	if (is_multicast_ether_addr(ethhdr->h_dest))
+		goto out;
+
+	/* if this advertisement is directed to a client of mine, let's deliver
+	 * the packet to the interface
+	 */
+	dropped = !batadv_is_my_client(bat_priv, ethhdr->h_dest, vid);
+
+	/* if this advertisement is sent on behalf of a client of mine, let's
+	 * drop the packet because the client will reply by itself
+	 */
+	dropped |= batadv_is_my_client(bat_priv, hw_src, vid);
+out:
+	if (dropped)
+		kfree_skb(skb);
+	/* if dropped == false -> deliver to the interface */
+	return dropped;
+}
+
+/**
+ * batadv_dat_nd_request_resolved - check whether a broadcast neighbor
+ * solicitation can be dropped because its answer is already known
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the broadcast packet
+ * @hdr_size: size of the broadcast header (and the possible VLAN header)
+ * @vid: VLAN identifier of the packet
+ *
+ * Return: true if the solicited address is in the local DAT storage, false
+ * otherwise.
+ */
+static bool batadv_dat_nd_request_resolved(struct batadv_priv *bat_priv,
+					   struct sk_buff *skb, int hdr_size,
+					   unsigned short vid)
+{
+	struct batadv_dat_entry *dat_entry;
+	struct nd_msg *msg;
+	u8 *hw_src;
+
+	if (batadv_nd_get_type(bat_priv, skb, hdr_size, &hw_src) !=
+	    NDISC_NEIGHBOUR_SOLICITATION)
+		return false;
+
+	msg = batadv_nd_msg(skb, hdr_size);
+	dat_entry = batadv_dat_entry6_hash_find(bat_priv, &msg->target, vid);
+	if (!dat_entry) {
+		batadv_dbg(BATADV_DBG_DAT, bat_priv,
+			   "NS for %pI6c: fallback\n", &msg->target);
+		return false;
+	}
+
+	batadv_dbg(BATADV_DBG_DAT, bat_priv,
+		   "NS for %pI6c: fallback prevented\n", &msg->target);
+	batadv_dat_entry_put(dat_entry);
+
+	return true;
+}
+
 /**
  * batadv_dat_drop_broadcast_packet - check if an ARP request has to be dropped
  * (because the node has already obtained the reply via DAT) or not
@@ -1233,8 +2258,9 @@ bool batadv_dat_drop_broadcast_packet(struct batadv_priv *bat_priv,
 	if (!atomic_read(&bat_priv->distributed_arp_table))
 		goto out;
 
-	/* If this packet is an ARP_REQUEST and the node already has the
-	 * information that it is going to ask, then the packet can be dropped
+	/* If this packet is an ARP_REQUEST (or a neighbor solicitation) and the
+	 * node already has the information that it is going to ask, then the
+	 * packet can be dropped
 	 */
 	if (forw_packet->num_packets)
 		goto out;
@@ -1242,8 +2268,11 @@ bool batadv_dat_drop_broadcast_packet(struct batadv_priv *bat_priv,
 	vid = batadv_dat_get_vid(forw_packet->skb, &hdr_size);
 
 	type = batadv_arp_get_type(bat_priv, forw_packet->skb, hdr_size);
-	if (type != ARPOP_REQUEST)
+	if (type != ARPOP_REQUEST) {
+		ret = batadv_dat_nd_request_resolved(bat_priv, forw_packet->skb,
+						     hdr_size, vid);
 		goto out;
+	}
 
 	ip_dst = batadv_arp_ip_dst(forw_packet->skb, hdr_size);
 	dat_entry = batadv_dat_entry_hash_find(bat_priv, ip_dst, vid);
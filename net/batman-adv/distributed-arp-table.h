@@ -21,12 +21,14 @@
 #include "main.h"
 
 #include <linux/compiler.h>
+#include <linux/errno.h>
 #include <linux/netdevice.h>
 #include <linux/types.h>
 
 #include "originator.h"
 #include "packet.h"
 
+struct netlink_callback;
 struct seq_file;
 struct sk_buff;
 
@@ -36,6 +38,7 @@ struct sk_buff;
 #define BATADV_DAT_ADDR_MAX ((batadv_dat_addr_t)~(batadv_dat_addr_t)0)
 
 void batadv_dat_status_update(struct net_device *net_dev);
+void batadv_dat_max_entries_update(struct net_device *net_dev);
 bool batadv_dat_snoop_outgoing_arp_request(struct batadv_priv *bat_priv,
 					   struct sk_buff *skb);
 bool batadv_dat_snoop_incoming_arp_request(struct batadv_priv *bat_priv,
@@ -44,6 +47,14 @@ void batadv_dat_snoop_outgoing_arp_reply(struct batadv_priv *bat_priv,
 					 struct sk_buff *skb);
 bool batadv_dat_snoop_incoming_arp_reply(struct batadv_priv *bat_priv,
 					 struct sk_buff *skb, int hdr_size);
+bool batadv_dat_snoop_outgoing_nd_request(struct batadv_priv *bat_priv,
+					  struct sk_buff *skb);
+bool batadv_dat_snoop_incoming_nd_request(struct batadv_priv *bat_priv,
+					  struct sk_buff *skb, int hdr_size);
+void batadv_dat_snoop_outgoing_nd_reply(struct batadv_priv *bat_priv,
+					struct sk_buff *skb);
+bool batadv_dat_snoop_incoming_nd_reply(struct batadv_priv *bat_priv,
+					struct sk_buff *skb, int hdr_size);
 bool batadv_dat_drop_broadcast_packet(struct batadv_priv *bat_priv,
 				      struct batadv_forw_packet *forw_packet);
 
@@ -80,6 +91,9 @@ batadv_dat_init_own_addr(struct batadv_priv *bat_priv,
 int batadv_dat_init(struct batadv_priv *bat_priv);
 void batadv_dat_free(struct batadv_priv *bat_priv);
 int batadv_dat_cache_seq_print_text(struct seq_file *seq, void *offset);
+int batadv_dat_cache_dump(struct sk_buff *msg, struct netlink_callback *cb,
+			  struct batadv_priv *bat_priv,
+			  const struct batadv_netlink_filter *filter);
 
 /**
  * batadv_dat_inc_counter - increment the correct DAT packet counter
@@ -137,6 +151,33 @@ batadv_dat_snoop_incoming_arp_reply(struct batadv_priv *bat_priv,
 	return false;
 }
 
+static inline bool
+batadv_dat_snoop_outgoing_nd_request(struct batadv_priv *bat_priv,
+				     struct sk_buff *skb)
+{
+	return false;
+}
+
+static inline bool
+batadv_dat_snoop_incoming_nd_request(struct batadv_priv *bat_priv,
+				     struct sk_buff *skb, int hdr_size)
+{
+	return false;
+}
+
+static inline void
+batadv_dat_snoop_outgoing_nd_reply(struct batadv_priv *bat_priv,
+				   struct sk_buff *skb)
+{
+}
+
+static inline bool
+batadv_dat_snoop_incoming_nd_reply(struct batadv_priv *bat_priv,
+				   struct sk_buff *skb, int hdr_size)
+{
+	return false;
+}
+
 static inline bool
 batadv_dat_drop_broadcast_packet(struct batadv_priv *bat_priv,
 				 struct batadv_forw_packet *forw_packet)
@@ -168,6 +209,14 @@ static inline void batadv_dat_free(struct batadv_priv *bat_priv)
 {
 }
 
+static inline int
+batadv_dat_cache_dump(struct sk_buff *msg, struct netlink_callback *cb,
+		      struct batadv_priv *bat_priv,
+		      const struct batadv_netlink_filter *filter)
+{
+	return -EOPNOTSUPP;
+}
+
 static inline void batadv_dat_inc_counter(struct batadv_priv *bat_priv,
 					  u8 subtype)
 {
@@ -31,6 +31,7 @@
 #include <linux/kref.h>
 #include <linux/list.h>
 #include <linux/netdevice.h>
+#include <linux/netlink.h>
 #include <linux/rculist.h>
 #include <linux/rcupdate.h>
 #include <linux/seq_file.h>
@@ -39,9 +40,13 @@
 #include <linux/spinlock.h>
 #include <linux/stddef.h>
 #include <linux/udp.h>
+#include <net/genetlink.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "gateway_common.h"
 #include "hard-interface.h"
+#include "netlink.h"
 #include "originator.h"
 #include "packet.h"
 #include "routing.h"
@@ -666,6 +671,116 @@ out:
 	return 0;
 }
 
+/**
+ * batadv_gw_dump_entry - add a gateway to a netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @gw_node: the gateway to add
+ * @curr_gw: the currently selected gateway (may be NULL)
+ *
+ * Gateways without a router are skipped like in the debugfs table.
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int batadv_gw_dump_entry(struct sk_buff *msg,
+				struct netlink_callback *cb,
+				struct batadv_priv *bat_priv,
+				struct batadv_gw_node *gw_node,
+				struct batadv_gw_node *curr_gw)
+{
+	struct batadv_algo_ops *bao = bat_priv->bat_algo_ops;
+	struct batadv_neigh_node *router;
+	struct net_device *net_dev;
+	void *hdr;
+	int ret = 0;
+
+	router = batadv_orig_router_get(gw_node->orig_node, BATADV_IF_DEFAULT);
+	if (!router)
+		return 0;
+
+	net_dev = router->if_incoming->net_dev;
+
+	hdr = batadv_netlink_hdr_put(msg, cb, BATADV_CMD_GET_GATEWAYS);
+	if (!hdr) {
+		ret = -EMSGSIZE;
+		goto out;
+	}
+
+	if (nla_put(msg, BATADV_ATTR_ORIG_ADDRESS, ETH_ALEN,
+		    gw_node->orig_node->orig) ||
+	    nla_put(msg, BATADV_ATTR_ROUTER, ETH_ALEN, router->addr) ||
+	    nla_put_u32(msg, BATADV_ATTR_HARD_IFINDEX, net_dev->ifindex) ||
+	    nla_put_u32(msg, BATADV_ATTR_BANDWIDTH_DOWN,
+			gw_node->bandwidth_down) ||
+	    nla_put_u32(msg, BATADV_ATTR_BANDWIDTH_UP, gw_node->bandwidth_up))
+		goto nla_put_failure;
+
+	if (bao->bat_neigh_dump_metric &&
+	    bao->bat_neigh_dump_metric(msg, router, BATADV_IF_DEFAULT))
+		goto nla_put_failure;
+
+	if (curr_gw == gw_node && nla_put_flag(msg, BATADV_ATTR_FLAG_BEST))
+		goto nla_put_failure;
+
+	genlmsg_end(msg, hdr);
+	goto out;
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	ret = -EMSGSIZE;
+out:
+	batadv_neigh_node_put(router);
+	return ret;
+}
+
+/**
+ * batadv_gw_dump - dump the list of gateways to a netlink socket
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @filter: filter of the dump request (only the originator is evaluated)
+ *
+ * Return: always 0 - the dump position is kept in cb->args
+ */
+int batadv_gw_dump(struct sk_buff *msg, struct netlink_callback *cb,
+		   struct batadv_priv *bat_priv,
+		   const struct batadv_netlink_filter *filter)
+{
+	struct batadv_gw_node *gw_node, *curr_gw;
+	int idx_s = cb->args[0];
+	int idx = 0;
+
+	curr_gw = batadv_gw_get_selected_gw_node(bat_priv);
+
+	rcu_read_lock();
+	hlist_for_each_entry_rcu(gw_node, &bat_priv->gw.list, list) {
+		if (idx++ < idx_s)
+			continue;
+
+		if (filter->orig_set &&
+		    !batadv_compare_eth(gw_node->orig_node->orig, filter->orig))
+			continue;
+
+		if (batadv_gw_dump_entry(msg, cb, bat_priv, gw_node,
+					 curr_gw)) {
+			idx_s = idx - 1;
+			goto unlock;
+		}
+	}
+	idx_s = idx;
+
+unlock:
+	rcu_read_unlock();
+
+	cb->args[0] = idx_s;
+
+	if (curr_gw)
+		batadv_gw_node_put(curr_gw);
+
+	return 0;
+}
+
 /**
  * batadv_gw_dhcp_recipient_get - check if a packet is a DHCP message
  * @skb: the packet to check
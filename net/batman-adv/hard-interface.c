@@ -22,6 +22,7 @@
 #include <linux/bug.h>
 #include <linux/byteorder/generic.h>
 #include <linux/errno.h>
+#include <linux/etherdevice.h>
 #include <linux/fs.h>
 #include <linux/if_arp.h>
 #include <linux/if_ether.h>
@@ -83,26 +84,56 @@ out:
 	return hard_iface;
 }
 
+/**
+ * batadv_getlink_net - return the net namespace of the parent of a device
+ * @netdev: net_device to check
+ * @fallback_net: returned in case get_link_net is not available for @netdev
+ *
+ * Return: result of rtnl_link_ops->get_link_net or @fallback_net
+ */
+static const struct net *batadv_getlink_net(const struct net_device *netdev,
+					    const struct net *fallback_net)
+{
+	if (!netdev->rtnl_link_ops)
+		return fallback_net;
+
+	if (!netdev->rtnl_link_ops->get_link_net)
+		return fallback_net;
+
+	return netdev->rtnl_link_ops->get_link_net(netdev);
+}
+
 /**
  * batadv_mutual_parents - check if two devices are each others parent
  * @dev1: 1st net_device
+ * @net1: 1st devices netns
  * @dev2: 2nd net_device
+ * @net2: 2nd devices netns
  *
  * veth devices come in pairs and each is the parent of the other!
  *
  * Return: true if the devices are each others parent, otherwise false
  */
 static bool batadv_mutual_parents(const struct net_device *dev1,
-				  const struct net_device *dev2)
+				  const struct net *net1,
+				  const struct net_device *dev2,
+				  const struct net *net2)
 {
 	int dev1_parent_iflink = dev_get_iflink(dev1);
 	int dev2_parent_iflink = dev_get_iflink(dev2);
+	const struct net *dev1_parent_net;
+	const struct net *dev2_parent_net;
+
+	dev1_parent_net = batadv_getlink_net(dev1, net1);
+	dev2_parent_net = batadv_getlink_net(dev2, net2);
 
 	if (!dev1_parent_iflink || !dev2_parent_iflink)
 		return false;
 
 	return (dev1_parent_iflink == dev2->ifindex) &&
-	       (dev2_parent_iflink == dev1->ifindex);
+	       (dev2_parent_iflink == dev1->ifindex) &&
+	       net_eq(dev1_parent_net, net2) &&
+	       net_eq(dev2_parent_net, net1);
 }
 
 /**
@@ -120,7 +151,9 @@ static bool batadv_mutual_parents(const struct net_device *dev1,
  */
 static bool batadv_is_on_batman_iface(const struct net_device *net_dev)
 {
+	struct net *net = dev_net(net_dev);
 	struct net_device *parent_dev;
+	const struct net *parent_net;
 	bool ret;
 
 	/* check if this is a batman-adv mesh interface */
@@ -132,13 +165,16 @@ static bool batadv_is_on_batman_iface(const struct net_device *net_dev)
 	    dev_get_iflink(net_dev) == net_dev->ifindex)
 		return false;
 
+	parent_net = batadv_getlink_net(net_dev, net);
+
 	/* recurse over the parent device */
-	parent_dev = __dev_get_by_index(&init_net, dev_get_iflink(net_dev));
+	parent_dev = __dev_get_by_index((struct net *)parent_net,
+					dev_get_iflink(net_dev));
 	/* if we got a NULL parent_dev there is something broken.. */
 	if (WARN(!parent_dev, "Cannot find parent device"))
 		return false;
 
-	if (batadv_mutual_parents(net_dev, parent_dev))
+	if (batadv_mutual_parents(net_dev, net, parent_dev, parent_net))
 		return false;
 
 	ret = batadv_is_on_batman_iface(parent_dev);
@@ -381,6 +417,99 @@ void batadv_update_min_mtu(struct net_device *soft_iface)
 	batadv_tt_local_resize_to_mtu(soft_iface);
 }
 
+/**
+ * batadv_hardif_array_prune - clear the entries of hard-interfaces which left
+ *  the mesh interface in the current array
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Used when a new array cannot be allocated. The entries are cleared in place
+ * and skipped by the readers, the hard-interfaces themselves are only freed
+ * after an RCU grace period.
+ */
+static void batadv_hardif_array_prune(struct batadv_priv *bat_priv)
+{
+	struct batadv_hardif_array_entry *entry;
+	struct batadv_hardif_array *array;
+	unsigned int i;
+
+	array = rcu_dereference_protected(bat_priv->hardif_array, 1);
+	for (i = 0; array && i < array->num; i++) {
+		entry = &array->ifaces[i];
+		if (!entry->hard_iface)
+			continue;
+
+		if (entry->hard_iface->if_status != BATADV_IF_NOT_IN_USE)
+			continue;
+
+		ACCESS_ONCE(entry->hard_iface) = NULL;
+	}
+}
+
+/**
+ * batadv_hardif_array_update - rebuild the array of hard-interfaces assigned
+ *  to a mesh interface
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Has to be called with rtnl held each time a hard-interface is assigned to or
+ * removed from the mesh interface and when one of them changes its MAC address.
+ * If the new array cannot be allocated, the current array stays published
+ * with the entries of removed hard-interfaces cleared. Added hard-interfaces
+ * and changed MAC addresses are then only picked up by the next successful
+ * update.
+ *
+ * Return: 0 on success, -ENOMEM otherwise.
+ */
+static int batadv_hardif_array_update(struct batadv_priv *bat_priv)
+{
+	struct batadv_hardif_array *array = NULL, *old_array;
+	struct batadv_hardif_array_entry *entry;
+	struct batadv_hard_iface *hard_iface;
+	unsigned int num = 0;
+
+	ASSERT_RTNL();
+
+	list_for_each_entry(hard_iface, &batadv_hardif_list, list) {
+		if (hard_iface->if_status == BATADV_IF_NOT_IN_USE)
+			continue;
+
+		if (hard_iface->soft_iface != bat_priv->soft_iface)
+			continue;
+
+		num++;
+	}
+
+	if (num == 0)
+		goto publish;
+
+	array = kmalloc(sizeof(*array) + num * sizeof(array->ifaces[0]),
+			GFP_KERNEL);
+	if (!array) {
+		batadv_hardif_array_prune(bat_priv);
+		return -ENOMEM;
+	}
+
+	array->num = 0;
+	list_for_each_entry(hard_iface, &batadv_hardif_list, list) {
+		if (hard_iface->if_status == BATADV_IF_NOT_IN_USE)
+			continue;
+
+		if (hard_iface->soft_iface != bat_priv->soft_iface)
+			continue;
+
+		entry = &array->ifaces[array->num++];
+		entry->hard_iface = hard_iface;
+		ether_addr_copy(entry->addr, hard_iface->net_dev->dev_addr);
+	}
+
+publish:
+	old_array = rcu_dereference_protected(bat_priv->hardif_array, 1);
+	rcu_assign_pointer(bat_priv->hardif_array, array);
+	if (old_array)
+		kfree_rcu(old_array, rcu);
+
+	return 0;
+}
+
 static void
 batadv_hardif_activate_interface(struct batadv_hard_iface *hard_iface)
 {
@@ -459,6 +588,7 @@ int batadv_hardif_enable_interface(struct batadv_hard_iface *hard_iface,
 	struct net_device *soft_iface, *master;
 	__be16 ethertype = htons(ETH_P_BATMAN);
 	int max_header_len = batadv_max_header_len();
+	struct net *net = dev_net(hard_iface->net_dev);
 	int ret;
 
 	if (hard_iface->if_status != BATADV_IF_NOT_IN_USE)
@@ -467,10 +597,10 @@ int batadv_hardif_enable_interface(struct batadv_hard_iface *hard_iface,
 	if (!kref_get_unless_zero(&hard_iface->refcount))
 		goto out;
 
-	soft_iface = dev_get_by_name(&init_net, iface_name);
+	soft_iface = dev_get_by_name(net, iface_name);
 
 	if (!soft_iface) {
-		soft_iface = batadv_softif_create(iface_name);
+		soft_iface = batadv_softif_create(net, iface_name);
 
 		if (!soft_iface) {
 			ret = -ENOMEM;
@@ -504,18 +634,27 @@ int batadv_hardif_enable_interface(struct batadv_hard_iface *hard_iface,
 	if (ret)
 		goto err_dev;
 
+	/* the first own OGM is scheduled with the shortest interval */
+	atomic_set(&hard_iface->ogm_interval,
+		   batadv_ogm_interval_min(bat_priv, hard_iface));
+	hard_iface->ogm_churn_seen = atomic_read(&bat_priv->ogm_churn);
+
 	ret = bat_priv->bat_algo_ops->bat_iface_enable(hard_iface);
 	if (ret < 0)
 		goto err_upper;
 
+	/* the per originator interface state is allocated on demand by the
+	 * routing algorithm, hence the originators are not touched here
+	 */
 	hard_iface->if_num = bat_priv->num_ifaces;
 	bat_priv->num_ifaces++;
 	hard_iface->if_status = BATADV_IF_INACTIVE;
-	ret = batadv_orig_hash_add_if(hard_iface, bat_priv->num_ifaces);
+	ret = batadv_hardif_array_update(bat_priv);
 	if (ret < 0) {
 		bat_priv->bat_algo_ops->bat_iface_disable(hard_iface);
 		bat_priv->num_ifaces--;
 		hard_iface->if_status = BATADV_IF_NOT_IN_USE;
+		batadv_hardif_array_update(bat_priv);
 		goto err_upper;
 	}
 
@@ -598,6 +737,7 @@ void batadv_hardif_disable_interface(struct batadv_hard_iface *hard_iface,
 
 	bat_priv->bat_algo_ops->bat_iface_disable(hard_iface);
 	hard_iface->if_status = BATADV_IF_NOT_IN_USE;
+	batadv_hardif_array_update(bat_priv);
 
 	/* delete all references to this hard_iface */
 	batadv_purge_orig_ref(bat_priv);
@@ -684,6 +824,9 @@ batadv_hardif_add_interface(struct net_device *net_dev)
 	if (batadv_is_wifi_netdev(net_dev))
 		hard_iface->num_bcasts = BATADV_NUM_BCASTS_WIRELESS;
 
+	/* use the orig_interval of the mesh interface */
+	atomic_set(&hard_iface->ogm_interval_min, 0);
+
 	/* extra reference for return */
 	kref_init(&hard_iface->refcount);
 	kref_get(&hard_iface->refcount);
@@ -781,6 +924,7 @@ static int batadv_hard_if_event(struct notifier_block *this,
 
 		bat_priv = netdev_priv(hard_iface->soft_iface);
 		bat_priv->bat_algo_ops->bat_iface_update_mac(hard_iface);
+		batadv_hardif_array_update(bat_priv);
 
 		primary_if = batadv_primary_if_get_selected(bat_priv);
 		if (!primary_if)
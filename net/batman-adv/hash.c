@@ -18,9 +18,13 @@
 #include "hash.h"
 #include "main.h"
 
+#include <linux/bitops.h>
 #include <linux/fs.h>
+#include <linux/kernel.h>
 #include <linux/lockdep.h>
 #include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/vmalloc.h>
 
 /* clears the hash */
 static void batadv_hash_init(struct batadv_hashtable *hash)
@@ -78,3 +82,78 @@ void batadv_hash_set_lock_class(struct batadv_hashtable *hash,
 	for (i = 0; i < hash->size; i++)
 		lockdep_set_class(&hash->list_locks[i], key);
 }
+
+/* allocates an empty bloom filter with 2^bits counters */
+struct batadv_bloom *batadv_bloom_new(u8 bits)
+{
+	struct batadv_bloom *bloom;
+
+	bloom = kmalloc(sizeof(*bloom), GFP_KERNEL);
+	if (!bloom)
+		return NULL;
+
+	bloom->counters = vzalloc(BIT(bits));
+	if (!bloom->counters) {
+		kfree(bloom);
+		return NULL;
+	}
+
+	spin_lock_init(&bloom->lock);
+	bloom->mask = BIT(bits) - 1;
+
+	return bloom;
+}
+
+/* frees the bloom filter */
+void batadv_bloom_destroy(struct batadv_bloom *bloom)
+{
+	if (!bloom)
+		return;
+
+	vfree(bloom->counters);
+	kfree(bloom);
+}
+
+/* account a key which was (or is about to be) added to the hashtable */
+void batadv_bloom_add(struct batadv_bloom *bloom, u32 key_hash)
+{
+	u32 step = ror32(key_hash, 16) | 1;
+	u8 *counter;
+	int i;
+
+	if (!bloom)
+		return;
+
+	spin_lock_bh(&bloom->lock);
+	for (i = 0; i < BATADV_BLOOM_PROBES; i++) {
+		counter = &bloom->counters[key_hash & bloom->mask];
+		if (*counter != U8_MAX)
+			ACCESS_ONCE(*counter) = *counter + 1;
+
+		key_hash += step;
+	}
+	spin_unlock_bh(&bloom->lock);
+}
+
+/* account a key which was removed from the hashtable */
+void batadv_bloom_del(struct batadv_bloom *bloom, u32 key_hash)
+{
+	u32 step = ror32(key_hash, 16) | 1;
+	u8 *counter;
+	int i;
+
+	if (!bloom)
+		return;
+
+	spin_lock_bh(&bloom->lock);
+	for (i = 0; i < BATADV_BLOOM_PROBES; i++) {
+		counter = &bloom->counters[key_hash & bloom->mask];
+
+		/* a saturated counter lost track of its keys */
+		if (*counter != U8_MAX && !WARN_ON(*counter == 0))
+			ACCESS_ONCE(*counter) = *counter - 1;
+
+		key_hash += step;
+	}
+	spin_unlock_bh(&bloom->lock);
+}
@@ -20,6 +20,7 @@
 
 #include "main.h"
 
+#include <linux/bitops.h>
 #include <linux/compiler.h>
 #include <linux/list.h>
 #include <linux/rculist.h>
@@ -51,9 +52,61 @@ struct batadv_hashtable {
 	u32 size;		    /* size of hashtable */
 };
 
+/* counting bloom filter kept next to a hashtable to answer lookups of keys
+ * which are not in the hashtable without touching the buckets. Every key sets
+ * BATADV_BLOOM_PROBES counters which are derived from a 32 bit hash of the key.
+ * Counters saturate and are never decremented again afterwards.
+ */
+struct batadv_bloom {
+	u8 *counters;		    /* BATADV_BLOOM_PROBES counters per key */
+	spinlock_t lock;	    /* serializes counter updates */
+	u32 mask;		    /* number of counters - 1 */
+};
+
+#define BATADV_BLOOM_PROBES 3
+
 /* allocates and clears the hash */
 struct batadv_hashtable *batadv_hash_new(u32 size);
 
+/* allocates an empty bloom filter with 2^bits counters */
+struct batadv_bloom *batadv_bloom_new(u8 bits);
+
+/* frees the bloom filter */
+void batadv_bloom_destroy(struct batadv_bloom *bloom);
+
+/* account a key which was (or is about to be) added to the hashtable */
+void batadv_bloom_add(struct batadv_bloom *bloom, u32 key_hash);
+
+/* account a key which was removed from the hashtable */
+void batadv_bloom_del(struct batadv_bloom *bloom, u32 key_hash);
+
+/**
+ * batadv_bloom_may_contain - check if a key can be in the hashtable
+ * @bloom: bloom filter of the hashtable (may be NULL)
+ * @key_hash: 32 bit hash of the key
+ *
+ * Return: false if the key is definitely not in the hashtable, true if a
+ * lookup is required
+ */
+static inline bool batadv_bloom_may_contain(const struct batadv_bloom *bloom,
+					    u32 key_hash)
+{
+	u32 step = ror32(key_hash, 16) | 1;
+	int i;
+
+	if (!bloom)
+		return true;
+
+	for (i = 0; i < BATADV_BLOOM_PROBES; i++) {
+		if (!ACCESS_ONCE(bloom->counters[key_hash & bloom->mask]))
+			return false;
+
+		key_hash += step;
+	}
+
+	return true;
+}
+
 /* set class key for all locks */
 void batadv_hash_set_lock_class(struct batadv_hashtable *hash,
 				struct lock_class_key *key);
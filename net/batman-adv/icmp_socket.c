@@ -28,6 +28,7 @@
 #include <linux/fs.h>
 #include <linux/if_ether.h>
 #include <linux/kernel.h>
+#include <linux/ktime.h>
 #include <linux/list.h>
 #include <linux/module.h>
 #include <linux/netdevice.h>
@@ -60,7 +61,28 @@ void batadv_socket_init(void)
 	memset(batadv_socket_client_hash, 0, sizeof(batadv_socket_client_hash));
 }
 
-static int batadv_socket_open(struct inode *inode, struct file *file)
+/**
+ * batadv_socket_record_len - compute the space occupied by a record
+ * @icmp_len: length of the icmp packet carried by the record
+ *
+ * Return: length of the record header plus the padded icmp packet
+ */
+static size_t batadv_socket_record_len(size_t icmp_len)
+{
+	return sizeof(struct batadv_icmp_socket_record) +
+	       ALIGN(icmp_len, BATADV_ICMP_SOCKET_RECORD_ALIGN);
+}
+
+/**
+ * __batadv_socket_open - register a new icmp socket client
+ * @inode: inode which was opened
+ * @file: file handle to be initialized
+ * @batch: whether the client uses the batched record format
+ *
+ * Return: 0 on success or negative error number in case of failure
+ */
+static int __batadv_socket_open(struct inode *inode, struct file *file,
+				bool batch)
 {
 	unsigned int i;
 	struct batadv_socket_client *socket_client;
@@ -92,6 +114,11 @@ static int batadv_socket_open(struct inode *inode, struct file *file)
 
 	INIT_LIST_HEAD(&socket_client->queue_list);
 	socket_client->queue_len = 0;
+	socket_client->batch = batch;
+	if (batch)
+		socket_client->queue_max = BATADV_ICMP_BATCH_QUEUE_LEN;
+	else
+		socket_client->queue_max = BATADV_ICMP_QUEUE_LEN;
 	socket_client->index = i;
 	socket_client->bat_priv = inode->i_private;
 	spin_lock_init(&socket_client->lock);
@@ -102,6 +129,16 @@ static int batadv_socket_open(struct inode *inode, struct file *file)
 	return 0;
 }
 
+static int batadv_socket_open(struct inode *inode, struct file *file)
+{
+	return __batadv_socket_open(inode, file, false);
+}
+
+static int batadv_socket_batch_open(struct inode *inode, struct file *file)
+{
+	return __batadv_socket_open(inode, file, true);
+}
+
 static int batadv_socket_release(struct inode *inode, struct file *file)
 {
 	struct batadv_socket_client *socket_client = file->private_data;
@@ -128,6 +165,139 @@ static int batadv_socket_release(struct inode *inode, struct file *file)
 	return 0;
 }
 
+/**
+ * batadv_socket_copy_record - copy a queued packet to userspace as a record
+ * @buf: userspace buffer to fill
+ * @socket_packet: the packet to copy
+ *
+ * Return: 0 on success or -EFAULT if the buffer could not be written
+ */
+static int batadv_socket_copy_record(char __user *buf,
+				     struct batadv_socket_packet *socket_packet)
+{
+	struct batadv_icmp_socket_record record;
+
+	memset(&record, 0, sizeof(record));
+	record.timestamp = ktime_to_ns(socket_packet->timestamp);
+	record.len = socket_packet->icmp_len;
+
+	if (copy_to_user(buf, &record, sizeof(record)))
+		return -EFAULT;
+
+	buf += sizeof(record);
+	if (copy_to_user(buf, socket_packet->icmp_packet,
+			 socket_packet->icmp_len))
+		return -EFAULT;
+
+	return 0;
+}
+
+/**
+ * batadv_socket_dequeue - move queued packets to a private list
+ * @socket_client: the socket to dequeue the packets from
+ * @batch: list to move the packets to
+ * @count: maximum number of bytes the dequeued records may occupy
+ */
+static void batadv_socket_dequeue(struct batadv_socket_client *socket_client,
+				  struct list_head *batch, size_t count)
+{
+	struct batadv_socket_packet *socket_packet, *packet_tmp;
+	size_t record_len, len = 0;
+
+	spin_lock_bh(&socket_client->lock);
+	list_for_each_entry_safe(socket_packet, packet_tmp,
+				 &socket_client->queue_list, list) {
+		record_len = batadv_socket_record_len(socket_packet->icmp_len);
+		if (len + record_len > count)
+			break;
+
+		list_move_tail(&socket_packet->list, batch);
+		socket_client->queue_len--;
+		len += record_len;
+	}
+	spin_unlock_bh(&socket_client->lock);
+}
+
+/**
+ * batadv_socket_requeue - put dequeued packets back to the head of the queue
+ * @socket_client: the socket the packets were dequeued from
+ * @batch: list of packets which were not delivered to the reader
+ */
+static void batadv_socket_requeue(struct batadv_socket_client *socket_client,
+				  struct list_head *batch)
+{
+	struct batadv_socket_packet *socket_packet;
+	int num = 0;
+
+	list_for_each_entry(socket_packet, batch, list)
+		num++;
+
+	spin_lock_bh(&socket_client->lock);
+	list_splice(batch, &socket_client->queue_list);
+	socket_client->queue_len += num;
+	spin_unlock_bh(&socket_client->lock);
+}
+
+/**
+ * batadv_socket_read_batch - read as many queued packets as fit into the user
+ *  buffer
+ * @file: the file of the batched icmp socket
+ * @buf: userspace buffer to fill with batadv_icmp_socket_record records
+ * @count: size of @buf
+ *
+ * Records which could not be copied are put back into the queue.
+ *
+ * Return: number of bytes written to @buf or negative error number if not
+ * even the first record could be copied
+ */
+static ssize_t batadv_socket_read_batch(struct file *file, char __user *buf,
+					size_t count)
+{
+	struct batadv_socket_client *socket_client = file->private_data;
+	struct batadv_socket_packet *socket_packet, *packet_tmp;
+	size_t copied = 0;
+	LIST_HEAD(batch);
+	int error = 0;
+
+	if ((!buf) ||
+	    (count < batadv_socket_record_len(BATADV_ICMP_MAX_PACKET_SIZE)))
+		return -EINVAL;
+
+	if (!access_ok(VERIFY_WRITE, buf, count))
+		return -EFAULT;
+
+	while (list_empty(&batch)) {
+		if ((file->f_flags & O_NONBLOCK) &&
+		    (socket_client->queue_len == 0))
+			return -EAGAIN;
+
+		error = wait_event_interruptible(socket_client->queue_wait,
+						 socket_client->queue_len);
+		if (error)
+			return error;
+
+		batadv_socket_dequeue(socket_client, &batch, count);
+	}
+
+	list_for_each_entry_safe(socket_packet, packet_tmp, &batch, list) {
+		error = batadv_socket_copy_record(buf + copied, socket_packet);
+		if (error)
+			break;
+
+		copied += batadv_socket_record_len(socket_packet->icmp_len);
+		list_del(&socket_packet->list);
+		kfree(socket_packet);
+	}
+
+	if (!list_empty(&batch))
+		batadv_socket_requeue(socket_client, &batch);
+
+	if (copied)
+		return copied;
+
+	return error;
+}
+
 static ssize_t batadv_socket_read(struct file *file, char __user *buf,
 				  size_t count, loff_t *ppos)
 {
@@ -136,6 +306,9 @@ static ssize_t batadv_socket_read(struct file *file, char __user *buf,
 	size_t packet_len;
 	int error;
 
+	if (socket_client->batch)
+		return batadv_socket_read_batch(file, buf, count);
+
 	if ((file->f_flags & O_NONBLOCK) && (socket_client->queue_len == 0))
 		return -EAGAIN;
 
@@ -171,10 +344,17 @@ static ssize_t batadv_socket_read(struct file *file, char __user *buf,
 	return packet_len;
 }
 
-static ssize_t batadv_socket_write(struct file *file, const char __user *buff,
-				   size_t len, loff_t *off)
+/**
+ * batadv_socket_send - send a single icmp packet written by userspace
+ * @socket_client: the socket the packet was written to
+ * @buff: userspace buffer holding the icmp packet
+ * @len: length of the icmp packet
+ *
+ * Return: @len on success or negative error number in case of failure
+ */
+static ssize_t batadv_socket_send(struct batadv_socket_client *socket_client,
+				  const char __user *buff, size_t len)
 {
-	struct batadv_socket_client *socket_client = file->private_data;
 	struct batadv_priv *bat_priv = socket_client->bat_priv;
 	struct batadv_hard_iface *primary_if = NULL;
 	struct sk_buff *skb;
@@ -296,6 +476,67 @@ out:
 	return len;
 }
 
+/**
+ * batadv_socket_write_batch - send all the icmp packets of a record batch
+ * @socket_client: the socket the batch was written to
+ * @buff: userspace buffer holding batadv_icmp_socket_record records
+ * @len: length of @buff
+ *
+ * The padding of the last record may be omitted. Processing stops at the
+ * first invalid record, including records with non-zero reserved bytes.
+ *
+ * Return: number of bytes consumed or negative error number if not even the
+ * first record could be sent
+ */
+static ssize_t
+batadv_socket_write_batch(struct batadv_socket_client *socket_client,
+			  const char __user *buff, size_t len)
+{
+	struct batadv_icmp_socket_record record, zero = { 0 };
+	size_t done = 0;
+	ssize_t ret = -EINVAL;
+
+	while (len - done >= sizeof(record)) {
+		if (copy_from_user(&record, buff + done, sizeof(record))) {
+			ret = -EFAULT;
+			break;
+		}
+
+		if (memcmp(record.reserved, zero.reserved,
+			   sizeof(record.reserved)) ||
+		    record.len > BATADV_ICMP_MAX_PACKET_SIZE ||
+		    record.len > len - done - sizeof(record)) {
+			ret = -EINVAL;
+			break;
+		}
+
+		ret = batadv_socket_send(socket_client,
+					 buff + done + sizeof(record),
+					 record.len);
+		if (ret < 0)
+			break;
+
+		done += batadv_socket_record_len(record.len);
+		done = min(done, len);
+	}
+
+	if (done)
+		return done;
+
+	return ret;
+}
+
+static ssize_t batadv_socket_write(struct file *file, const char __user *buff,
+				   size_t len, loff_t *off)
+{
+	struct batadv_socket_client *socket_client = file->private_data;
+
+	if (socket_client->batch)
+		return batadv_socket_write_batch(socket_client, buff, len);
+
+	return batadv_socket_send(socket_client, buff, len);
+}
+
 static unsigned int batadv_socket_poll(struct file *file, poll_table *wait)
 {
 	struct batadv_socket_client *socket_client = file->private_data;
@@ -318,6 +559,16 @@ static const struct file_operations batadv_fops = {
 	.llseek = no_llseek,
 };
 
+static const struct file_operations batadv_batch_fops = {
+	.owner = THIS_MODULE,
+	.open = batadv_socket_batch_open,
+	.release = batadv_socket_release,
+	.read = batadv_socket_read,
+	.write = batadv_socket_write,
+	.poll = batadv_socket_poll,
+	.llseek = no_llseek,
+};
+
 int batadv_socket_setup(struct batadv_priv *bat_priv)
 {
 	struct dentry *d;
@@ -330,6 +581,13 @@ int batadv_socket_setup(struct batadv_priv *bat_priv)
 	if (!d)
 		goto err;
 
+	d = debugfs_create_file(BATADV_ICMP_SOCKET_BATCH,
+				S_IFREG | S_IWUSR | S_IRUSR,
+				bat_priv->debug_dir, bat_priv,
+				&batadv_batch_fops);
+	if (!d)
+		goto err;
+
 	return 0;
 
 err:
@@ -363,6 +621,7 @@ static void batadv_socket_add_packet(struct batadv_socket_client *socket_client,
 	INIT_LIST_HEAD(&socket_packet->list);
 	memcpy(&socket_packet->icmp_packet, icmph, len);
 	socket_packet->icmp_len = len;
+	socket_packet->timestamp = ktime_get();
 
 	spin_lock_bh(&socket_client->lock);
 
@@ -378,7 +637,7 @@ static void batadv_socket_add_packet(struct batadv_socket_client *socket_client,
 	list_add_tail(&socket_packet->list, &socket_client->queue_list);
 	socket_client->queue_len++;
 
-	if (socket_client->queue_len > 100) {
+	if (socket_client->queue_len > socket_client->queue_max) {
 		socket_packet = list_first_entry(&socket_client->queue_list,
 						 struct batadv_socket_packet,
 						 list);
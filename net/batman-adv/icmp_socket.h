@@ -25,6 +25,7 @@
 struct batadv_icmp_header;
 
 #define BATADV_ICMP_SOCKET "socket"
+#define BATADV_ICMP_SOCKET_BATCH "socket_batch"
 
 void batadv_socket_init(void);
 int batadv_socket_setup(struct batadv_priv *bat_priv);
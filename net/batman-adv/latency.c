@@ -0,0 +1,159 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency.h"
+#include "main.h"
+
+#include <linux/cpumask.h>
+#include <linux/errno.h>
+#include <linux/netdevice.h>
+#include <linux/percpu.h>
+#include <linux/seq_file.h>
+#include <linux/string.h>
+
+static const char * const batadv_latency_names[BATADV_LATENCY_NUM] = {
+	[BATADV_LATENCY_TX] = "interface_tx",
+	[BATADV_LATENCY_RX_UNICAST] = "recv_unicast",
+	[BATADV_LATENCY_OGM] = "ogm_process",
+	[BATADV_LATENCY_FRAG] = "frag_buffer",
+	[BATADV_LATENCY_BCAST_QUEUE] = "bcast_queue",
+};
+
+/**
+ * batadv_latency_init - allocate the latency histograms of a mesh interface
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Return: 0 on success, -ENOMEM otherwise.
+ */
+int batadv_latency_init(struct batadv_priv *bat_priv)
+{
+	bat_priv->latency = alloc_percpu(struct batadv_latency_hist);
+	if (!bat_priv->latency)
+		return -ENOMEM;
+
+	batadv_latency_reset(bat_priv);
+
+	return 0;
+}
+
+/**
+ * batadv_latency_free - free the latency histograms of a mesh interface
+ * @bat_priv: the bat priv with all the soft interface information
+ */
+void batadv_latency_free(struct batadv_priv *bat_priv)
+{
+	free_percpu(bat_priv->latency);
+	bat_priv->latency = NULL;
+}
+
+/**
+ * batadv_latency_reset - clear all latency histograms of a mesh interface
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Samples recorded concurrently on other CPUs may survive the reset.
+ */
+void batadv_latency_reset(struct batadv_priv *bat_priv)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		memset(per_cpu_ptr(bat_priv->latency, cpu), 0,
+		       sizeof(struct batadv_latency_hist));
+}
+
+/**
+ * batadv_latency_sum - sum up a histogram bucket over all CPUs
+ * @bat_priv: the bat priv with all the soft interface information
+ * @path: the code path of the histogram
+ * @bucket: index of the bucket
+ *
+ * Return: the number of samples in the bucket.
+ */
+static u64 batadv_latency_sum(struct batadv_priv *bat_priv,
+			      enum batadv_latency_path path,
+			      unsigned int bucket)
+{
+	struct batadv_latency_hist *hist;
+	u64 sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		hist = per_cpu_ptr(bat_priv->latency, cpu);
+		sum += hist->buckets[path][bucket];
+	}
+
+	return sum;
+}
+
+/**
+ * batadv_latency_print - print the non-empty buckets of a histogram
+ * @seq: seq file to print on
+ * @bat_priv: the bat priv with all the soft interface information
+ * @path: the code path of the histogram
+ */
+static void batadv_latency_print(struct seq_file *seq,
+				 struct batadv_priv *bat_priv,
+				 enum batadv_latency_path path)
+{
+	u64 count[BATADV_LATENCY_BUCKETS];
+	u64 total = 0;
+	unsigned int i;
+
+	for (i = 0; i < BATADV_LATENCY_BUCKETS; i++) {
+		count[i] = batadv_latency_sum(bat_priv, path, i);
+		total += count[i];
+	}
+
+	seq_printf(seq, "%s: %llu samples\n", batadv_latency_names[path],
+		   total);
+
+	for (i = 0; i < BATADV_LATENCY_BUCKETS; i++) {
+		if (!count[i])
+			continue;
+
+		if (i == 0)
+			seq_printf(seq, "\t%10u ns             : %llu\n", 0,
+				   count[i]);
+		else if (i == BATADV_LATENCY_BUCKETS - 1)
+			seq_printf(seq, "\t%10llu ns and more    : %llu\n",
+				   1ULL << (i - 1), count[i]);
+		else
+			seq_printf(seq, "\t%10llu - %10llu ns: %llu\n",
+				   1ULL << (i - 1), (1ULL << i) - 1, count[i]);
+	}
+}
+
+/**
+ * batadv_latency_seq_print_text - print the latency histograms of a mesh
+ *  interface
+ * @seq: seq file to print on
+ * @offset: not used
+ *
+ * Return: always 0
+ */
+int batadv_latency_seq_print_text(struct seq_file *seq, void *offset)
+{
+	struct net_device *net_dev = (struct net_device *)seq->private;
+	struct batadv_priv *bat_priv = netdev_priv(net_dev);
+	int path;
+
+	seq_printf(seq, "Latency histograms of %s (write to reset):\n",
+		   net_dev->name);
+
+	for (path = 0; path < BATADV_LATENCY_NUM; path++)
+		batadv_latency_print(seq, bat_priv, path);
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NET_BATMAN_ADV_LATENCY_H_
+#define _NET_BATMAN_ADV_LATENCY_H_
+
+#include "main.h"
+
+#include <linux/bitops.h>
+#include <linux/ktime.h>
+#include <linux/percpu.h>
+#include <linux/types.h>
+
+struct seq_file;
+
+#ifdef CONFIG_BATMAN_ADV_LATENCY
+
+int batadv_latency_init(struct batadv_priv *bat_priv);
+void batadv_latency_free(struct batadv_priv *bat_priv);
+void batadv_latency_reset(struct batadv_priv *bat_priv);
+int batadv_latency_seq_print_text(struct seq_file *seq, void *offset);
+
+/**
+ * batadv_latency_start - get the start time of a measured section
+ *
+ * Return: the current time.
+ */
+static inline ktime_t batadv_latency_start(void)
+{
+	return ktime_get();
+}
+
+/**
+ * batadv_latency_stop - account a measured section in its histogram
+ * @bat_priv: the bat priv with all the soft interface information
+ * @path: the code path the section belongs to
+ * @start: the time returned by batadv_latency_start()
+ */
+static inline void batadv_latency_stop(struct batadv_priv *bat_priv,
+				       enum batadv_latency_path path,
+				       ktime_t start)
+{
+	s64 delta = ktime_to_ns(ktime_sub(ktime_get(), start));
+	unsigned int bucket = 0;
+
+	if (delta > 0)
+		bucket = fls64(delta);
+
+	if (bucket >= BATADV_LATENCY_BUCKETS)
+		bucket = BATADV_LATENCY_BUCKETS - 1;
+
+	this_cpu_add(bat_priv->latency->buckets[path][bucket], 1);
+}
+
+#else
+
+static inline int batadv_latency_init(struct batadv_priv *bat_priv)
+{
+	return 0;
+}
+
+static inline void batadv_latency_free(struct batadv_priv *bat_priv)
+{
+}
+
+static inline ktime_t batadv_latency_start(void)
+{
+	return ktime_set(0, 0);
+}
+
+static inline void batadv_latency_stop(struct batadv_priv *bat_priv,
+				       enum batadv_latency_path path,
+				       ktime_t start)
+{
+}
+
+#endif /* CONFIG_BATMAN_ADV_LATENCY */
+
+#endif /* _NET_BATMAN_ADV_LATENCY_H_ */
@@ -56,13 +56,16 @@
 #include "gateway_common.h"
 #include "hard-interface.h"
 #include "icmp_socket.h"
+#include "latency.h"
 #include "multicast.h"
+#include "netlink.h"
 #include "network-coding.h"
 #include "originator.h"
 #include "packet.h"
 #include "routing.h"
 #include "send.h"
 #include "soft-interface.h"
+#include "tp_meter.h"
 #include "translation-table.h"
 
 /* List manipulations on hardif_list have to be rtnl_lock()'ed,
@@ -82,6 +85,8 @@ static void batadv_recv_handler_init(void);
 
 static int __init batadv_init(void)
 {
+	int ret;
+
 	INIT_LIST_HEAD(&batadv_hardif_list);
 	INIT_HLIST_HEAD(&batadv_algo_list);
 
@@ -99,6 +104,10 @@ static int __init batadv_init(void)
 	batadv_socket_init();
 	batadv_debugfs_init();
 
+	ret = batadv_netlink_register();
+	if (ret < 0)
+		goto err_netlink;
+
 	register_netdevice_notifier(&batadv_hard_if_notifier);
 	rtnl_link_register(&batadv_link_ops);
 
@@ -106,11 +115,19 @@ static int __init batadv_init(void)
 		BATADV_SOURCE_VERSION, BATADV_COMPAT_VERSION);
 
 	return 0;
+
+err_netlink:
+	batadv_debugfs_destroy();
+	destroy_workqueue(batadv_event_workqueue);
+	batadv_event_workqueue = NULL;
+
+	return ret;
 }
 
 static void __exit batadv_exit(void)
 {
 	batadv_debugfs_destroy();
+	batadv_netlink_unregister();
 	rtnl_link_unregister(&batadv_link_ops);
 	unregister_netdevice_notifier(&batadv_hard_if_notifier);
 	batadv_hardif_remove_interfaces();
@@ -134,6 +151,8 @@ int batadv_mesh_init(struct net_device *soft_iface)
 	spin_lock_init(&bat_priv->tt.roam_list_lock);
 	spin_lock_init(&bat_priv->tt.last_changeset_lock);
 	spin_lock_init(&bat_priv->tt.commit_lock);
+	spin_lock_init(&bat_priv->tt.local_stats.lock);
+	spin_lock_init(&bat_priv->tt.global_stats.lock);
 	spin_lock_init(&bat_priv->gw.list_lock);
 #ifdef CONFIG_BATMAN_ADV_MCAST
 	spin_lock_init(&bat_priv->mcast.want_lists_lock);
@@ -160,6 +179,8 @@ int batadv_mesh_init(struct net_device *soft_iface)
 	INIT_HLIST_HEAD(&bat_priv->tvlv.handler_list);
 	INIT_HLIST_HEAD(&bat_priv->softif_vlan_list);
 
+	batadv_tp_meter_init(bat_priv);
+
 	ret = batadv_v_mesh_init(bat_priv);
 	if (ret < 0)
 		goto err;
@@ -205,6 +226,8 @@ void batadv_mesh_free(struct net_device *soft_iface)
 
 	batadv_purge_outstanding_packets(bat_priv, NULL);
 
+	batadv_tp_meter_free(bat_priv);
+
 	batadv_gw_node_free(bat_priv);
 
 	batadv_v_mesh_free(bat_priv);
@@ -229,6 +252,9 @@ void batadv_mesh_free(struct net_device *soft_iface)
 
 	batadv_gw_free(bat_priv);
 
+	batadv_latency_free(bat_priv);
+	free_percpu(bat_priv->txq_counters);
+	bat_priv->txq_counters = NULL;
 	free_percpu(bat_priv->bat_counters);
 	bat_priv->bat_counters = NULL;
 
@@ -383,29 +409,80 @@ void batadv_skb_set_priority(struct sk_buff *skb, int offset)
 static int batadv_recv_unhandled_packet(struct sk_buff *skb,
 					struct batadv_hard_iface *recv_if)
 {
+	batadv_skb_drop_reason(skb, BATADV_DROP_UNHANDLED);
 	return NET_RX_DROP;
 }
 
-/* incoming packets with the batman ethertype received on any active hard
- * interface
+/**
+ * batadv_batman_recv_priv - check whether an interface may receive packets
+ * @hard_iface: the interface the packets were received on
+ *
+ * Return: the bat_priv of the mesh the interface belongs to or NULL if
+ * packets received on this interface have to be dropped
  */
-int batadv_batman_skb_recv(struct sk_buff *skb, struct net_device *dev,
-			   struct packet_type *ptype,
-			   struct net_device *orig_dev)
+static struct batadv_priv *
+batadv_batman_recv_priv(struct batadv_hard_iface *hard_iface)
 {
 	struct batadv_priv *bat_priv;
+
+	if (!hard_iface->soft_iface)
+		return NULL;
+
+	bat_priv = netdev_priv(hard_iface->soft_iface);
+
+	if (atomic_read(&bat_priv->mesh_state) != BATADV_MESH_ACTIVE)
+		return NULL;
+
+	/* discard frames on not active interfaces */
+	if (hard_iface->if_status != BATADV_IF_ACTIVE)
+		return NULL;
+
+	return bat_priv;
+}
+
+/**
+ * batadv_batman_skb_drop - account and free a dropped batman-adv packet
+ * @skb: the received packet
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * The packet is accounted in the drop counter of the reason recorded via
+ * batadv_skb_drop_reason() and offered to the batadv_drop trace event.
+ */
+static void batadv_batman_skb_drop(struct sk_buff *skb,
+				   struct batadv_priv *bat_priv)
+{
+	u8 reason = BATADV_SKB_CB(skb)->drop_reason;
+
+	if (reason >= BATADV_DROP_NUM)
+		reason = BATADV_DROP_UNSPEC;
+
+	batadv_inc_counter(bat_priv, BATADV_CNT_DROP + reason);
+	batadv_trace_drop(bat_priv, skb, reason);
+	kfree_skb(skb);
+}
+
+/**
+ * batadv_batman_skb_check - sanity check a received batman-adv packet
+ * @skb: the received packet
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Return: the (possibly unshared) skb ready to be handed to the receive
+ * handler or NULL if the packet was dropped
+ */
+static struct sk_buff *batadv_batman_skb_check(struct sk_buff *skb,
+					       struct batadv_priv *bat_priv)
+{
 	struct batadv_ogm_packet *batadv_ogm_packet;
-	struct batadv_hard_iface *hard_iface;
-	u8 idx;
-	int ret;
+	enum batadv_drop_reason reason = BATADV_DROP_MALFORMED;
 
-	hard_iface = container_of(ptype, struct batadv_hard_iface,
-				  batman_adv_ptype);
 	skb = skb_share_check(skb, GFP_ATOMIC);
 
 	/* skb was released by skb_share_check() */
 	if (!skb)
-		goto err_out;
+		return NULL;
+
+	/* reset control block to avoid left overs from previous users */
+	memset(skb->cb, 0, sizeof(struct batadv_skb_cb));
 
 	/* packet should hold at least type and version */
 	if (unlikely(!pskb_may_pull(skb, 2)))
@@ -415,49 +492,80 @@ int batadv_batman_skb_recv(struct sk_buff *skb, struct net_device *dev,
 	if (unlikely(skb->mac_len != ETH_HLEN || !skb_mac_header(skb)))
 		goto err_free;
 
-	if (!hard_iface->soft_iface)
-		goto err_free;
-
-	bat_priv = netdev_priv(hard_iface->soft_iface);
-
-	if (atomic_read(&bat_priv->mesh_state) != BATADV_MESH_ACTIVE)
-		goto err_free;
-
-	/* discard frames on not active interfaces */
-	if (hard_iface->if_status != BATADV_IF_ACTIVE)
-		goto err_free;
-
 	batadv_ogm_packet = (struct batadv_ogm_packet *)skb->data;
 
 	if (batadv_ogm_packet->version != BATADV_COMPAT_VERSION) {
 		batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
 			   "Drop packet: incompatible batman version (%i)\n",
 			   batadv_ogm_packet->version);
+		reason = BATADV_DROP_VERSION;
 		goto err_free;
 	}
 
-	/* reset control block to avoid left overs from previous users */
-	memset(skb->cb, 0, sizeof(struct batadv_skb_cb));
+	return skb;
+
+err_free:
+	batadv_skb_drop_reason(skb, reason);
+	batadv_batman_skb_drop(skb, bat_priv);
+	return NULL;
+}
+
+/**
+ * batadv_batman_skb_dispatch - pass a checked packet to its receive handler
+ * @skb: the packet to dispatch
+ * @bat_priv: the bat priv with all the soft interface information
+ * @hard_iface: the interface the packet was received on
+ * @packet_type: the batman-adv packet type of the skb
+ */
+static void batadv_batman_skb_dispatch(struct sk_buff *skb,
+				       struct batadv_priv *bat_priv,
+				       struct batadv_hard_iface *hard_iface,
+				       u8 packet_type)
+{
+	int ret;
 
 	/* all receive handlers return whether they received or reused
 	 * the supplied skb. if not, we have to free the skb.
 	 */
-	idx = batadv_ogm_packet->packet_type;
-	ret = (*batadv_rx_handler[idx])(skb, hard_iface);
+	ret = (*batadv_rx_handler[packet_type])(skb, hard_iface);
 
 	if (ret == NET_RX_DROP)
+		batadv_batman_skb_drop(skb, bat_priv);
+}
+
+/* incoming packets with the batman ethertype received on any active hard
+ * interface
+ */
+int batadv_batman_skb_recv(struct sk_buff *skb, struct net_device *dev,
+			   struct packet_type *ptype,
+			   struct net_device *orig_dev)
+{
+	struct batadv_priv *bat_priv;
+	struct batadv_ogm_packet *batadv_ogm_packet;
+	struct batadv_hard_iface *hard_iface;
+
+	hard_iface = container_of(ptype, struct batadv_hard_iface,
+				  batman_adv_ptype);
+
+	bat_priv = batadv_batman_recv_priv(hard_iface);
+	if (!bat_priv) {
 		kfree_skb(skb);
+		return NET_RX_DROP;
+	}
+
+	skb = batadv_batman_skb_check(skb, bat_priv);
+	if (!skb)
+		return NET_RX_DROP;
+
+	batadv_ogm_packet = (struct batadv_ogm_packet *)skb->data;
+	batadv_batman_skb_dispatch(skb, bat_priv, hard_iface,
+				   batadv_ogm_packet->packet_type);
 
 	/* return NET_RX_SUCCESS in any case as we
 	 * most probably dropped the packet for
 	 * routing-logical reasons.
 	 */
 	return NET_RX_SUCCESS;
-
-err_free:
-	kfree_skb(skb);
-err_out:
-	return NET_RX_DROP;
 }
 
 static void batadv_recv_handler_init(void)
@@ -475,6 +583,7 @@ static void batadv_recv_handler_init(void)
 	BUILD_BUG_ON(sizeof(struct batadv_ogm_packet) != 24);
 	BUILD_BUG_ON(sizeof(struct batadv_icmp_header) != 20);
 	BUILD_BUG_ON(sizeof(struct batadv_icmp_packet) != 20);
+	BUILD_BUG_ON(sizeof(struct batadv_icmp_tp_packet) != 24);
 	BUILD_BUG_ON(sizeof(struct batadv_icmp_packet_rr) != 116);
 	BUILD_BUG_ON(sizeof(struct batadv_unicast_packet) != 10);
 	BUILD_BUG_ON(sizeof(struct batadv_unicast_4addr_packet) != 18);
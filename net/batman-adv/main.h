@@ -49,6 +49,11 @@
 #define BATADV_TT_WORK_PERIOD 5000 /* 5 seconds */
 #define BATADV_ORIG_WORK_PERIOD 1000 /* 1 second */
 #define BATADV_DAT_ENTRY_TIMEOUT (5 * 60000) /* 5 mins in milliseconds */
+/* DAT entries used during the last minute of their lifetime are refreshed via
+ * the DHT, at most once every 10 seconds
+ */
+#define BATADV_DAT_REFRESH_WINDOW 60000 /* in milliseconds */
+#define BATADV_DAT_REFRESH_INTERVAL 10000 /* in milliseconds */
 /* sliding packet range of received originator messages in sequence numbers
  * (should be a multiple of our word size)
  */
@@ -70,6 +75,29 @@
 #define BATADV_OGM_MAX_ORIGDIFF 5
 #define BATADV_OGM_MAX_AGE 64
 
+/* upper limit of tx queues of the soft interface, one per cpu otherwise */
+#define BATADV_MAX_TXQ 16
+
+/* maximum number of replies queued on an icmp socket (regular/batched) */
+#define BATADV_ICMP_QUEUE_LEN 100
+#define BATADV_ICMP_BATCH_QUEUE_LEN 4096
+
+/* throughput meter */
+#define BATADV_TP_MAX_NUM 5 /* concurrent sessions (both roles) */
+#define BATADV_TP_PACKET_LEN ETH_DATA_LEN
+#define BATADV_TP_DEF_TEST_LENGTH 10000 /* milliseconds */
+#define BATADV_TP_MAX_TEST_LENGTH 600000 /* milliseconds */
+#define BATADV_TP_AWND 0x20000 /* bytes the receiver accepts in flight */
+#define BATADV_TP_RTO_INIT 1000 /* milliseconds */
+#define BATADV_TP_RTO_MIN 200 /* milliseconds */
+#define BATADV_TP_RTO_MAX 10000 /* milliseconds */
+#define BATADV_TP_MAX_BACKOFFS 5
+#define BATADV_TP_RECV_TIMEOUT 1000 /* milliseconds */
+#define BATADV_TP_RESULT_TIMEOUT 60000 /* milliseconds */
+
+/* log2 buckets of the latency histograms, the last one covers >= 2^30 ns */
+#define BATADV_LATENCY_BUCKETS 32
+
 /* number of OGMs sent with the last tt diff */
 #define BATADV_TT_OGM_APPEND_MAX 3
 
@@ -104,6 +132,15 @@
 #define ARP_REQ_DELAY 250
 /* numbers of originator to contact for any PUT/GET DHT operation */
 #define BATADV_DAT_CANDIDATES_NUM 3
+/* default number of entries the local DAT cache may hold */
+#define BATADV_DAT_MAX_ENTRIES_DEFAULT 2048
+
+/* log2 of the number of bloom filter counters kept for the DAT cache and the
+ * global translation table. 8 counters per entry give a false positive rate
+ * below 5% (2k DAT entries, 32k global TT entries)
+ */
+#define BATADV_DAT_BLOOM_BITS 14
+#define BATADV_TT_GLOBAL_BLOOM_BITS 18
 
 /* BATADV_TQ_SIMILARITY_THRESHOLD - TQ points that a secondary metric can differ
  * at most from the primary one in order to be still considered acceptable
@@ -120,6 +157,7 @@
 #define BATADV_BLA_BACKBONE_TIMEOUT	(BATADV_BLA_PERIOD_LENGTH * 6)
 #define BATADV_BLA_CLAIM_TIMEOUT	(BATADV_BLA_PERIOD_LENGTH * 10)
 #define BATADV_BLA_WAIT_PERIODS		3
+#define BATADV_BLA_LASTTIME_INTERVAL	1000	/* 1 second */
 
 #define BATADV_DUPLIST_SIZE		16
 #define BATADV_DUPLIST_TIMEOUT		500	/* 500 ms */
@@ -243,15 +281,74 @@ enum batadv_dbg_level {
 int batadv_debug_log(struct batadv_priv *bat_priv, const char *fmt, ...)
 __printf(2, 3);
 
-/* possibly ratelimited debug output */
+#define batadv_dbg_log_enabled(bat_priv, type) \
+	(atomic_read(&(bat_priv)->log_level) & (type))
+#else /* !CONFIG_BATMAN_ADV_DEBUG */
+__printf(2, 3)
+static inline int batadv_debug_log(struct batadv_priv *bat_priv __always_unused,
+				   const char *fmt __always_unused, ...)
+{
+	return 0;
+}
+
+#define batadv_dbg_log_enabled(bat_priv, type) 0
+#endif
+
+#ifdef CONFIG_BATMAN_ADV_TRACING
+#include "trace.h"
+
+void batadv_trace_dbg(struct batadv_priv *bat_priv, int type,
+		      const char *fmt, ...)
+__printf(3, 4);
+void batadv_trace_drop(struct batadv_priv *bat_priv, struct sk_buff *skb,
+		       enum batadv_drop_reason reason);
+
+#define batadv_trace_dbg_enabled() trace_batadv_dbg_enabled()
+#else /* !CONFIG_BATMAN_ADV_TRACING */
+__printf(3, 4)
+static inline void
+batadv_trace_dbg(struct batadv_priv *bat_priv __always_unused,
+		 int type __always_unused, const char *fmt __always_unused, ...)
+{
+}
+
+static inline void
+batadv_trace_drop(struct batadv_priv *bat_priv __always_unused,
+		  struct sk_buff *skb __always_unused,
+		  enum batadv_drop_reason reason __always_unused)
+{
+}
+
+#define batadv_trace_dbg_enabled() 0
+#endif
+
+#if defined(CONFIG_BATMAN_ADV_DEBUG) || defined(CONFIG_BATMAN_ADV_TRACING)
+/* possibly ratelimited debug output
+ *
+ * Nothing is formatted unless the type is selected in log_level or the
+ * batadv_dbg trace event is enabled (a static branch). Only such messages
+ * consume the net_ratelimit() budget.
+ */
 #define _batadv_dbg(type, bat_priv, ratelimited, fmt, arg...)	\
 	do {							\
-		if (atomic_read(&bat_priv->log_level) & type && \
-		    (!ratelimited || net_ratelimit()))		\
-			batadv_debug_log(bat_priv, fmt, ## arg);\
+		struct batadv_priv *__batpriv = (bat_priv);	\
+		bool __log, __trace;				\
+								\
+		__log = batadv_dbg_log_enabled(__batpriv, type);\
+		__trace = batadv_trace_dbg_enabled();		\
+		if (!__log && !__trace)				\
+			break;					\
+								\
+		if (ratelimited && !net_ratelimit())		\
+			break;					\
+								\
+		if (__trace)					\
+			batadv_trace_dbg(__batpriv, type, fmt, ## arg);\
+		if (__log)					\
+			batadv_debug_log(__batpriv, fmt, ## arg);\
 	}							\
 	while (0)
-#else /* !CONFIG_BATMAN_ADV_DEBUG */
+#else /* !CONFIG_BATMAN_ADV_DEBUG && !CONFIG_BATMAN_ADV_TRACING */
 __printf(4, 5)
 static inline void _batadv_dbg(int type __always_unused,
 			       struct batadv_priv *bat_priv __always_unused,
@@ -365,6 +462,19 @@ static inline u64 batadv_sum_counter(struct batadv_priv *bat_priv,  size_t idx)
  */
 #define BATADV_SKB_CB(__skb)       ((struct batadv_skb_cb *)&((__skb)->cb[0]))
 
+/**
+ * batadv_skb_drop_reason - record why a received packet is dropped
+ * @skb: the received packet
+ * @reason: the cause of the drop
+ *
+ * The reason is accounted once the receive handler returned NET_RX_DROP.
+ */
+static inline void batadv_skb_drop_reason(struct sk_buff *skb,
+					  enum batadv_drop_reason reason)
+{
+	BATADV_SKB_CB(skb)->drop_reason = reason;
+}
+
 void batadv_tvlv_container_register(struct batadv_priv *bat_priv,
 				    u8 type, u8 version,
 				    void *tvlv_value, u16 tvlv_value_len);
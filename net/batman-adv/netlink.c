@@ -0,0 +1,412 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "netlink.h"
+#include "main.h"
+
+#include <linux/err.h>
+#include <linux/errno.h>
+#include <linux/etherdevice.h>
+#include <linux/if_ether.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/netdevice.h>
+#include <linux/netlink.h>
+#include <linux/printk.h>
+#include <linux/skbuff.h>
+#include <linux/stddef.h>
+#include <linux/string.h>
+#include <linux/types.h>
+#include <net/genetlink.h>
+#include <net/netlink.h>
+#include <net/sock.h>
+#include <uapi/linux/batman_adv.h>
+
+#include "bridge_loop_avoidance.h"
+#include "distributed-arp-table.h"
+#include "gateway_client.h"
+#include "hard-interface.h"
+#include "originator.h"
+#include "soft-interface.h"
+#include "tp_meter.h"
+#include "translation-table.h"
+
+static struct genl_family batadv_netlink_family = {
+	.id = GENL_ID_GENERATE,
+	.hdrsize = 0,
+	.name = BATADV_NL_NAME,
+	.version = 1,
+	.maxattr = BATADV_ATTR_MAX,
+};
+
+static struct nla_policy batadv_netlink_policy[NUM_BATADV_ATTR] = {
+	[BATADV_ATTR_MESH_IFINDEX]	= { .type = NLA_U32 },
+	[BATADV_ATTR_ORIG_ADDRESS]	= { .len = ETH_ALEN },
+	[BATADV_ATTR_TPMETER_TEST_TIME]	= { .type = NLA_U32 },
+	[BATADV_ATTR_FILTER_ORIG]	= { .len = ETH_ALEN },
+	[BATADV_ATTR_FILTER_VID]	= { .type = NLA_U16 },
+	[BATADV_ATTR_FILTER_TTVN]	= { .type = NLA_U8 },
+};
+
+/**
+ * batadv_netlink_hdr_put - add the genetlink header of a dump entry
+ * @msg: netlink message which is filled by the dump
+ * @cb: control block of the running dump
+ * @cmd: command which is answered by the dump
+ *
+ * Return: pointer to the user header or NULL if @msg has no room left
+ */
+void *batadv_netlink_hdr_put(struct sk_buff *msg, struct netlink_callback *cb,
+			     u8 cmd)
+{
+	return genlmsg_put(msg, NETLINK_CB(cb->skb).portid,
+			   cb->nlh->nlmsg_seq, &batadv_netlink_family,
+			   NLM_F_MULTI, cmd);
+}
+
+/**
+ * batadv_netlink_filter_parse - extract the filter attributes of a request
+ * @filter: filter to initialize
+ * @attrs: parsed attributes of the dump request
+ */
+static void batadv_netlink_filter_parse(struct batadv_netlink_filter *filter,
+					struct nlattr **attrs)
+{
+	memset(filter, 0, sizeof(*filter));
+
+	if (attrs[BATADV_ATTR_FILTER_ORIG]) {
+		ether_addr_copy(filter->orig,
+				nla_data(attrs[BATADV_ATTR_FILTER_ORIG]));
+		filter->orig_set = true;
+	}
+
+	if (attrs[BATADV_ATTR_FILTER_VID]) {
+		filter->vid = nla_get_u16(attrs[BATADV_ATTR_FILTER_VID]);
+		filter->vid_set = true;
+	}
+
+	if (attrs[BATADV_ATTR_FILTER_TTVN]) {
+		filter->ttvn = nla_get_u8(attrs[BATADV_ATTR_FILTER_TTVN]);
+		filter->ttvn_set = true;
+	}
+}
+
+/**
+ * batadv_netlink_dump - common part of all table dumps
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @dump: table specific function adding the entries to @msg
+ *
+ * Looks up the requested batman-adv interface and parses the filter. The
+ * table specific @dump function adds entries until @msg is full and stores
+ * its position in cb->args, so the next call continues from there.
+ *
+ * Return: length of @msg (0 when the dump is complete) or a negative error
+ */
+static int
+batadv_netlink_dump(struct sk_buff *msg, struct netlink_callback *cb,
+		    int (*dump)(struct sk_buff *msg,
+				struct netlink_callback *cb,
+				struct batadv_priv *bat_priv,
+				const struct batadv_netlink_filter *filter))
+{
+	struct net *net = sock_net(cb->skb->sk);
+	struct batadv_hard_iface *primary_if = NULL;
+	struct nlattr *attrs[NUM_BATADV_ATTR];
+	struct batadv_netlink_filter filter;
+	struct net_device *soft_iface;
+	struct batadv_priv *bat_priv;
+	int ifindex;
+	int ret;
+
+	ret = nlmsg_parse(cb->nlh, GENL_HDRLEN, attrs, BATADV_ATTR_MAX,
+			  batadv_netlink_policy);
+	if (ret < 0)
+		return ret;
+
+	if (!attrs[BATADV_ATTR_MESH_IFINDEX])
+		return -EINVAL;
+
+	ifindex = nla_get_u32(attrs[BATADV_ATTR_MESH_IFINDEX]);
+	soft_iface = dev_get_by_index(net, ifindex);
+	if (!soft_iface)
+		return -ENODEV;
+
+	if (!batadv_softif_is_valid(soft_iface)) {
+		ret = -ENODEV;
+		goto out;
+	}
+
+	bat_priv = netdev_priv(soft_iface);
+
+	primary_if = batadv_primary_if_get_selected(bat_priv);
+	if (!primary_if || primary_if->if_status != BATADV_IF_ACTIVE) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	batadv_netlink_filter_parse(&filter, attrs);
+
+	ret = dump(msg, cb, bat_priv, &filter);
+	if (ret == 0)
+		ret = msg->len;
+
+out:
+	if (primary_if)
+		batadv_hardif_put(primary_if);
+	dev_put(soft_iface);
+
+	return ret;
+}
+
+static int batadv_netlink_dump_orig(struct sk_buff *msg,
+				    struct netlink_callback *cb)
+{
+	return batadv_netlink_dump(msg, cb, batadv_orig_dump);
+}
+
+static int batadv_netlink_dump_tt_global(struct sk_buff *msg,
+					 struct netlink_callback *cb)
+{
+	return batadv_netlink_dump(msg, cb, batadv_tt_global_dump);
+}
+
+static int batadv_netlink_dump_bla_claim(struct sk_buff *msg,
+					 struct netlink_callback *cb)
+{
+	return batadv_netlink_dump(msg, cb, batadv_bla_claim_dump);
+}
+
+static int batadv_netlink_dump_dat_cache(struct sk_buff *msg,
+					 struct netlink_callback *cb)
+{
+	return batadv_netlink_dump(msg, cb, batadv_dat_cache_dump);
+}
+
+static int batadv_netlink_dump_gw(struct sk_buff *msg,
+				  struct netlink_callback *cb)
+{
+	return batadv_netlink_dump(msg, cb, batadv_gw_dump);
+}
+
+static int batadv_netlink_dump_tp_meter(struct sk_buff *msg,
+					struct netlink_callback *cb)
+{
+	return batadv_netlink_dump(msg, cb, batadv_tp_dump);
+}
+
+/**
+ * batadv_netlink_get_softif - look up the batman-adv interface of a request
+ * @skb: the received request
+ * @info: receiver information of the request
+ *
+ * Return: the batman-adv interface with increased refcounter or an ERR_PTR
+ */
+static struct net_device *batadv_netlink_get_softif(struct sk_buff *skb,
+						   struct genl_info *info)
+{
+	struct net *net = sock_net(skb->sk);
+	struct net_device *soft_iface;
+	int ifindex;
+
+	if (!info->attrs[BATADV_ATTR_MESH_IFINDEX])
+		return ERR_PTR(-EINVAL);
+
+	ifindex = nla_get_u32(info->attrs[BATADV_ATTR_MESH_IFINDEX]);
+	soft_iface = dev_get_by_index(net, ifindex);
+	if (!soft_iface)
+		return ERR_PTR(-ENODEV);
+
+	if (!batadv_softif_is_valid(soft_iface)) {
+		dev_put(soft_iface);
+		return ERR_PTR(-ENODEV);
+	}
+
+	return soft_iface;
+}
+
+/**
+ * batadv_netlink_tp_meter_start - start a throughput test
+ * @skb: the received request
+ * @info: receiver information of the request
+ *
+ * Return: 0 on success or negative error number in case of failure
+ */
+static int batadv_netlink_tp_meter_start(struct sk_buff *skb,
+					 struct genl_info *info)
+{
+	struct net_device *soft_iface;
+	struct batadv_priv *bat_priv;
+	struct sk_buff *msg = NULL;
+	struct nlattr *attr;
+	u32 test_length = 0;
+	u32 cookie;
+	void *hdr;
+	u8 *dst;
+	int ret;
+
+	if (!info->attrs[BATADV_ATTR_ORIG_ADDRESS])
+		return -EINVAL;
+
+	dst = nla_data(info->attrs[BATADV_ATTR_ORIG_ADDRESS]);
+
+	attr = info->attrs[BATADV_ATTR_TPMETER_TEST_TIME];
+	if (attr)
+		test_length = nla_get_u32(attr);
+
+	soft_iface = batadv_netlink_get_softif(skb, info);
+	if (IS_ERR(soft_iface))
+		return PTR_ERR(soft_iface);
+
+	bat_priv = netdev_priv(soft_iface);
+
+	msg = nlmsg_new(NLMSG_DEFAULT_SIZE, GFP_KERNEL);
+	if (!msg) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	hdr = genlmsg_put_reply(msg, info, &batadv_netlink_family, 0,
+				BATADV_CMD_TP_METER);
+	if (!hdr) {
+		ret = -ENOBUFS;
+		goto out;
+	}
+
+	ret = batadv_tp_start(bat_priv, dst, test_length, &cookie);
+	if (ret < 0)
+		goto out;
+
+	if (nla_put_u32(msg, BATADV_ATTR_TPMETER_COOKIE, cookie)) {
+		batadv_tp_stop(bat_priv, dst);
+		ret = -ENOBUFS;
+		goto out;
+	}
+
+	genlmsg_end(msg, hdr);
+	ret = genlmsg_reply(msg, info);
+	msg = NULL;
+
+out:
+	nlmsg_free(msg);
+	dev_put(soft_iface);
+
+	return ret;
+}
+
+/**
+ * batadv_netlink_tp_meter_cancel - cancel a running throughput test
+ * @skb: the received request
+ * @info: receiver information of the request
+ *
+ * Return: 0 on success or negative error number in case of failure
+ */
+static int batadv_netlink_tp_meter_cancel(struct sk_buff *skb,
+					  struct genl_info *info)
+{
+	struct net_device *soft_iface;
+	u8 *dst;
+	int ret;
+
+	if (!info->attrs[BATADV_ATTR_ORIG_ADDRESS])
+		return -EINVAL;
+
+	dst = nla_data(info->attrs[BATADV_ATTR_ORIG_ADDRESS]);
+
+	soft_iface = batadv_netlink_get_softif(skb, info);
+	if (IS_ERR(soft_iface))
+		return PTR_ERR(soft_iface);
+
+	ret = batadv_tp_stop(netdev_priv(soft_iface), dst);
+	dev_put(soft_iface);
+
+	return ret;
+}
+
+static struct genl_ops batadv_netlink_ops[] = {
+	{
+		.cmd = BATADV_CMD_GET_ORIGINATORS,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.dumpit = batadv_netlink_dump_orig,
+	},
+	{
+		.cmd = BATADV_CMD_GET_TRANSTABLE_GLOBAL,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.dumpit = batadv_netlink_dump_tt_global,
+	},
+	{
+		.cmd = BATADV_CMD_GET_BLA_CLAIM,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.dumpit = batadv_netlink_dump_bla_claim,
+	},
+	{
+		.cmd = BATADV_CMD_GET_DAT_CACHE,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.dumpit = batadv_netlink_dump_dat_cache,
+	},
+	{
+		.cmd = BATADV_CMD_GET_GATEWAYS,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.dumpit = batadv_netlink_dump_gw,
+	},
+	{
+		.cmd = BATADV_CMD_TP_METER,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.doit = batadv_netlink_tp_meter_start,
+	},
+	{
+		.cmd = BATADV_CMD_TP_METER_CANCEL,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.doit = batadv_netlink_tp_meter_cancel,
+	},
+	{
+		.cmd = BATADV_CMD_GET_TP_METER,
+		.flags = GENL_ADMIN_PERM,
+		.policy = batadv_netlink_policy,
+		.dumpit = batadv_netlink_dump_tp_meter,
+	},
+};
+
+/**
+ * batadv_netlink_register - register batadv genl netlink family
+ *
+ * Return: 0 on success or negative error number in case of failure
+ */
+int __init batadv_netlink_register(void)
+{
+	int ret;
+
+	ret = genl_register_family_with_ops(&batadv_netlink_family,
+					    batadv_netlink_ops);
+	if (ret)
+		pr_err("unable to register netlink family: %i\n", ret);
+
+	return ret;
+}
+
+/**
+ * batadv_netlink_unregister - unregister batadv genl netlink family
+ */
+void batadv_netlink_unregister(void)
+{
+	genl_unregister_family(&batadv_netlink_family);
+}
@@ -0,0 +1,32 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NET_BATMAN_ADV_NETLINK_H_
+#define _NET_BATMAN_ADV_NETLINK_H_
+
+#include "main.h"
+
+#include <linux/types.h>
+
+struct netlink_callback;
+struct sk_buff;
+
+int batadv_netlink_register(void);
+void batadv_netlink_unregister(void);
+
+void *batadv_netlink_hdr_put(struct sk_buff *msg, struct netlink_callback *cb,
+			     u8 cmd);
+
+#endif /* _NET_BATMAN_ADV_NETLINK_H_ */
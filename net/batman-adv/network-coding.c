@@ -1819,20 +1819,26 @@ static int batadv_nc_recv_coded_packet(struct sk_buff *skb,
 	int hdr_size = sizeof(*coded_packet);
 
 	/* Check if network coding is enabled */
-	if (!atomic_read(&bat_priv->network_coding))
+	if (!atomic_read(&bat_priv->network_coding)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_DISABLED);
 		return NET_RX_DROP;
+	}
 
 	/* Make sure we can access (and remove) header */
-	if (unlikely(!pskb_may_pull(skb, hdr_size)))
+	if (unlikely(!pskb_may_pull(skb, hdr_size))) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		return NET_RX_DROP;
+	}
 
 	coded_packet = (struct batadv_coded_packet *)skb->data;
 	ethhdr = eth_hdr(skb);
 
 	/* Verify frame is destined for us */
 	if (!batadv_is_my_mac(bat_priv, ethhdr->h_dest) &&
-	    !batadv_is_my_mac(bat_priv, coded_packet->second_dest))
+	    !batadv_is_my_mac(bat_priv, coded_packet->second_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOT_FOR_ME);
 		return NET_RX_DROP;
+	}
 
 	/* Update stat counter */
 	if (batadv_is_my_mac(bat_priv, coded_packet->second_dest))
@@ -28,11 +28,17 @@
 #include <linux/list.h>
 #include <linux/lockdep.h>
 #include <linux/netdevice.h>
+#include <linux/netlink.h>
 #include <linux/rculist.h>
+#include <linux/rcupdate.h>
 #include <linux/seq_file.h>
+#include <linux/skbuff.h>
 #include <linux/slab.h>
 #include <linux/spinlock.h>
 #include <linux/workqueue.h>
+#include <net/genetlink.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "distributed-arp-table.h"
 #include "fragmentation.h"
@@ -40,8 +46,11 @@
 #include "hard-interface.h"
 #include "hash.h"
 #include "multicast.h"
+#include "netlink.h"
 #include "network-coding.h"
 #include "routing.h"
+#include "send.h"
+#include "traffic.h"
 #include "translation-table.h"
 
 /* hash class keys */
@@ -160,6 +169,280 @@ void batadv_orig_node_vlan_put(struct batadv_orig_node_vlan *orig_vlan)
 	kref_put(&orig_vlan->refcount, batadv_orig_node_vlan_release);
 }
 
+/**
+ * batadv_ifinfo_slot - get the lookup array slot of an outgoing interface
+ * @if_outgoing: the outgoing interface (or BATADV_IF_DEFAULT)
+ *
+ * Return: the index used by @if_outgoing in the ifinfo lookup arrays or -1 if
+ * the interface has no interface number assigned.
+ */
+static int batadv_ifinfo_slot(const struct batadv_hard_iface *if_outgoing)
+{
+	if (if_outgoing == BATADV_IF_DEFAULT)
+		return 0;
+
+	if (if_outgoing->if_num < 0)
+		return -1;
+
+	return if_outgoing->if_num + 1;
+}
+
+/**
+ * batadv_ifinfo_table_size - get the number of slots for a new lookup array
+ * @bat_priv: the bat priv with all the soft interface information
+ * @slot: the slot which has to be covered by the new array
+ *
+ * Return: number of slots to allocate, big enough for all interfaces which are
+ * currently part of the mesh to avoid a reallocation per added ifinfo.
+ */
+static unsigned int batadv_ifinfo_table_size(struct batadv_priv *bat_priv,
+					     int slot)
+{
+	return max_t(unsigned int, slot + 1, bat_priv->num_ifaces + 1);
+}
+
+/**
+ * batadv_orig_ifinfo_table_set - store an orig_ifinfo in the lookup array
+ * @orig_node: the orig node the ifinfo belongs to
+ * @orig_ifinfo: the orig_ifinfo to store
+ *
+ * The array is replaced by a larger copy in case the slot of the outgoing
+ * interface is not covered yet. A failed allocation is not fatal because the
+ * ifinfo_list stays the authoritative source for all lookups.
+ */
+static void batadv_orig_ifinfo_table_set(struct batadv_orig_node *orig_node,
+					 struct batadv_orig_ifinfo *orig_ifinfo)
+{
+	struct batadv_orig_ifinfo_table *table, *new_table;
+	struct batadv_orig_ifinfo *tmp;
+	unsigned int num_slots, i;
+	int slot;
+
+	lockdep_assert_held(&orig_node->neigh_list_lock);
+
+	slot = batadv_ifinfo_slot(orig_ifinfo->if_outgoing);
+	if (slot < 0)
+		return;
+
+	table = rcu_dereference_protected(orig_node->ifinfo_table, true);
+	if (table && slot < table->num_slots)
+		goto set;
+
+	num_slots = batadv_ifinfo_table_size(orig_node->bat_priv, slot);
+	new_table = kzalloc(sizeof(*new_table) +
+			    num_slots * sizeof(new_table->slots[0]),
+			    GFP_ATOMIC);
+	if (!new_table)
+		return;
+
+	new_table->num_slots = num_slots;
+	for (i = 0; table && i < table->num_slots; i++) {
+		tmp = rcu_dereference_protected(table->slots[i], true);
+		RCU_INIT_POINTER(new_table->slots[i], tmp);
+	}
+
+	rcu_assign_pointer(orig_node->ifinfo_table, new_table);
+	if (table)
+		kfree_rcu(table, rcu);
+
+	table = new_table;
+
+set:
+	rcu_assign_pointer(table->slots[slot], orig_ifinfo);
+}
+
+/**
+ * batadv_orig_ifinfo_table_clear - remove an orig_ifinfo from the lookup array
+ * @orig_node: the orig node the ifinfo belongs to
+ * @orig_ifinfo: the orig_ifinfo to remove
+ */
+static void
+batadv_orig_ifinfo_table_clear(struct batadv_orig_node *orig_node,
+			       struct batadv_orig_ifinfo *orig_ifinfo)
+{
+	struct batadv_orig_ifinfo_table *table;
+	unsigned int i;
+
+	lockdep_assert_held(&orig_node->neigh_list_lock);
+
+	table = rcu_dereference_protected(orig_node->ifinfo_table, true);
+	if (!table)
+		return;
+
+	for (i = 0; i < table->num_slots; i++) {
+		if (rcu_access_pointer(table->slots[i]) != orig_ifinfo)
+			continue;
+
+		RCU_INIT_POINTER(table->slots[i], NULL);
+	}
+}
+
+/**
+ * batadv_neigh_ifinfo_table_set - store a neigh_ifinfo in the lookup array
+ * @neigh: the neigh node the ifinfo belongs to
+ * @neigh_ifinfo: the neigh_ifinfo to store
+ *
+ * The array is replaced by a larger copy in case the slot of the outgoing
+ * interface is not covered yet. A failed allocation is not fatal because the
+ * ifinfo_list stays the authoritative source for all lookups.
+ */
+static void
+batadv_neigh_ifinfo_table_set(struct batadv_neigh_node *neigh,
+			      struct batadv_neigh_ifinfo *neigh_ifinfo)
+{
+	struct batadv_neigh_ifinfo_table *table, *new_table;
+	struct batadv_neigh_ifinfo *tmp;
+	unsigned int num_slots, i;
+	int slot;
+
+	lockdep_assert_held(&neigh->ifinfo_lock);
+
+	slot = batadv_ifinfo_slot(neigh_ifinfo->if_outgoing);
+	if (slot < 0)
+		return;
+
+	table = rcu_dereference_protected(neigh->ifinfo_table, true);
+	if (table && slot < table->num_slots)
+		goto set;
+
+	num_slots = batadv_ifinfo_table_size(neigh->orig_node->bat_priv, slot);
+	new_table = kzalloc(sizeof(*new_table) +
+			    num_slots * sizeof(new_table->slots[0]),
+			    GFP_ATOMIC);
+	if (!new_table)
+		return;
+
+	new_table->num_slots = num_slots;
+	for (i = 0; table && i < table->num_slots; i++) {
+		tmp = rcu_dereference_protected(table->slots[i], true);
+		RCU_INIT_POINTER(new_table->slots[i], tmp);
+	}
+
+	rcu_assign_pointer(neigh->ifinfo_table, new_table);
+	if (table)
+		kfree_rcu(table, rcu);
+
+	table = new_table;
+
+set:
+	rcu_assign_pointer(table->slots[slot], neigh_ifinfo);
+}
+
+/**
+ * batadv_neigh_ifinfo_table_clear - remove a neigh_ifinfo from the lookup
+ *  array
+ * @neigh: the neigh node the ifinfo belongs to
+ * @neigh_ifinfo: the neigh_ifinfo to remove
+ */
+static void
+batadv_neigh_ifinfo_table_clear(struct batadv_neigh_node *neigh,
+				struct batadv_neigh_ifinfo *neigh_ifinfo)
+{
+	struct batadv_neigh_ifinfo_table *table;
+	unsigned int i;
+
+	lockdep_assert_held(&neigh->ifinfo_lock);
+
+	table = rcu_dereference_protected(neigh->ifinfo_table, true);
+	if (!table)
+		return;
+
+	for (i = 0; i < table->num_slots; i++) {
+		if (rcu_access_pointer(table->slots[i]) != neigh_ifinfo)
+			continue;
+
+		RCU_INIT_POINTER(table->slots[i], NULL);
+	}
+}
+
+/**
+ * batadv_orig_ifinfo_table_del_slot - close the gap left by a removed interface
+ * @orig_node: the orig node whose lookup array has to be adjusted
+ * @del_slot: the slot of the interface being removed
+ */
+static void
+batadv_orig_ifinfo_table_del_slot(struct batadv_orig_node *orig_node,
+				  unsigned int del_slot)
+{
+	struct batadv_orig_ifinfo_table *table;
+	struct batadv_orig_ifinfo *next;
+	unsigned int i;
+
+	lockdep_assert_held(&orig_node->neigh_list_lock);
+
+	table = rcu_dereference_protected(orig_node->ifinfo_table, true);
+	if (!table)
+		return;
+
+	for (i = del_slot; i < table->num_slots; i++) {
+		next = NULL;
+		if (i + 1 < table->num_slots)
+			next = rcu_dereference_protected(table->slots[i + 1],
+							 true);
+
+		RCU_INIT_POINTER(table->slots[i], next);
+	}
+}
+
+/**
+ * batadv_neigh_ifinfo_table_del_slot - close the gap left by a removed
+ *  interface
+ * @neigh: the neigh node whose lookup array has to be adjusted
+ * @del_slot: the slot of the interface being removed
+ */
+static void batadv_neigh_ifinfo_table_del_slot(struct batadv_neigh_node *neigh,
+					       unsigned int del_slot)
+{
+	struct batadv_neigh_ifinfo_table *table;
+	struct batadv_neigh_ifinfo *next;
+	unsigned int i;
+
+	lockdep_assert_held(&neigh->ifinfo_lock);
+
+	table = rcu_dereference_protected(neigh->ifinfo_table, true);
+	if (!table)
+		return;
+
+	for (i = del_slot; i < table->num_slots; i++) {
+		next = NULL;
+		if (i + 1 < table->num_slots)
+			next = rcu_dereference_protected(table->slots[i + 1],
+							 true);
+
+		RCU_INIT_POINTER(table->slots[i], next);
+	}
+}
+
+/**
+ * batadv_orig_ifinfo_tables_del_if - adjust the lookup arrays of an originator
+ *  and its neighbors to a removed interface
+ * @orig_node: the orig node whose lookup arrays have to be adjusted
+ * @del_if_num: the index of the interface being removed
+ *
+ * All interfaces with a higher if_num than the removed one are renumbered
+ * afterwards. Their entries are therefore moved down by one slot. Concurrent
+ * readers may observe an entry twice during the move but always verify the
+ * outgoing interface of the found entry.
+ */
+static void batadv_orig_ifinfo_tables_del_if(struct batadv_orig_node *orig_node,
+					     int del_if_num)
+{
+	struct batadv_neigh_node *neigh_node;
+	unsigned int del_slot = del_if_num + 1;
+
+	spin_lock_bh(&orig_node->neigh_list_lock);
+
+	batadv_orig_ifinfo_table_del_slot(orig_node, del_slot);
+
+	hlist_for_each_entry(neigh_node, &orig_node->neigh_list, list) {
+		spin_lock_bh(&neigh_node->ifinfo_lock);
+		batadv_neigh_ifinfo_table_del_slot(neigh_node, del_slot);
+		spin_unlock_bh(&neigh_node->ifinfo_lock);
+	}
+
+	spin_unlock_bh(&orig_node->neigh_list_lock);
+}
+
 int batadv_originator_init(struct batadv_priv *bat_priv)
 {
 	if (bat_priv->orig_hash)
@@ -241,6 +524,20 @@ void batadv_hardif_neigh_put(struct batadv_hardif_neigh_node *hardif_neigh)
 	kref_put(&hardif_neigh->refcount, batadv_hardif_neigh_release);
 }
 
+/**
+ * batadv_neigh_node_free_rcu - free the neigh_node
+ * @rcu: rcu pointer of the neigh_node
+ */
+static void batadv_neigh_node_free_rcu(struct rcu_head *rcu)
+{
+	struct batadv_neigh_node *neigh_node;
+
+	neigh_node = container_of(rcu, struct batadv_neigh_node, rcu);
+
+	batadv_traffic_neigh_free(neigh_node);
+	kfree(neigh_node);
+}
+
 /**
  * batadv_neigh_node_release - release neigh_node from lists and queue for
  *  free after rcu grace period
@@ -252,6 +549,7 @@ static void batadv_neigh_node_release(struct kref *ref)
 	struct batadv_neigh_node *neigh_node;
 	struct batadv_hardif_neigh_node *hardif_neigh;
 	struct batadv_neigh_ifinfo *neigh_ifinfo;
+	struct batadv_neigh_ifinfo_table *table;
 	struct batadv_algo_ops *bao;
 
 	neigh_node = container_of(ref, struct batadv_neigh_node, refcount);
@@ -262,6 +560,11 @@ static void batadv_neigh_node_release(struct kref *ref)
 		batadv_neigh_ifinfo_put(neigh_ifinfo);
 	}
 
+	/* this is the last reference to this object */
+	table = rcu_dereference_protected(neigh_node->ifinfo_table, true);
+	if (table)
+		kfree_rcu(table, rcu);
+
 	hardif_neigh = batadv_hardif_neigh_get(neigh_node->if_incoming,
 					       neigh_node->addr);
 	if (hardif_neigh) {
@@ -275,7 +578,7 @@ static void batadv_neigh_node_release(struct kref *ref)
 
 	batadv_hardif_put(neigh_node->if_incoming);
 
-	kfree_rcu(neigh_node, rcu);
+	call_rcu(&neigh_node->rcu, batadv_neigh_node_free_rcu);
 }
 
 /**
@@ -288,6 +591,80 @@ void batadv_neigh_node_put(struct batadv_neigh_node *neigh_node)
 	kref_put(&neigh_node->refcount, batadv_neigh_node_release);
 }
 
+/**
+ * batadv_orig_ifinfo_find - find the ifinfo of an outgoing interface
+ * @orig_node: the orig node to be queried
+ * @if_outgoing: the interface for which the ifinfo should be found
+ *
+ * The lookup array is consulted first. Its entry is only used when it belongs
+ * to @if_outgoing - in all other cases (no entry yet or interface renumbering
+ * in progress) the ifinfo_list is searched instead.
+ *
+ * Must be called while holding an rcu lock.
+ *
+ * Return: the orig_ifinfo or NULL if not found. The refcounter is not
+ * increased.
+ */
+static struct batadv_orig_ifinfo *
+batadv_orig_ifinfo_find(struct batadv_orig_node *orig_node,
+			const struct batadv_hard_iface *if_outgoing)
+{
+	struct batadv_orig_ifinfo_table *table;
+	struct batadv_orig_ifinfo *orig_ifinfo;
+	int slot = batadv_ifinfo_slot(if_outgoing);
+
+	table = rcu_dereference(orig_node->ifinfo_table);
+	if (table && slot >= 0 && slot < table->num_slots) {
+		orig_ifinfo = rcu_dereference(table->slots[slot]);
+		if (orig_ifinfo && orig_ifinfo->if_outgoing == if_outgoing)
+			return orig_ifinfo;
+	}
+
+	hlist_for_each_entry_rcu(orig_ifinfo, &orig_node->ifinfo_list, list) {
+		if (orig_ifinfo->if_outgoing == if_outgoing)
+			return orig_ifinfo;
+	}
+
+	return NULL;
+}
+
+/**
+ * batadv_neigh_ifinfo_find - find the ifinfo of an outgoing interface
+ * @neigh: the neigh node to be queried
+ * @if_outgoing: the interface for which the ifinfo should be found
+ *
+ * The lookup array is consulted first. Its entry is only used when it belongs
+ * to @if_outgoing - in all other cases (no entry yet or interface renumbering
+ * in progress) the ifinfo_list is searched instead.
+ *
+ * Must be called while holding an rcu lock.
+ *
+ * Return: the neigh_ifinfo or NULL if not found. The refcounter is not
+ * increased.
+ */
+static struct batadv_neigh_ifinfo *
+batadv_neigh_ifinfo_find(struct batadv_neigh_node *neigh,
+			 const struct batadv_hard_iface *if_outgoing)
+{
+	struct batadv_neigh_ifinfo_table *table;
+	struct batadv_neigh_ifinfo *neigh_ifinfo;
+	int slot = batadv_ifinfo_slot(if_outgoing);
+
+	table = rcu_dereference(neigh->ifinfo_table);
+	if (table && slot >= 0 && slot < table->num_slots) {
+		neigh_ifinfo = rcu_dereference(table->slots[slot]);
+		if (neigh_ifinfo && neigh_ifinfo->if_outgoing == if_outgoing)
+			return neigh_ifinfo;
+	}
+
+	hlist_for_each_entry_rcu(neigh_ifinfo, &neigh->ifinfo_list, list) {
+		if (neigh_ifinfo->if_outgoing == if_outgoing)
+			return neigh_ifinfo;
+	}
+
+	return NULL;
+}
+
 /**
  * batadv_orig_node_get_router - router to the originator depending on iface
  * @orig_node: the orig node for the router
@@ -306,13 +683,9 @@ batadv_orig_router_get(struct batadv_orig_node *orig_node,
 	struct batadv_neigh_node *router = NULL;
 
 	rcu_read_lock();
-	hlist_for_each_entry_rcu(orig_ifinfo, &orig_node->ifinfo_list, list) {
-		if (orig_ifinfo->if_outgoing != if_outgoing)
-			continue;
-
+	orig_ifinfo = batadv_orig_ifinfo_find(orig_node, if_outgoing);
+	if (orig_ifinfo)
 		router = rcu_dereference(orig_ifinfo->router);
-		break;
-	}
 
 	if (router && !kref_get_unless_zero(&router->refcount))
 		router = NULL;
@@ -334,20 +707,12 @@ struct batadv_orig_ifinfo *
 batadv_orig_ifinfo_get(struct batadv_orig_node *orig_node,
 		       struct batadv_hard_iface *if_outgoing)
 {
-	struct batadv_orig_ifinfo *tmp, *orig_ifinfo = NULL;
+	struct batadv_orig_ifinfo *orig_ifinfo;
 
 	rcu_read_lock();
-	hlist_for_each_entry_rcu(tmp, &orig_node->ifinfo_list,
-				 list) {
-		if (tmp->if_outgoing != if_outgoing)
-			continue;
-
-		if (!kref_get_unless_zero(&tmp->refcount))
-			continue;
-
-		orig_ifinfo = tmp;
-		break;
-	}
+	orig_ifinfo = batadv_orig_ifinfo_find(orig_node, if_outgoing);
+	if (orig_ifinfo && !kref_get_unless_zero(&orig_ifinfo->refcount))
+		orig_ifinfo = NULL;
 	rcu_read_unlock();
 
 	return orig_ifinfo;
@@ -397,6 +762,7 @@ batadv_orig_ifinfo_new(struct batadv_orig_node *orig_node,
 	kref_get(&orig_ifinfo->refcount);
 	hlist_add_head_rcu(&orig_ifinfo->list,
 			   &orig_node->ifinfo_list);
+	batadv_orig_ifinfo_table_set(orig_node, orig_ifinfo);
 out:
 	spin_unlock_bh(&orig_node->neigh_list_lock);
 	return orig_ifinfo;
@@ -415,21 +781,12 @@ struct batadv_neigh_ifinfo *
 batadv_neigh_ifinfo_get(struct batadv_neigh_node *neigh,
 			struct batadv_hard_iface *if_outgoing)
 {
-	struct batadv_neigh_ifinfo *neigh_ifinfo = NULL,
-				   *tmp_neigh_ifinfo;
+	struct batadv_neigh_ifinfo *neigh_ifinfo;
 
 	rcu_read_lock();
-	hlist_for_each_entry_rcu(tmp_neigh_ifinfo, &neigh->ifinfo_list,
-				 list) {
-		if (tmp_neigh_ifinfo->if_outgoing != if_outgoing)
-			continue;
-
-		if (!kref_get_unless_zero(&tmp_neigh_ifinfo->refcount))
-			continue;
-
-		neigh_ifinfo = tmp_neigh_ifinfo;
-		break;
-	}
+	neigh_ifinfo = batadv_neigh_ifinfo_find(neigh, if_outgoing);
+	if (neigh_ifinfo && !kref_get_unless_zero(&neigh_ifinfo->refcount))
+		neigh_ifinfo = NULL;
 	rcu_read_unlock();
 
 	return neigh_ifinfo;
@@ -474,6 +831,7 @@ batadv_neigh_ifinfo_new(struct batadv_neigh_node *neigh,
 	neigh_ifinfo->if_outgoing = if_outgoing;
 
 	hlist_add_head_rcu(&neigh_ifinfo->list, &neigh->ifinfo_list);
+	batadv_neigh_ifinfo_table_set(neigh, neigh_ifinfo);
 
 out:
 	spin_unlock_bh(&neigh->ifinfo_lock);
@@ -663,6 +1021,7 @@ batadv_neigh_node_new(struct batadv_orig_node *orig_node,
 	ether_addr_copy(neigh_node->addr, neigh_addr);
 	neigh_node->if_incoming = hard_iface;
 	neigh_node->orig_node = orig_node;
+	batadv_traffic_neigh_init(neigh_node);
 
 	/* extra reference for return */
 	kref_init(&neigh_node->refcount);
@@ -679,6 +1038,8 @@ batadv_neigh_node_new(struct batadv_orig_node *orig_node,
 		   "Creating new neighbor %pM for orig_node %pM on interface %s\n",
 		   neigh_addr, orig_node->orig, hard_iface->net_dev->name);
 
+	batadv_ogm_interval_churn(orig_node->bat_priv);
+
 out:
 	if (hardif_neigh)
 		batadv_hardif_neigh_put(hardif_neigh);
@@ -769,7 +1130,9 @@ static void batadv_orig_node_free_rcu(struct rcu_head *rcu)
 	if (orig_node->bat_priv->bat_algo_ops->bat_orig_free)
 		orig_node->bat_priv->bat_algo_ops->bat_orig_free(orig_node);
 
+	kfree(rcu_dereference_protected(orig_node->ifinfo_table, true));
 	kfree(orig_node->tt_buff);
+	batadv_traffic_orig_free(orig_node);
 	kfree(orig_node);
 }
 
@@ -799,6 +1162,7 @@ static void batadv_orig_node_release(struct kref *ref)
 	hlist_for_each_entry_safe(orig_ifinfo, node_tmp,
 				  &orig_node->ifinfo_list, list) {
 		hlist_del_rcu(&orig_ifinfo->list);
+		batadv_orig_ifinfo_table_clear(orig_node, orig_ifinfo);
 		batadv_orig_ifinfo_put(orig_ifinfo);
 	}
 	spin_unlock_bh(&orig_node->neigh_list_lock);
@@ -925,6 +1289,8 @@ struct batadv_orig_node *batadv_orig_node_new(struct batadv_priv *bat_priv,
 		orig_node->fragments[i].size = 0;
 	}
 
+	batadv_traffic_orig_init(orig_node);
+
 	return orig_node;
 free_orig_node:
 	kfree(orig_node);
@@ -966,6 +1332,7 @@ batadv_purge_neigh_ifinfo(struct batadv_priv *bat_priv,
 			   neigh->addr, if_outgoing->net_dev->name);
 
 		hlist_del_rcu(&neigh_ifinfo->list);
+		batadv_neigh_ifinfo_table_clear(neigh, neigh_ifinfo);
 		batadv_neigh_ifinfo_put(neigh_ifinfo);
 	}
 
@@ -1012,6 +1379,7 @@ batadv_purge_orig_ifinfo(struct batadv_priv *bat_priv,
 		ifinfo_purged = true;
 
 		hlist_del_rcu(&orig_ifinfo->list);
+		batadv_orig_ifinfo_table_clear(orig_node, orig_ifinfo);
 		batadv_orig_ifinfo_put(orig_ifinfo);
 		if (orig_node->last_bonding_candidate == orig_ifinfo) {
 			orig_node->last_bonding_candidate = NULL;
@@ -1140,6 +1508,7 @@ static bool batadv_purge_orig_node(struct batadv_priv *bat_priv,
 			   "Originator timeout: originator %pM, last_seen %u\n",
 			   orig_node->orig,
 			   jiffies_to_msecs(orig_node->last_seen));
+		batadv_ogm_interval_churn(bat_priv);
 		return true;
 	}
 	changed_ifinfo = batadv_purge_orig_ifinfo(bat_priv, orig_node);
@@ -1148,6 +1517,8 @@ static bool batadv_purge_orig_node(struct batadv_priv *bat_priv,
 	if (!changed_ifinfo && !changed_neigh)
 		return false;
 
+	batadv_ogm_interval_churn(bat_priv);
+
 	/* first for NULL ... */
 	best_neigh_node = batadv_find_best_neighbor(bat_priv, orig_node,
 						    BATADV_IF_DEFAULT);
@@ -1225,6 +1596,7 @@ static void batadv_purge_orig(struct work_struct *work)
 	delayed_work = container_of(work, struct delayed_work, work);
 	bat_priv = container_of(delayed_work, struct batadv_priv, orig_work);
 	_batadv_purge_orig(bat_priv);
+	batadv_forward_pps_update(bat_priv);
 	queue_delayed_work(batadv_event_workqueue,
 			   &bat_priv->orig_work,
 			   msecs_to_jiffies(BATADV_ORIG_WORK_PERIOD));
@@ -1264,6 +1636,171 @@ int batadv_orig_seq_print_text(struct seq_file *seq, void *offset)
 	return 0;
 }
 
+/**
+ * batadv_orig_dump_entry - add an originator/neighbor pair to a netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @orig_node: the originator to add
+ * @neigh_node: a potential next hop towards @orig_node
+ * @best: whether @neigh_node is the selected router
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int
+batadv_orig_dump_entry(struct sk_buff *msg, struct netlink_callback *cb,
+		       struct batadv_priv *bat_priv,
+		       struct batadv_orig_node *orig_node,
+		       struct batadv_neigh_node *neigh_node, bool best)
+{
+	struct batadv_algo_ops *bao = bat_priv->bat_algo_ops;
+	struct net_device *net_dev = neigh_node->if_incoming->net_dev;
+	unsigned int last_seen_msecs;
+	void *hdr;
+
+	last_seen_msecs = jiffies_to_msecs(jiffies - orig_node->last_seen);
+
+	hdr = batadv_netlink_hdr_put(msg, cb, BATADV_CMD_GET_ORIGINATORS);
+	if (!hdr)
+		return -EMSGSIZE;
+
+	if (nla_put(msg, BATADV_ATTR_ORIG_ADDRESS, ETH_ALEN,
+		    orig_node->orig) ||
+	    nla_put(msg, BATADV_ATTR_NEIGH_ADDRESS, ETH_ALEN,
+		    neigh_node->addr) ||
+	    nla_put_u32(msg, BATADV_ATTR_HARD_IFINDEX, net_dev->ifindex) ||
+	    nla_put_u32(msg, BATADV_ATTR_LAST_SEEN_MSECS, last_seen_msecs))
+		goto nla_put_failure;
+
+	if (bao->bat_neigh_dump_metric &&
+	    bao->bat_neigh_dump_metric(msg, neigh_node, BATADV_IF_DEFAULT))
+		goto nla_put_failure;
+
+	if (batadv_traffic_dump(msg, orig_node, neigh_node))
+		goto nla_put_failure;
+
+	if (best && nla_put_flag(msg, BATADV_ATTR_FLAG_BEST))
+		goto nla_put_failure;
+
+	genlmsg_end(msg, hdr);
+	return 0;
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	return -EMSGSIZE;
+}
+
+/**
+ * batadv_orig_dump_neighs - add all neighbors of an originator to a dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @orig_node: the originator to add
+ * @sub_s: number of neighbors already dumped in a previous message
+ *
+ * Originators without a router are skipped like in the debugfs table. Caller
+ * must hold rcu_read_lock().
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left. @sub_s is
+ * updated to the neighbor which has to be dumped next.
+ */
+static int batadv_orig_dump_neighs(struct sk_buff *msg,
+				   struct netlink_callback *cb,
+				   struct batadv_priv *bat_priv,
+				   struct batadv_orig_node *orig_node,
+				   int *sub_s)
+{
+	struct batadv_neigh_node *neigh_node, *router;
+	int sub = 0;
+	int ret = 0;
+
+	router = batadv_orig_router_get(orig_node, BATADV_IF_DEFAULT);
+	if (!router)
+		return 0;
+
+	hlist_for_each_entry_rcu(neigh_node, &orig_node->neigh_list, list) {
+		if (sub++ < *sub_s)
+			continue;
+
+		ret = batadv_orig_dump_entry(msg, cb, bat_priv, orig_node,
+					     neigh_node, neigh_node == router);
+		if (ret < 0) {
+			*sub_s = sub - 1;
+			goto out;
+		}
+	}
+
+	*sub_s = 0;
+out:
+	batadv_neigh_node_put(router);
+	return ret;
+}
+
+/**
+ * batadv_orig_dump - dump the originator table to a netlink socket
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @filter: filter of the dump request
+ *
+ * Only a single hash bucket is walked per rcu_read_lock() section. When an
+ * originator is requested, only its bucket is visited at all.
+ *
+ * Return: always 0 - the dump position is kept in cb->args
+ */
+int batadv_orig_dump(struct sk_buff *msg, struct netlink_callback *cb,
+		     struct batadv_priv *bat_priv,
+		     const struct batadv_netlink_filter *filter)
+{
+	struct batadv_hashtable *hash = bat_priv->orig_hash;
+	struct batadv_orig_node *orig_node;
+	u32 bucket = cb->args[0];
+	int idx_s = cb->args[1];
+	int sub_s = cb->args[2];
+	struct hlist_head *head;
+	u32 end = hash->size;
+	int idx;
+
+	if (filter->orig_set) {
+		end = batadv_choose_orig(filter->orig, hash->size);
+		if (bucket < end)
+			bucket = end;
+		end++;
+	}
+
+	for (; bucket < end; bucket++) {
+		head = &hash->table[bucket];
+		idx = 0;
+
+		rcu_read_lock();
+		hlist_for_each_entry_rcu(orig_node, head, hash_entry) {
+			if (idx++ < idx_s)
+				continue;
+
+			if (filter->orig_set &&
+			    !batadv_compare_eth(orig_node->orig, filter->orig))
+				continue;
+
+			if (batadv_orig_dump_neighs(msg, cb, bat_priv,
+						    orig_node, &sub_s)) {
+				rcu_read_unlock();
+				idx_s = idx - 1;
+				goto out;
+			}
+		}
+		rcu_read_unlock();
+
+		idx_s = 0;
+	}
+
+out:
+	cb->args[0] = bucket;
+	cb->args[1] = idx_s;
+	cb->args[2] = sub_s;
+
+	return 0;
+}
+
 /**
  * batadv_orig_hardif_seq_print_text - writes originator infos for a specific
  *  outgoing interface
@@ -1310,42 +1847,6 @@ out:
 	return 0;
 }
 
-int batadv_orig_hash_add_if(struct batadv_hard_iface *hard_iface,
-			    int max_if_num)
-{
-	struct batadv_priv *bat_priv = netdev_priv(hard_iface->soft_iface);
-	struct batadv_algo_ops *bao = bat_priv->bat_algo_ops;
-	struct batadv_hashtable *hash = bat_priv->orig_hash;
-	struct hlist_head *head;
-	struct batadv_orig_node *orig_node;
-	u32 i;
-	int ret;
-
-	/* resize all orig nodes because orig_node->bcast_own(_sum) depend on
-	 * if_num
-	 */
-	for (i = 0; i < hash->size; i++) {
-		head = &hash->table[i];
-
-		rcu_read_lock();
-		hlist_for_each_entry_rcu(orig_node, head, hash_entry) {
-			ret = 0;
-			if (bao->bat_orig_add_if)
-				ret = bao->bat_orig_add_if(orig_node,
-							   max_if_num);
-			if (ret == -ENOMEM)
-				goto err;
-		}
-		rcu_read_unlock();
-	}
-
-	return 0;
-
-err:
-	rcu_read_unlock();
-	return -ENOMEM;
-}
-
 int batadv_orig_hash_del_if(struct batadv_hard_iface *hard_iface,
 			    int max_if_num)
 {
@@ -1358,7 +1859,7 @@ int batadv_orig_hash_del_if(struct batadv_hard_iface *hard_iface,
 	u32 i;
 	int ret;
 
-	/* resize all orig nodes because orig_node->bcast_own(_sum) depend on
+	/* adjust all orig nodes because orig_node->bcast_own(_sum) depend on
 	 * if_num
 	 */
 	for (i = 0; i < hash->size; i++) {
@@ -1366,6 +1867,9 @@ int batadv_orig_hash_del_if(struct batadv_hard_iface *hard_iface,
 
 		rcu_read_lock();
 		hlist_for_each_entry_rcu(orig_node, head, hash_entry) {
+			batadv_orig_ifinfo_tables_del_if(orig_node,
+							 hard_iface->if_num);
+
 			ret = 0;
 			if (bao->bat_orig_del_if)
 				ret = bao->bat_orig_del_if(orig_node,
@@ -93,6 +93,17 @@ enum batadv_icmp_packettype {
 	BATADV_ECHO_REQUEST	       = 8,
 	BATADV_TTL_EXCEEDED	       = 11,
 	BATADV_PARAMETER_PROBLEM       = 12,
+	BATADV_TP		       = 13,
+};
+
+/**
+ * enum batadv_icmp_tp_subtype - ICMP throughput meter subtypes
+ * @BATADV_TP_MSG: message from sender to receiver carrying test data
+ * @BATADV_TP_ACK: cumulative acknowledgement from receiver to sender
+ */
+enum batadv_icmp_tp_subtype {
+	BATADV_TP_MSG	= 0,
+	BATADV_TP_ACK	= 1,
 };
 
 /**
@@ -363,6 +374,54 @@ struct batadv_icmp_packet_rr {
 
 #define BATADV_ICMP_MAX_PACKET_SIZE	sizeof(struct batadv_icmp_packet_rr)
 
+/**
+ * struct batadv_icmp_tp_packet - ICMP throughput meter packet
+ * @packet_type: batman-adv packet type, part of the general header
+ * @version: batman-adv protocol version, part of the genereal header
+ * @ttl: time to live for this packet, part of the genereal header
+ * @msg_type: ICMP packet type
+ * @dst: address of the destination node
+ * @orig: address of the source node
+ * @uid: local ICMP socket identifier
+ * @subtype: TP packet subtype (see batadv_icmp_tp_subtype)
+ * @session: TP session identifier
+ * @seqno: byte offset of the payload (MSG) or next expected byte (ACK)
+ * @timestamp: time of transmission in microseconds as seen by the sender.
+ *  Echoed back unchanged in the ACK
+ */
+struct batadv_icmp_tp_packet {
+	u8     packet_type;
+	u8     version;
+	u8     ttl;
+	u8     msg_type; /* see ICMP message types above */
+	u8     dst[ETH_ALEN];
+	u8     orig[ETH_ALEN];
+	u8     uid;
+	u8     subtype;
+	u8     session[2];
+	__be32 seqno;
+	__be32 timestamp;
+};
+
+/**
+ * struct batadv_icmp_socket_record - framing of an ICMP packet exchanged over
+ *  the batched icmp socket
+ * @timestamp: CLOCK_MONOTONIC time (in ns) at which a received packet was
+ *  queued for the reader. Ignored on write
+ * @len: length of the ICMP packet directly following this header
+ * @reserved: not used - must be zero
+ *
+ * Records are stored back to back, each one padded to a multiple of
+ * BATADV_ICMP_SOCKET_RECORD_ALIGN bytes.
+ */
+struct batadv_icmp_socket_record {
+	u64    timestamp;
+	u16    len;
+	u8     reserved[6];
+};
+
+#define BATADV_ICMP_SOCKET_RECORD_ALIGN	8
+
 /* All packet headers in front of an ethernet header have to be completely
  * divisible by 2 but not by 4 to make the payload after the ethernet
  * header again 4 bytes boundary aligned.
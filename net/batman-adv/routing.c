@@ -25,7 +25,10 @@
 #include <linux/etherdevice.h>
 #include <linux/if_ether.h>
 #include <linux/jiffies.h>
+#include <linux/kernel.h>
 #include <linux/kref.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
 #include <linux/netdevice.h>
 #include <linux/printk.h>
 #include <linux/rculist.h>
@@ -40,11 +43,14 @@
 #include "fragmentation.h"
 #include "hard-interface.h"
 #include "icmp_socket.h"
+#include "latency.h"
 #include "network-coding.h"
 #include "originator.h"
 #include "packet.h"
 #include "send.h"
 #include "soft-interface.h"
+#include "tp_meter.h"
+#include "traffic.h"
 #include "translation-table.h"
 
 static int batadv_route_unicast_packet(struct sk_buff *skb,
@@ -112,6 +118,8 @@ static void _batadv_update_route(struct batadv_priv *bat_priv,
 	/* decrease refcount of previous best neighbor */
 	if (curr_router)
 		batadv_neigh_node_put(curr_router);
+
+	batadv_ogm_interval_churn(bat_priv);
 }
 
 /**
@@ -184,28 +192,38 @@ bool batadv_check_management_packet(struct sk_buff *skb,
 	struct ethhdr *ethhdr;
 
 	/* drop packet if it has not necessary minimum size */
-	if (unlikely(!pskb_may_pull(skb, header_len)))
+	if (unlikely(!pskb_may_pull(skb, header_len))) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		return false;
+	}
 
 	ethhdr = eth_hdr(skb);
 
 	/* packet with broadcast indication but unicast recipient */
-	if (!is_broadcast_ether_addr(ethhdr->h_dest))
+	if (!is_broadcast_ether_addr(ethhdr->h_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		return false;
+	}
 
 	/* packet with broadcast sender address */
-	if (is_broadcast_ether_addr(ethhdr->h_source))
+	if (is_broadcast_ether_addr(ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		return false;
+	}
 
 	/* create a copy of the skb, if needed, to modify it. */
 	if (skb_cow(skb, 0) < 0)
-		return false;
+		goto err_nomem;
 
 	/* keep skb linear */
 	if (skb_linearize(skb) < 0)
-		return false;
+		goto err_nomem;
 
 	return true;
+
+err_nomem:
+	batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
+	return false;
 }
 
 /**
@@ -231,10 +249,14 @@ static int batadv_recv_my_icmp_packet(struct batadv_priv *bat_priv,
 	case BATADV_DESTINATION_UNREACHABLE:
 	case BATADV_TTL_EXCEEDED:
 		/* receive the packet */
-		if (skb_linearize(skb) < 0)
+		if (skb_linearize(skb) < 0) {
+			batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 			break;
+		}
 
 		batadv_socket_receive_packet(icmph, skb->len);
+		consume_skb(skb);
+		ret = NET_RX_SUCCESS;
 		break;
 	case BATADV_ECHO_REQUEST:
 		/* answer echo request (ping) */
@@ -262,6 +284,11 @@ static int batadv_recv_my_icmp_packet(struct batadv_priv *bat_priv,
 		if (res != NET_XMIT_DROP)
 			ret = NET_RX_SUCCESS;
 
+		break;
+	case BATADV_TP:
+		/* the skb is consumed by the throughput meter */
+		batadv_tp_meter_recv(bat_priv, skb);
+		ret = NET_RX_SUCCESS;
 		break;
 	default:
 		/* drop unknown type */
@@ -289,6 +316,7 @@ static int batadv_recv_icmp_ttl_exceeded(struct batadv_priv *bat_priv,
 	if (icmp_packet->msg_type != BATADV_ECHO_REQUEST) {
 		pr_debug("Warning - can't forward icmp packet from %pM to %pM: ttl exceeded\n",
 			 icmp_packet->orig, icmp_packet->dst);
+		batadv_skb_drop_reason(skb, BATADV_DROP_TTL);
 		goto out;
 	}
 
@@ -335,22 +363,30 @@ int batadv_recv_icmp_packet(struct sk_buff *skb,
 	int ret = NET_RX_DROP;
 
 	/* drop packet if it has not necessary minimum size */
-	if (unlikely(!pskb_may_pull(skb, hdr_size)))
+	if (unlikely(!pskb_may_pull(skb, hdr_size))) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		goto out;
+	}
 
 	ethhdr = eth_hdr(skb);
 
 	/* packet with unicast indication but broadcast recipient */
-	if (is_broadcast_ether_addr(ethhdr->h_dest))
+	if (is_broadcast_ether_addr(ethhdr->h_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		goto out;
+	}
 
 	/* packet with broadcast sender address */
-	if (is_broadcast_ether_addr(ethhdr->h_source))
+	if (is_broadcast_ether_addr(ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		goto out;
+	}
 
 	/* not for me */
-	if (!batadv_is_my_mac(bat_priv, ethhdr->h_dest))
+	if (!batadv_is_my_mac(bat_priv, ethhdr->h_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOT_FOR_ME);
 		goto out;
+	}
 
 	icmph = (struct batadv_icmp_header *)skb->data;
 
@@ -358,17 +394,23 @@ int batadv_recv_icmp_packet(struct sk_buff *skb,
 	if ((icmph->msg_type == BATADV_ECHO_REPLY ||
 	     icmph->msg_type == BATADV_ECHO_REQUEST) &&
 	    (skb->len >= sizeof(struct batadv_icmp_packet_rr))) {
-		if (skb_linearize(skb) < 0)
+		if (skb_linearize(skb) < 0) {
+			batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 			goto out;
+		}
 
 		/* create a copy of the skb, if needed, to modify it. */
-		if (skb_cow(skb, ETH_HLEN) < 0)
+		if (skb_cow(skb, ETH_HLEN) < 0) {
+			batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 			goto out;
+		}
 
 		icmph = (struct batadv_icmp_header *)skb->data;
 		icmp_packet_rr = (struct batadv_icmp_packet_rr *)icmph;
-		if (icmp_packet_rr->rr_cur >= BATADV_RR_LEN)
+		if (icmp_packet_rr->rr_cur >= BATADV_RR_LEN) {
+			batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 			goto out;
+		}
 
 		ether_addr_copy(icmp_packet_rr->rr[icmp_packet_rr->rr_cur],
 				ethhdr->h_dest);
@@ -385,12 +427,16 @@ int batadv_recv_icmp_packet(struct sk_buff *skb,
 
 	/* get routing information */
 	orig_node = batadv_orig_hash_find(bat_priv, icmph->dst);
-	if (!orig_node)
+	if (!orig_node) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 		goto out;
+	}
 
 	/* create a copy of the skb, if needed, to modify it. */
-	if (skb_cow(skb, ETH_HLEN) < 0)
+	if (skb_cow(skb, ETH_HLEN) < 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 		goto out;
+	}
 
 	icmph = (struct batadv_icmp_header *)skb->data;
 
@@ -400,6 +446,8 @@ int batadv_recv_icmp_packet(struct sk_buff *skb,
 	/* route it */
 	if (batadv_send_skb_to_orig(skb, orig_node, recv_if) != NET_XMIT_DROP)
 		ret = NET_RX_SUCCESS;
+	else
+		batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 
 out:
 	if (orig_node)
@@ -425,22 +473,30 @@ static int batadv_check_unicast_packet(struct batadv_priv *bat_priv,
 	struct ethhdr *ethhdr;
 
 	/* drop packet if it has not necessary minimum size */
-	if (unlikely(!pskb_may_pull(skb, hdr_size)))
+	if (unlikely(!pskb_may_pull(skb, hdr_size))) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		return -ENODATA;
+	}
 
 	ethhdr = eth_hdr(skb);
 
 	/* packet with unicast indication but broadcast recipient */
-	if (is_broadcast_ether_addr(ethhdr->h_dest))
+	if (is_broadcast_ether_addr(ethhdr->h_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		return -EBADR;
+	}
 
 	/* packet with broadcast sender address */
-	if (is_broadcast_ether_addr(ethhdr->h_source))
+	if (is_broadcast_ether_addr(ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		return -EBADR;
+	}
 
 	/* not for me */
-	if (!batadv_is_my_mac(bat_priv, ethhdr->h_dest))
+	if (!batadv_is_my_mac(bat_priv, ethhdr->h_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOT_FOR_ME);
 		return -EREMOTE;
+	}
 
 	return 0;
 }
@@ -599,18 +655,23 @@ static int batadv_route_unicast_packet(struct sk_buff *skb,
 	if (unicast_packet->ttl < 2) {
 		pr_debug("Warning - can't forward unicast packet from %pM to %pM: ttl exceeded\n",
 			 ethhdr->h_source, unicast_packet->dest);
+		batadv_skb_drop_reason(skb, BATADV_DROP_TTL);
 		goto out;
 	}
 
 	/* get routing information */
 	orig_node = batadv_orig_hash_find(bat_priv, unicast_packet->dest);
 
-	if (!orig_node)
+	if (!orig_node) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 		goto out;
+	}
 
 	/* create a copy of the skb, if needed, to modify it. */
-	if (skb_cow(skb, ETH_HLEN) < 0)
+	if (skb_cow(skb, ETH_HLEN) < 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 		goto out;
+	}
 
 	/* decrement ttl */
 	unicast_packet = (struct batadv_unicast_packet *)skb->data;
@@ -645,6 +706,8 @@ static int batadv_route_unicast_packet(struct sk_buff *skb,
 	} else if (res == NET_XMIT_POLICED) {
 		/* skb was buffered and consumed */
 		ret = NET_RX_SUCCESS;
+	} else {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 	}
 
 out:
@@ -720,12 +783,16 @@ static int batadv_check_unicast_ttvn(struct batadv_priv *bat_priv,
 	int is_old_ttvn;
 
 	/* check if there is enough data before accessing it */
-	if (!pskb_may_pull(skb, hdr_len + ETH_HLEN))
+	if (!pskb_may_pull(skb, hdr_len + ETH_HLEN)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		return 0;
+	}
 
 	/* create a copy of the skb (in case of for re-routing) to modify it. */
-	if (skb_cow(skb, sizeof(*unicast_packet)) < 0)
+	if (skb_cow(skb, sizeof(*unicast_packet)) < 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 		return 0;
+	}
 
 	unicast_packet = (struct batadv_unicast_packet *)skb->data;
 	vid = batadv_get_vid(skb, hdr_len);
@@ -764,8 +831,10 @@ static int batadv_check_unicast_ttvn(struct batadv_priv *bat_priv,
 		 * destination, the packet can immediately be dropped as it will
 		 * not be possible to deliver it
 		 */
-		if (!orig_node)
+		if (!orig_node) {
+			batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 			return 0;
+		}
 
 		curr_ttvn = (u8)atomic_read(&orig_node->last_ttvn);
 		batadv_orig_node_put(orig_node);
@@ -796,8 +865,10 @@ static int batadv_check_unicast_ttvn(struct batadv_priv *bat_priv,
 	 * currently served by this node or there is no destination at all and
 	 * it is possible to drop the packet
 	 */
-	if (!batadv_is_my_client(bat_priv, ethhdr->h_dest, vid))
+	if (!batadv_is_my_client(bat_priv, ethhdr->h_dest, vid)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_TTVN);
 		return 0;
+	}
 
 	/* update the header in order to let the packet be delivered to this
 	 * node's soft interface
@@ -815,6 +886,139 @@ static int batadv_check_unicast_ttvn(struct batadv_priv *bat_priv,
 	return 1;
 }
 
+/**
+ * batadv_route_unicast_fast - forward transit unicast packets
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the unicast packet to forward
+ * @recv_if: interface this packet was received on
+ * @hdr_size: size of the unicast header
+ *
+ * Handles the common case of a transit packet which neither has to be
+ * re-routed (no roaming client, up to date TTVN) nor fragmented. Compared to
+ * batadv_check_unicast_ttvn() followed by batadv_route_unicast_packet() the
+ * destination originator is looked up only once and the header is only made
+ * writable once before being rewritten in place.
+ *
+ * Return: NET_RX_SUCCESS if the packet was forwarded, NET_RX_DROP if it has to
+ * be dropped or -EAGAIN if the packet has to go through the regular receive
+ * path instead.
+ */
+static int batadv_route_unicast_fast(struct batadv_priv *bat_priv,
+				     struct sk_buff *skb,
+				     struct batadv_hard_iface *recv_if,
+				     int hdr_size)
+{
+	struct batadv_unicast_packet *unicast_packet;
+	struct batadv_orig_node *orig_node = NULL;
+	struct batadv_neigh_node *router = NULL;
+	struct ethhdr *ethhdr;
+	unsigned short vid;
+	int ret = -EAGAIN;
+	u8 curr_ttvn;
+	int len, res;
+
+	/* let the regular path handle (and report) an exceeded TTL */
+	unicast_packet = (struct batadv_unicast_packet *)skb->data;
+	if (unicast_packet->ttl < 2)
+		return -EAGAIN;
+
+	if (!pskb_may_pull(skb, hdr_size + ETH_HLEN))
+		return -EAGAIN;
+
+	unicast_packet = (struct batadv_unicast_packet *)skb->data;
+	ethhdr = (struct ethhdr *)(skb->data + hdr_size);
+	vid = batadv_get_vid(skb, hdr_size);
+
+	if (batadv_tt_local_client_is_roaming(bat_priv, ethhdr->h_dest, vid))
+		return -EAGAIN;
+
+	orig_node = batadv_orig_hash_find(bat_priv, unicast_packet->dest);
+	if (!orig_node)
+		return -EAGAIN;
+
+	/* outdated translation table information requires re-routing */
+	curr_ttvn = (u8)atomic_read(&orig_node->last_ttvn);
+	if (batadv_seq_before(unicast_packet->ttvn, curr_ttvn))
+		goto out;
+
+	/* recv_if is never BATADV_IF_DEFAULT here: no bonding is applied and
+	 * the router comes straight from the orig_ifinfo lookup table
+	 */
+	router = batadv_find_router(bat_priv, orig_node, recv_if);
+	if (!router)
+		goto out;
+
+	if (atomic_read(&bat_priv->fragmentation) &&
+	    skb->len > router->if_incoming->net_dev->mtu)
+		goto out;
+
+	ret = NET_RX_DROP;
+
+	/* create a copy of the skb, if needed, to modify it. */
+	if (skb_cow(skb, ETH_HLEN) < 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
+		goto out;
+	}
+
+	unicast_packet = (struct batadv_unicast_packet *)skb->data;
+	unicast_packet->ttl--;
+
+	batadv_skb_set_priority(skb, hdr_size);
+
+	ret = NET_RX_SUCCESS;
+	len = skb->len + ETH_HLEN;
+
+	/* skb was buffered and consumed */
+	if (batadv_nc_skb_forward(skb, router))
+		goto out;
+
+	res = batadv_send_unicast_skb(skb, router);
+
+	/* skb was consumed in any case, only count what was transmitted */
+	if (res != NET_XMIT_SUCCESS) {
+		ret = NET_RX_DROP;
+		goto out;
+	}
+
+	batadv_traffic_count(orig_node, router, true, len);
+	batadv_inc_counter(bat_priv, BATADV_CNT_FORWARD);
+	batadv_add_counter(bat_priv, BATADV_CNT_FORWARD_BYTES, len);
+	batadv_inc_counter(bat_priv, BATADV_CNT_FORWARD_FAST);
+
+out:
+	if (router)
+		batadv_neigh_node_put(router);
+	batadv_orig_node_put(orig_node);
+
+	return ret;
+}
+
+/**
+ * batadv_forward_pps_update - update the forwarded packets per second rate
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Computes the rate of forwarded unicast packets since the previous call.
+ * Expected to be called periodically from the originator purge worker.
+ */
+void batadv_forward_pps_update(struct batadv_priv *bat_priv)
+{
+	unsigned long now = jiffies;
+	unsigned long elapsed;
+	u64 forwarded, pps;
+
+	forwarded = batadv_sum_counter(bat_priv, BATADV_CNT_FORWARD);
+	elapsed = now - bat_priv->forward_last_time;
+
+	if (elapsed && bat_priv->forward_last_time) {
+		pps = div64_u64((forwarded - bat_priv->forward_last_cnt) * HZ,
+				elapsed);
+		atomic_set(&bat_priv->forward_pps, min_t(u64, pps, INT_MAX));
+	}
+
+	bat_priv->forward_last_cnt = forwarded;
+	bat_priv->forward_last_time = now;
+}
+
 /**
  * batadv_recv_unhandled_unicast_packet - receive and process packets which
  *	are in the unicast number space but not yet known to the implementation
@@ -837,14 +1041,16 @@ int batadv_recv_unhandled_unicast_packet(struct sk_buff *skb,
 
 	/* we don't know about this type, drop it. */
 	unicast_packet = (struct batadv_unicast_packet *)skb->data;
-	if (batadv_is_my_mac(bat_priv, unicast_packet->dest))
+	if (batadv_is_my_mac(bat_priv, unicast_packet->dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_UNHANDLED);
 		return NET_RX_DROP;
+	}
 
 	return batadv_route_unicast_packet(skb, recv_if);
 }
 
-int batadv_recv_unicast_packet(struct sk_buff *skb,
-			       struct batadv_hard_iface *recv_if)
+static int __batadv_recv_unicast_packet(struct sk_buff *skb,
+					struct batadv_hard_iface *recv_if)
 {
 	struct batadv_priv *bat_priv = netdev_priv(recv_if->soft_iface);
 	struct batadv_unicast_packet *unicast_packet;
@@ -854,6 +1060,7 @@ int batadv_recv_unicast_packet(struct sk_buff *skb,
 	int check, hdr_size = sizeof(*unicast_packet);
 	enum batadv_subtype subtype;
 	bool is4addr;
+	int ret;
 
 	unicast_packet = (struct batadv_unicast_packet *)skb->data;
 	unicast_4addr_packet = (struct batadv_unicast_4addr_packet *)skb->data;
@@ -874,9 +1081,24 @@ int batadv_recv_unicast_packet(struct sk_buff *skb,
 
 	if (check < 0)
 		return NET_RX_DROP;
+
+	/* transit traffic which needs no special treatment is forwarded
+	 * right away
+	 */
+	unicast_packet = (struct batadv_unicast_packet *)skb->data;
+	if (!batadv_is_my_mac(bat_priv, unicast_packet->dest)) {
+		ret = batadv_route_unicast_fast(bat_priv, skb, recv_if,
+						hdr_size);
+		if (ret != -EAGAIN)
+			return ret;
+	}
+
 	if (!batadv_check_unicast_ttvn(bat_priv, skb, hdr_size))
 		return NET_RX_DROP;
 
+	unicast_packet = (struct batadv_unicast_packet *)skb->data;
+	unicast_4addr_packet = (struct batadv_unicast_4addr_packet *)skb->data;
+
 	/* packet for me */
 	if (batadv_is_my_mac(bat_priv, unicast_packet->dest)) {
 		if (is4addr) {
@@ -902,6 +1124,12 @@ int batadv_recv_unicast_packet(struct sk_buff *skb,
 		if (batadv_dat_snoop_incoming_arp_reply(bat_priv, skb,
 							hdr_size))
 			goto rx_success;
+		if (batadv_dat_snoop_incoming_nd_request(bat_priv, skb,
+							 hdr_size))
+			goto rx_success;
+		if (batadv_dat_snoop_incoming_nd_reply(bat_priv, skb,
+						       hdr_size))
+			goto rx_success;
 
 		batadv_interface_rx(recv_if->soft_iface, skb, recv_if, hdr_size,
 				    orig_node);
@@ -916,6 +1144,19 @@ rx_success:
 	return batadv_route_unicast_packet(skb, recv_if);
 }
 
+int batadv_recv_unicast_packet(struct sk_buff *skb,
+			       struct batadv_hard_iface *recv_if)
+{
+	struct batadv_priv *bat_priv = netdev_priv(recv_if->soft_iface);
+	ktime_t start = batadv_latency_start();
+	int ret;
+
+	ret = __batadv_recv_unicast_packet(skb, recv_if);
+	batadv_latency_stop(bat_priv, BATADV_LATENCY_RX_UNICAST, start);
+
+	return ret;
+}
+
 /**
  * batadv_recv_unicast_tvlv - receive and process unicast tvlv packets
  * @skb: unicast tvlv packet to process
@@ -938,20 +1179,26 @@ int batadv_recv_unicast_tvlv(struct sk_buff *skb,
 		return NET_RX_DROP;
 
 	/* the header is likely to be modified while forwarding */
-	if (skb_cow(skb, hdr_size) < 0)
+	if (skb_cow(skb, hdr_size) < 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 		return NET_RX_DROP;
+	}
 
 	/* packet needs to be linearized to access the tvlv content */
-	if (skb_linearize(skb) < 0)
+	if (skb_linearize(skb) < 0) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NOMEM);
 		return NET_RX_DROP;
+	}
 
 	unicast_tvlv_packet = (struct batadv_unicast_tvlv_packet *)skb->data;
 
 	tvlv_buff = (unsigned char *)(skb->data + hdr_size);
 	tvlv_buff_len = ntohs(unicast_tvlv_packet->tvlv_len);
 
-	if (tvlv_buff_len > skb->len - hdr_size)
+	if (tvlv_buff_len > skb->len - hdr_size) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		return NET_RX_DROP;
+	}
 
 	ret = batadv_tvlv_containers_process(bat_priv, false, NULL,
 					     unicast_tvlv_packet->src,
@@ -984,6 +1231,8 @@ int batadv_recv_frag_packet(struct sk_buff *skb,
 	struct batadv_orig_node *orig_node_src = NULL;
 	struct batadv_frag_packet *frag_packet;
 	int ret = NET_RX_DROP;
+	ktime_t start;
+	bool merged;
 
 	if (batadv_check_unicast_packet(bat_priv, skb,
 					sizeof(*frag_packet)) < 0)
@@ -991,8 +1240,10 @@ int batadv_recv_frag_packet(struct sk_buff *skb,
 
 	frag_packet = (struct batadv_frag_packet *)skb->data;
 	orig_node_src = batadv_orig_hash_find(bat_priv, frag_packet->orig);
-	if (!orig_node_src)
+	if (!orig_node_src) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 		goto out;
+	}
 
 	/* Route the fragment if it is not for us and too big to be merged. */
 	if (!batadv_is_my_mac(bat_priv, frag_packet->dest) &&
@@ -1005,8 +1256,13 @@ int batadv_recv_frag_packet(struct sk_buff *skb,
 	batadv_add_counter(bat_priv, BATADV_CNT_FRAG_RX_BYTES, skb->len);
 
 	/* Add fragment to buffer and merge if possible. */
-	if (!batadv_frag_skb_buffer(&skb, orig_node_src))
+	start = batadv_latency_start();
+	merged = batadv_frag_skb_buffer(&skb, orig_node_src);
+	batadv_latency_stop(bat_priv, BATADV_LATENCY_FRAG, start);
+	if (!merged) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_FRAG);
 		goto out;
+	}
 
 	/* Deliver merged packet to the appropriate handler, if it was
 	 * merged
@@ -1037,36 +1293,53 @@ int batadv_recv_bcast_packet(struct sk_buff *skb,
 	u32 seqno;
 
 	/* drop packet if it has not necessary minimum size */
-	if (unlikely(!pskb_may_pull(skb, hdr_size)))
+	if (unlikely(!pskb_may_pull(skb, hdr_size))) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_MALFORMED);
 		goto out;
+	}
 
 	ethhdr = eth_hdr(skb);
 
 	/* packet with broadcast indication but unicast recipient */
-	if (!is_broadcast_ether_addr(ethhdr->h_dest))
+	if (!is_broadcast_ether_addr(ethhdr->h_dest)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		goto out;
+	}
 
 	/* packet with broadcast sender address */
-	if (is_broadcast_ether_addr(ethhdr->h_source))
+	if (is_broadcast_ether_addr(ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BAD_ADDR);
 		goto out;
+	}
 
 	/* ignore broadcasts sent by myself */
-	if (batadv_is_my_mac(bat_priv, ethhdr->h_source))
+	if (batadv_is_my_mac(bat_priv, ethhdr->h_source)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_OWN);
 		goto out;
+	}
 
 	bcast_packet = (struct batadv_bcast_packet *)skb->data;
 
 	/* ignore broadcasts originated by myself */
-	if (batadv_is_my_mac(bat_priv, bcast_packet->orig))
+	if (batadv_is_my_mac(bat_priv, bcast_packet->orig)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_OWN);
 		goto out;
+	}
 
-	if (bcast_packet->ttl < 2)
+	if (bcast_packet->ttl < 2) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_TTL);
 		goto out;
+	}
 
 	orig_node = batadv_orig_hash_find(bat_priv, bcast_packet->orig);
 
-	if (!orig_node)
+	if (!orig_node) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_NO_ROUTE);
 		goto out;
+	}
+
+	/* broadcasts rejected by the flood history below are duplicates */
+	batadv_skb_drop_reason(skb, BATADV_DROP_DUPLICATE);
 
 	spin_lock_bh(&orig_node->bcast_seqno_lock);
 
@@ -1104,13 +1377,19 @@ int batadv_recv_bcast_packet(struct sk_buff *skb,
 	/* don't hand the broadcast up if it is from an originator
 	 * from the same backbone.
 	 */
-	if (batadv_bla_is_backbone_gw(skb, orig_node, hdr_size))
+	if (batadv_bla_is_backbone_gw(skb, orig_node, hdr_size)) {
+		batadv_skb_drop_reason(skb, BATADV_DROP_BLA);
 		goto out;
+	}
 
 	if (batadv_dat_snoop_incoming_arp_request(bat_priv, skb, hdr_size))
 		goto rx_success;
 	if (batadv_dat_snoop_incoming_arp_reply(bat_priv, skb, hdr_size))
 		goto rx_success;
+	if (batadv_dat_snoop_incoming_nd_request(bat_priv, skb, hdr_size))
+		goto rx_success;
+	if (batadv_dat_snoop_incoming_nd_reply(bat_priv, skb, hdr_size))
+		goto rx_success;
 
 	/* broadcast for me */
 	batadv_interface_rx(recv_if->soft_iface, skb, recv_if, hdr_size,
@@ -51,6 +51,7 @@ struct batadv_neigh_node *
 batadv_find_router(struct batadv_priv *bat_priv,
 		   struct batadv_orig_node *orig_node,
 		   struct batadv_hard_iface *recv_if);
+void batadv_forward_pps_update(struct batadv_priv *bat_priv);
 int batadv_window_protected(struct batadv_priv *bat_priv, s32 seq_num_diff,
 			    s32 seq_old_max_diff, unsigned long *last_reset,
 			    bool *protection_started);
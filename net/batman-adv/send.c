@@ -20,6 +20,7 @@
 
 #include <linux/atomic.h>
 #include <linux/byteorder/generic.h>
+#include <linux/compiler.h>
 #include <linux/etherdevice.h>
 #include <linux/fs.h>
 #include <linux/if_ether.h>
@@ -41,10 +42,12 @@
 #include "fragmentation.h"
 #include "gateway_client.h"
 #include "hard-interface.h"
+#include "latency.h"
 #include "network-coding.h"
 #include "originator.h"
 #include "routing.h"
 #include "soft-interface.h"
+#include "traffic.h"
 #include "translation-table.h"
 
 static void batadv_send_outstanding_bcast_packet(struct work_struct *work);
@@ -163,6 +166,7 @@ int batadv_send_skb_to_orig(struct sk_buff *skb,
 {
 	struct batadv_priv *bat_priv = orig_node->bat_priv;
 	struct batadv_neigh_node *neigh_node;
+	unsigned int len = skb->len + ETH_HLEN;
 	int ret = NET_XMIT_DROP;
 
 	/* batadv_find_router() increases neigh_nodes refcount if found. */
@@ -194,6 +198,9 @@ int batadv_send_skb_to_orig(struct sk_buff *skb,
 	}
 
 out:
+	if (ret == NET_XMIT_SUCCESS)
+		batadv_traffic_count(orig_node, neigh_node, !!recv_if, len);
+
 	if (neigh_node)
 		batadv_neigh_node_put(neigh_node);
 
@@ -427,6 +434,119 @@ int batadv_send_skb_via_gw(struct batadv_priv *bat_priv, struct sk_buff *skb,
 				       orig_node, vid);
 }
 
+/**
+ * batadv_ogm_interval_min - get the shortest own OGM interval of an interface
+ * @bat_priv: the bat priv with all the soft interface information
+ * @hard_iface: the interface the own OGM is scheduled for
+ *
+ * Return: the ogm_interval_min of @hard_iface, or the orig_interval of the
+ *  mesh interface if it is not set.
+ */
+unsigned int batadv_ogm_interval_min(struct batadv_priv *bat_priv,
+				     struct batadv_hard_iface *hard_iface)
+{
+	unsigned int interval = atomic_read(&hard_iface->ogm_interval_min);
+
+	if (!interval)
+		return atomic_read(&bat_priv->orig_interval);
+
+	return interval;
+}
+
+/**
+ * batadv_ogm_interval_churn - report a topology change to the adaptive OGM
+ *  interval
+ * @bat_priv: the bat priv with all the soft interface information
+ *
+ * Every interface falls back to its shortest interval when its next own OGM is
+ * scheduled. With orig_interval_adaptive, own OGMs which are still pending
+ * after a longer interval are moved forward as well, so the change is announced
+ * within the shortest interval.
+ *
+ * Changes reported within orig_interval of the last one are ignored: they are
+ * announced by the own OGMs which were already moved forward.
+ */
+void batadv_ogm_interval_churn(struct batadv_priv *bat_priv)
+{
+	struct batadv_algo_ops *bao = bat_priv->bat_algo_ops;
+	unsigned int orig_interval = atomic_read(&bat_priv->orig_interval);
+	unsigned long last = ACCESS_ONCE(bat_priv->ogm_churn_time);
+	struct batadv_hardif_array_entry *entry;
+	struct batadv_hardif_array *hardif_array;
+	struct batadv_hard_iface *hard_iface;
+	unsigned int interval;
+	unsigned int i;
+
+	if (!batadv_has_timed_out(last, orig_interval))
+		return;
+
+	ACCESS_ONCE(bat_priv->ogm_churn_time) = jiffies;
+	atomic_inc(&bat_priv->ogm_churn);
+
+	if (!atomic_read(&bat_priv->orig_interval_adaptive) ||
+	    !bao->bat_ogm_reschedule)
+		return;
+
+	rcu_read_lock();
+	hardif_array = rcu_dereference(bat_priv->hardif_array);
+	for (i = 0; hardif_array && i < hardif_array->num; i++) {
+		entry = &hardif_array->ifaces[i];
+		hard_iface = ACCESS_ONCE(entry->hard_iface);
+		if (!hard_iface)
+			continue;
+
+		if (hard_iface->if_status != BATADV_IF_ACTIVE)
+			continue;
+
+		interval = batadv_ogm_interval_min(bat_priv, hard_iface);
+
+		/* already pulled forward or not backed off yet */
+		if (atomic_read(&hard_iface->ogm_interval) <= interval)
+			continue;
+
+		bao->bat_ogm_reschedule(bat_priv, hard_iface, interval);
+		atomic_set(&hard_iface->ogm_interval, interval);
+	}
+	rcu_read_unlock();
+}
+
+/**
+ * batadv_ogm_interval_next - get the interval until the next own OGM
+ * @bat_priv: the bat priv with all the soft interface information
+ * @hard_iface: the interface the own OGM is scheduled for
+ *
+ * Without orig_interval_adaptive this is always the ogm_interval_min of the
+ * interface, which defaults to orig_interval. Otherwise the interval of the
+ * interface is doubled with every own OGM, up to orig_interval_max, as long as
+ * no topology change was reported via batadv_ogm_interval_churn(). After a
+ * change, the interval starts over at ogm_interval_min.
+ *
+ * Return: the interval in milliseconds, not including the jitter.
+ */
+unsigned int batadv_ogm_interval_next(struct batadv_priv *bat_priv,
+				      struct batadv_hard_iface *hard_iface)
+{
+	unsigned int max_interval = atomic_read(&bat_priv->orig_interval_max);
+	unsigned int interval = atomic_read(&hard_iface->ogm_interval);
+	int churn = atomic_read(&bat_priv->ogm_churn);
+	unsigned int min_interval;
+
+	min_interval = batadv_ogm_interval_min(bat_priv, hard_iface);
+
+	if (!atomic_read(&bat_priv->orig_interval_adaptive) ||
+	    churn != hard_iface->ogm_churn_seen)
+		interval = min_interval;
+	else
+		interval = min(2 * interval, max_interval);
+
+	interval = max(interval, min_interval);
+
+	hard_iface->ogm_churn_seen = churn;
+	atomic_set(&hard_iface->ogm_interval, interval);
+
+	return interval;
+}
+
 void batadv_schedule_bat_ogm(struct batadv_hard_iface *hard_iface)
 {
 	struct batadv_priv *bat_priv = netdev_priv(hard_iface->soft_iface);
@@ -526,6 +646,7 @@ int batadv_add_bcast_packet_to_list(struct batadv_priv *bat_priv,
 
 	/* how often did we send the bcast packet ? */
 	forw_packet->num_packets = 0;
+	forw_packet->queue_time = batadv_latency_start();
 
 	INIT_DELAYED_WORK(&forw_packet->delayed_work,
 			  batadv_send_outstanding_bcast_packet);
@@ -568,6 +689,10 @@ static void batadv_send_outstanding_bcast_packet(struct work_struct *work)
 	if (batadv_dat_drop_broadcast_packet(bat_priv, forw_packet))
 		goto out;
 
+	if (forw_packet->num_packets == 0)
+		batadv_latency_stop(bat_priv, BATADV_LATENCY_BCAST_QUEUE,
+				    forw_packet->queue_time);
+
 	/* rebroadcast packet */
 	rcu_read_lock();
 	list_for_each_entry_rcu(hard_iface, &batadv_hardif_list, list) {
@@ -707,3 +832,23 @@ batadv_purge_outstanding_packets(struct batadv_priv *bat_priv,
 	}
 	spin_unlock_bh(&bat_priv->forw_bat_list_lock);
 }
+
+/**
+ * batadv_skb_alloc - allocate an skb for a routing protocol packet
+ * @bat_priv: the bat priv with all the soft interface information
+ * @dev: the device the skb is allocated for (can be NULL)
+ * @len: the number of bytes the skb must be able to hold (including the
+ *  ethernet header)
+ *
+ * Allocates the skb like netdev_alloc_skb_ip_align() and accounts it in the
+ * BATADV_CNT_SKB_ALLOC counter.
+ *
+ * Return: the skb or NULL in case of allocation failure
+ */
+struct sk_buff *batadv_skb_alloc(struct batadv_priv *bat_priv,
+				 struct net_device *dev, unsigned int len)
+{
+	batadv_inc_counter(bat_priv, BATADV_CNT_SKB_ALLOC);
+
+	return netdev_alloc_skb_ip_align(dev, len);
+}
@@ -25,6 +25,7 @@
 
 #include "packet.h"
 
+struct net_device;
 struct sk_buff;
 struct work_struct;
 
@@ -38,6 +39,11 @@ int batadv_send_broadcast_skb(struct sk_buff *skb,
 			      struct batadv_hard_iface *hard_iface);
 int batadv_send_unicast_skb(struct sk_buff *skb,
 			    struct batadv_neigh_node *neigh_node);
+unsigned int batadv_ogm_interval_min(struct batadv_priv *bat_priv,
+				     struct batadv_hard_iface *hard_iface);
+void batadv_ogm_interval_churn(struct batadv_priv *bat_priv);
+unsigned int batadv_ogm_interval_next(struct batadv_priv *bat_priv,
+				      struct batadv_hard_iface *hard_iface);
 void batadv_schedule_bat_ogm(struct batadv_hard_iface *hard_iface);
 int batadv_add_bcast_packet_to_list(struct batadv_priv *bat_priv,
 				    const struct sk_buff *skb,
@@ -59,6 +65,8 @@ int batadv_send_skb_via_tt_generic(struct batadv_priv *bat_priv,
 				   struct sk_buff *skb, int packet_type,
 				   int packet_subtype, u8 *dst_hint,
 				   unsigned short vid);
+struct sk_buff *batadv_skb_alloc(struct batadv_priv *bat_priv,
+				 struct net_device *dev, unsigned int len);
 int batadv_send_skb_via_gw(struct batadv_priv *bat_priv, struct sk_buff *skb,
 			   unsigned short vid);
 
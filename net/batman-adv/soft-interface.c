@@ -22,6 +22,7 @@
 #include <linux/byteorder/generic.h>
 #include <linux/cache.h>
 #include <linux/compiler.h>
+#include <linux/cpumask.h>
 #include <linux/errno.h>
 #include <linux/etherdevice.h>
 #include <linux/ethtool.h>
@@ -31,6 +32,7 @@
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
 #include <linux/kref.h>
+#include <linux/ktime.h>
 #include <linux/list.h>
 #include <linux/lockdep.h>
 #include <linux/netdevice.h>
@@ -54,6 +56,7 @@
 #include "gateway_client.h"
 #include "gateway_common.h"
 #include "hard-interface.h"
+#include "latency.h"
 #include "multicast.h"
 #include "network-coding.h"
 #include "packet.h"
@@ -104,13 +107,13 @@ int batadv_skb_head_push(struct sk_buff *skb, unsigned int len)
 
 static int batadv_interface_open(struct net_device *dev)
 {
-	netif_start_queue(dev);
+	netif_tx_start_all_queues(dev);
 	return 0;
 }
 
 static int batadv_interface_release(struct net_device *dev)
 {
-	netif_stop_queue(dev);
+	netif_tx_stop_all_queues(dev);
 	return 0;
 }
 
@@ -179,6 +182,19 @@ static void batadv_interface_set_rx_mode(struct net_device *dev)
 {
 }
 
+/**
+ * batadv_txq_counters_add - account a transmitted packet to its tx queue
+ * @bat_priv: the bat priv with all the soft interface information
+ * @queue: tx queue of the soft interface the packet was sent through
+ * @len: length of the packet
+ */
+static void batadv_txq_counters_add(struct batadv_priv *bat_priv, u16 queue,
+				    int len)
+{
+	this_cpu_add(bat_priv->txq_counters[BATADV_TXQ_CNT_PACKETS(queue)], 1);
+	this_cpu_add(bat_priv->txq_counters[BATADV_TXQ_CNT_BYTES(queue)], len);
+}
+
 static int batadv_interface_tx(struct sk_buff *skb,
 			       struct net_device *soft_iface)
 {
@@ -196,6 +212,8 @@ static int batadv_interface_tx(struct sk_buff *skb,
 	struct vlan_ethhdr *vhdr;
 	unsigned int header_len = 0;
 	int data_len = skb->len, ret;
+	u16 queue = skb_get_queue_mapping(skb);
+	ktime_t start = batadv_latency_start();
 	unsigned long brd_delay = 1;
 	bool do_bcast = false, client_added;
 	unsigned short vid;
@@ -306,11 +324,12 @@ send:
 		if (!primary_if)
 			goto dropped;
 
-		/* in case of ARP request, we do not immediately broadcasti the
-		 * packet, instead we first wait for DAT to try to retrieve the
-		 * correct ARP entry
+		/* in case of ARP request (or neighbor solicitation), we do not
+		 * immediately broadcasti the packet, instead we first wait for
+		 * DAT to try to retrieve the correct ARP entry
 		 */
-		if (batadv_dat_snoop_outgoing_arp_request(bat_priv, skb))
+		if (batadv_dat_snoop_outgoing_arp_request(bat_priv, skb) ||
+		    batadv_dat_snoop_outgoing_nd_request(bat_priv, skb))
 			brd_delay = msecs_to_jiffies(ARP_REQ_DELAY);
 
 		if (batadv_skb_head_push(skb, sizeof(*bcast_packet)) < 0)
@@ -359,6 +378,7 @@ send:
 				goto dropped;
 
 			batadv_dat_snoop_outgoing_arp_reply(bat_priv, skb);
+			batadv_dat_snoop_outgoing_nd_reply(bat_priv, skb);
 
 			ret = batadv_send_skb_via_tt(bat_priv, skb, dst_hint,
 						     vid);
@@ -369,6 +389,7 @@ send:
 
 	batadv_inc_counter(bat_priv, BATADV_CNT_TX);
 	batadv_add_counter(bat_priv, BATADV_CNT_TX_BYTES, data_len);
+	batadv_txq_counters_add(bat_priv, queue, data_len);
 	goto end;
 
 dropped:
@@ -378,6 +399,7 @@ dropped_freed:
 end:
 	if (primary_if)
 		batadv_hardif_put(primary_if);
+	batadv_latency_stop(bat_priv, BATADV_LATENCY_TX, start);
 	return NETDEV_TX_OK;
 }
 
@@ -768,6 +790,7 @@ static int batadv_softif_init_late(struct net_device *dev)
 	u32 random_seqno;
 	int ret;
 	size_t cnt_len = sizeof(u64) * BATADV_CNT_NUM;
+	size_t txq_cnt_len;
 
 	batadv_set_lockdep_class(dev);
 
@@ -782,6 +805,17 @@ static int batadv_softif_init_late(struct net_device *dev)
 	if (!bat_priv->bat_counters)
 		return -ENOMEM;
 
+	txq_cnt_len = sizeof(u64) * BATADV_TXQ_CNT_NUM(dev->num_tx_queues);
+	bat_priv->txq_counters = __alloc_percpu(txq_cnt_len, __alignof__(u64));
+	if (!bat_priv->txq_counters) {
+		ret = -ENOMEM;
+		goto free_bat_counters;
+	}
+
+	ret = batadv_latency_init(bat_priv);
+	if (ret < 0)
+		goto free_bat_counters;
+
 	atomic_set(&bat_priv->aggregated_ogms, 1);
 	atomic_set(&bat_priv->bonding, 0);
 #ifdef CONFIG_BATMAN_ADV_BLA
@@ -789,6 +823,7 @@ static int batadv_softif_init_late(struct net_device *dev)
 #endif
 #ifdef CONFIG_BATMAN_ADV_DAT
 	atomic_set(&bat_priv->distributed_arp_table, 1);
+	atomic_set(&bat_priv->dat_max_entries, BATADV_DAT_MAX_ENTRIES_DEFAULT);
 #endif
 #ifdef CONFIG_BATMAN_ADV_MCAST
 	bat_priv->mcast.flags = BATADV_NO_FLAGS;
@@ -803,6 +838,12 @@ static int batadv_softif_init_late(struct net_device *dev)
 	atomic_set(&bat_priv->gw.bandwidth_down, 100);
 	atomic_set(&bat_priv->gw.bandwidth_up, 20);
 	atomic_set(&bat_priv->orig_interval, 1000);
+	atomic_set(&bat_priv->orig_interval_adaptive, 0);
+	atomic_set(&bat_priv->orig_interval_max, 8000);
+	atomic_set(&bat_priv->ogm_churn, 0);
+	/* the first topology change must not be rate limited */
+	bat_priv->ogm_churn_time = jiffies - 1 -
+		msecs_to_jiffies(atomic_read(&bat_priv->orig_interval));
 	atomic_set(&bat_priv->hop_penalty, 30);
 #ifdef CONFIG_BATMAN_ADV_DEBUG
 	atomic_set(&bat_priv->log_level, 0);
@@ -851,6 +892,9 @@ static int batadv_softif_init_late(struct net_device *dev)
 unreg_debugfs:
 	batadv_debugfs_del_meshif(dev);
 free_bat_counters:
+	batadv_latency_free(bat_priv);
+	free_percpu(bat_priv->txq_counters);
+	bat_priv->txq_counters = NULL;
 	free_percpu(bat_priv->bat_counters);
 	bat_priv->bat_counters = NULL;
 
@@ -956,6 +1000,10 @@ static void batadv_softif_init_early(struct net_device *dev)
 	dev->netdev_ops = &batadv_netdev_ops;
 	dev->destructor = batadv_softif_free;
 	dev->features |= NETIF_F_HW_VLAN_CTAG_FILTER;
+	/* batadv_interface_tx() only relies on RCU and per cpu data and
+	 * therefore doesn't need the tx queue lock
+	 */
+	dev->features |= NETIF_F_LLTX;
 	dev->priv_flags |= IFF_NO_QUEUE;
 
 	/* can't call min_mtu, because the needed variables
@@ -971,16 +1019,34 @@ static void batadv_softif_init_early(struct net_device *dev)
 	memset(priv, 0, sizeof(*priv));
 }
 
-struct net_device *batadv_softif_create(const char *name)
+/**
+ * batadv_softif_create - create and register a batadv_soft_interface
+ * @net: the applicable net namespace
+ * @name: name of the new soft interface
+ *
+ * Return: newly allocated soft_interface, NULL on errors
+ */
+struct net_device *batadv_softif_create(struct net *net, const char *name)
 {
 	struct net_device *soft_iface;
+	unsigned int txqs;
 	int ret;
 
-	soft_iface = alloc_netdev(sizeof(struct batadv_priv), name,
-				  NET_NAME_UNKNOWN, batadv_softif_init_early);
+	/* one tx queue per cpu: the stack spreads the transmitting flows
+	 * over the queues based on their flow hash (and priority if traffic
+	 * classes are configured). Every queue adds per cpu counters and
+	 * ethtool statistics, therefore the number is capped on large
+	 * machines
+	 */
+	txqs = min_t(unsigned int, num_possible_cpus(), BATADV_MAX_TXQ);
+	soft_iface = alloc_netdev_mqs(sizeof(struct batadv_priv), name,
+				      NET_NAME_UNKNOWN,
+				      batadv_softif_init_early, txqs, 1);
 	if (!soft_iface)
 		return NULL;
 
+	dev_net_set(soft_iface, net);
+
 	soft_iface->rtnl_link_ops = &batadv_link_ops;
 
 	ret = register_netdevice(soft_iface);
@@ -1094,6 +1160,7 @@ static const struct {
 	{ "rx_bytes" },
 	{ "forward" },
 	{ "forward_bytes" },
+	{ "forward_fast" },
 	{ "mgmt_tx" },
 	{ "mgmt_tx_bytes" },
 	{ "mgmt_rx" },
@@ -1110,12 +1177,36 @@ static const struct {
 	{ "tt_response_rx" },
 	{ "tt_roam_adv_tx" },
 	{ "tt_roam_adv_rx" },
+	{ "tt_bloom_skip" },
+	{ "tt_bloom_false_pos" },
+	{ "skb_alloc" },
+	{ "drop_unspec" },
+	{ "drop_malformed" },
+	{ "drop_version" },
+	{ "drop_bad_addr" },
+	{ "drop_not_for_me" },
+	{ "drop_own" },
+	{ "drop_ttl" },
+	{ "drop_no_route" },
+	{ "drop_duplicate" },
+	{ "drop_ttvn" },
+	{ "drop_frag" },
+	{ "drop_bla" },
+	{ "drop_nomem" },
+	{ "drop_disabled" },
+	{ "drop_unhandled" },
 #ifdef CONFIG_BATMAN_ADV_DAT
 	{ "dat_get_tx" },
 	{ "dat_get_rx" },
 	{ "dat_put_tx" },
 	{ "dat_put_rx" },
 	{ "dat_cached_reply_tx" },
+	{ "dat_bloom_skip" },
+	{ "dat_bloom_false_pos" },
+	{ "dat_cache_evict" },
+	{ "dat_cache_refresh" },
+	{ "dat_nd_cache_hit" },
+	{ "dat_nd_cache_miss" },
 #endif
 #ifdef CONFIG_BATMAN_ADV_NC
 	{ "nc_code" },
@@ -1132,25 +1223,62 @@ static const struct {
 
 static void batadv_get_strings(struct net_device *dev, u32 stringset, u8 *data)
 {
-	if (stringset == ETH_SS_STATS)
-		memcpy(data, batadv_counters_strings,
-		       sizeof(batadv_counters_strings));
+	unsigned int i;
+
+	if (stringset != ETH_SS_STATS)
+		return;
+
+	memcpy(data, batadv_counters_strings, sizeof(batadv_counters_strings));
+	data += sizeof(batadv_counters_strings);
+
+	for (i = 0; i < dev->real_num_tx_queues; i++) {
+		snprintf(data, ETH_GSTRING_LEN, "tx_queue_%u_packets", i);
+		data += ETH_GSTRING_LEN;
+		snprintf(data, ETH_GSTRING_LEN, "tx_queue_%u_bytes", i);
+		data += ETH_GSTRING_LEN;
+	}
+}
+
+/**
+ * batadv_sum_txq_counter - Sum the cpu-local tx queue counters for index 'idx'
+ * @bat_priv: the bat priv with all the soft interface information
+ * @idx: index of the tx queue counter to sum up
+ *
+ * Return: sum of all cpu-local tx queue counters
+ */
+static u64 batadv_sum_txq_counter(struct batadv_priv *bat_priv, size_t idx)
+{
+	u64 *counters, sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		counters = per_cpu_ptr(bat_priv->txq_counters, cpu);
+		sum += counters[idx];
+	}
+
+	return sum;
 }
 
 static void batadv_get_ethtool_stats(struct net_device *dev,
 				     struct ethtool_stats *stats, u64 *data)
 {
 	struct batadv_priv *bat_priv = netdev_priv(dev);
-	int i;
+	unsigned int i;
 
 	for (i = 0; i < BATADV_CNT_NUM; i++)
 		data[i] = batadv_sum_counter(bat_priv, i);
+
+	data += BATADV_CNT_NUM;
+
+	for (i = 0; i < BATADV_TXQ_CNT_NUM(dev->real_num_tx_queues); i++)
+		data[i] = batadv_sum_txq_counter(bat_priv, i);
 }
 
 static int batadv_get_sset_count(struct net_device *dev, int stringset)
 {
 	if (stringset == ETH_SS_STATS)
-		return BATADV_CNT_NUM;
+		return BATADV_CNT_NUM +
+		       BATADV_TXQ_CNT_NUM(dev->real_num_tx_queues);
 
 	return -EOPNOTSUPP;
 }
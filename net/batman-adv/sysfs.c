@@ -412,6 +412,14 @@ static ssize_t batadv_show_bat_algo(struct kobject *kobj,
 	return sprintf(buff, "%s\n", bat_priv->bat_algo_ops->name);
 }
 
+static ssize_t batadv_show_forward_pps(struct kobject *kobj,
+				       struct attribute *attr, char *buff)
+{
+	struct batadv_priv *bat_priv = batadv_kobj_to_batpriv(kobj);
+
+	return sprintf(buff, "%i\n", atomic_read(&bat_priv->forward_pps));
+}
+
 static void batadv_post_gw_reselect(struct net_device *net_dev)
 {
 	struct batadv_priv *bat_priv = netdev_priv(net_dev);
@@ -613,13 +621,19 @@ BATADV_ATTR_SIF_BOOL(bridge_loop_avoidance, S_IRUGO | S_IWUSR,
 #ifdef CONFIG_BATMAN_ADV_DAT
 BATADV_ATTR_SIF_BOOL(distributed_arp_table, S_IRUGO | S_IWUSR,
 		     batadv_dat_status_update);
+BATADV_ATTR_SIF_UINT(dat_max_entries, dat_max_entries, S_IRUGO | S_IWUSR, 1,
+		     INT_MAX, batadv_dat_max_entries_update);
 #endif
 BATADV_ATTR_SIF_BOOL(fragmentation, S_IRUGO | S_IWUSR, batadv_update_min_mtu);
 static BATADV_ATTR(routing_algo, S_IRUGO, batadv_show_bat_algo, NULL);
+static BATADV_ATTR(forward_pps, S_IRUGO, batadv_show_forward_pps, NULL);
 static BATADV_ATTR(gw_mode, S_IRUGO | S_IWUSR, batadv_show_gw_mode,
 		   batadv_store_gw_mode);
 BATADV_ATTR_SIF_UINT(orig_interval, orig_interval, S_IRUGO | S_IWUSR,
 		     2 * BATADV_JITTER, INT_MAX, NULL);
+BATADV_ATTR_SIF_BOOL(orig_interval_adaptive, S_IRUGO | S_IWUSR, NULL);
+BATADV_ATTR_SIF_UINT(orig_interval_max, orig_interval_max, S_IRUGO | S_IWUSR,
+		     2 * BATADV_JITTER, BATADV_PURGE_TIMEOUT / 2, NULL);
 BATADV_ATTR_SIF_UINT(hop_penalty, hop_penalty, S_IRUGO | S_IWUSR, 0,
 		     BATADV_TQ_MAX_VALUE, NULL);
 BATADV_ATTR_SIF_UINT(gw_sel_class, gw_sel_class, S_IRUGO | S_IWUSR, 1,
@@ -648,14 +662,18 @@ static struct batadv_attribute *batadv_mesh_attrs[] = {
 #endif
 #ifdef CONFIG_BATMAN_ADV_DAT
 	&batadv_attr_distributed_arp_table,
+	&batadv_attr_dat_max_entries,
 #endif
 #ifdef CONFIG_BATMAN_ADV_MCAST
 	&batadv_attr_multicast_mode,
 #endif
 	&batadv_attr_fragmentation,
 	&batadv_attr_routing_algo,
+	&batadv_attr_forward_pps,
 	&batadv_attr_gw_mode,
 	&batadv_attr_orig_interval,
+	&batadv_attr_orig_interval_adaptive,
+	&batadv_attr_orig_interval_max,
 	&batadv_attr_hop_penalty,
 	&batadv_attr_gw_sel_class,
 	&batadv_attr_gw_bandwidth,
@@ -917,6 +935,65 @@ static ssize_t batadv_show_iface_status(struct kobject *kobj,
 	return length;
 }
 
+static ssize_t batadv_show_ogm_interval(struct kobject *kobj,
+					struct attribute *attr, char *buff)
+{
+	struct net_device *net_dev = batadv_kobj_to_netdev(kobj);
+	struct batadv_hard_iface *hard_iface;
+	ssize_t length;
+
+	hard_iface = batadv_hardif_get_by_netdev(net_dev);
+	if (!hard_iface)
+		return 0;
+
+	length = sprintf(buff, "%i\n", atomic_read(&hard_iface->ogm_interval));
+
+	batadv_hardif_put(hard_iface);
+
+	return length;
+}
+
+static BATADV_ATTR_HIF_SHOW_UINT(ogm_interval_min, ogm_interval_min)
+
+/**
+ * batadv_store_ogm_interval_min - parse and store the shortest own OGM
+ *  interval of a hard interface
+ * @kobj: kobject representing the private mesh sysfs directory
+ * @attr: the batman-adv attribute the user is interacting with
+ * @buff: the buffer containing the user data
+ * @count: number of bytes in the buffer
+ *
+ * 0 makes the interface use the orig_interval of its mesh interface. Other
+ * values have to leave room for the jitter.
+ *
+ * Return: 'count' on success or a negative error code in case of failure
+ */
+static ssize_t batadv_store_ogm_interval_min(struct kobject *kobj,
+					     struct attribute *attr,
+					     char *buff, size_t count)
+{
+	struct net_device *net_dev = batadv_kobj_to_netdev(kobj);
+	struct batadv_hard_iface *hard_iface;
+	unsigned int min = 2 * BATADV_JITTER;
+	unsigned long interval;
+	ssize_t length;
+
+	hard_iface = batadv_hardif_get_by_netdev(net_dev);
+	if (!hard_iface)
+		return 0;
+
+	if (!kstrtoul(buff, 10, &interval) && interval == 0)
+		min = 0;
+
+	length = __batadv_store_uint_attr(buff, count, min,
+					  BATADV_PURGE_TIMEOUT / 2, NULL, attr,
+					  &hard_iface->ogm_interval_min,
+					  net_dev);
+
+	batadv_hardif_put(hard_iface);
+	return length;
+}
+
 #ifdef CONFIG_BATMAN_ADV_BATMAN_V
 
 /**
@@ -990,6 +1067,9 @@ static ssize_t batadv_show_throughput_override(struct kobject *kobj,
 static BATADV_ATTR(mesh_iface, S_IRUGO | S_IWUSR, batadv_show_mesh_iface,
 		   batadv_store_mesh_iface);
 static BATADV_ATTR(iface_status, S_IRUGO, batadv_show_iface_status, NULL);
+static BATADV_ATTR(ogm_interval, S_IRUGO, batadv_show_ogm_interval, NULL);
+static BATADV_ATTR(ogm_interval_min, S_IRUGO | S_IWUSR,
+		   batadv_show_ogm_interval_min, batadv_store_ogm_interval_min);
 #ifdef CONFIG_BATMAN_ADV_BATMAN_V
 BATADV_ATTR_HIF_UINT(elp_interval, bat_v.elp_interval, S_IRUGO | S_IWUSR,
 		     2 * BATADV_JITTER, INT_MAX, NULL);
@@ -1001,6 +1081,8 @@ static BATADV_ATTR(throughput_override, S_IRUGO | S_IWUSR,
 static struct batadv_attribute *batadv_batman_attrs[] = {
 	&batadv_attr_mesh_iface,
 	&batadv_attr_iface_status,
+	&batadv_attr_ogm_interval,
+	&batadv_attr_ogm_interval_min,
 #ifdef CONFIG_BATMAN_ADV_BATMAN_V
 	&batadv_attr_elp_interval,
 	&batadv_attr_throughput_override,
@@ -0,0 +1,1016 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tp_meter.h"
+#include "main.h"
+
+#include <linux/atomic.h>
+#include <linux/byteorder/generic.h>
+#include <linux/completion.h>
+#include <linux/err.h>
+#include <linux/errno.h>
+#include <linux/etherdevice.h>
+#include <linux/if_ether.h>
+#include <linux/jiffies.h>
+#include <linux/kernel.h>
+#include <linux/kref.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/list.h>
+#include <linux/module.h>
+#include <linux/netdevice.h>
+#include <linux/netlink.h>
+#include <linux/random.h>
+#include <linux/rculist.h>
+#include <linux/rcupdate.h>
+#include <linux/sched.h>
+#include <linux/skbuff.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/stddef.h>
+#include <linux/string.h>
+#include <linux/wait.h>
+#include <net/genetlink.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
+
+#include "hard-interface.h"
+#include "netlink.h"
+#include "originator.h"
+#include "packet.h"
+#include "send.h"
+
+/* The throughput meter streams BATADV_TP_MSG packets through
+ * batadv_send_skb_to_orig() towards the tested originator which answers each
+ * of them with a cumulative BATADV_TP_ACK. The sender keeps at most a window
+ * of unacknowledged bytes in flight which grows like the TCP congestion
+ * window (slow start followed by congestion avoidance). Losses are detected
+ * through three duplicate acks or an expired retransmission timeout and are
+ * recovered by sending everything again from the first unacknowledged byte.
+ * The receiver only accepts in-order data and therefore needs no reordering
+ * buffer.
+ */
+
+/* payload carried by each test packet */
+#define BATADV_TP_PLEN (BATADV_TP_PACKET_LEN - \
+			sizeof(struct batadv_icmp_tp_packet))
+
+/* first byte offset of every session */
+#define BATADV_TP_FIRST_SEQ 0
+
+/**
+ * batadv_tp_now - get the current time in microseconds
+ *
+ * Return: current CLOCK_MONOTONIC time in microseconds, truncated to 32 bits
+ */
+static u32 batadv_tp_now(void)
+{
+	return (u32)ktime_to_us(ktime_get());
+}
+
+/**
+ * batadv_tp_vars_release - release tp_vars from lists and queue for free after
+ *  rcu grace period
+ * @ref: kref pointer of the tp_vars
+ */
+static void batadv_tp_vars_release(struct kref *ref)
+{
+	struct batadv_tp_vars *tp_vars;
+
+	tp_vars = container_of(ref, struct batadv_tp_vars, refcount);
+
+	kfree_rcu(tp_vars, rcu);
+}
+
+/**
+ * batadv_tp_vars_put - decrement the tp_vars refcounter and possibly release
+ *  it
+ * @tp_vars: the session to be free'd
+ */
+static void batadv_tp_vars_put(struct batadv_tp_vars *tp_vars)
+{
+	kref_put(&tp_vars->refcount, batadv_tp_vars_release);
+}
+
+/**
+ * batadv_tp_list_unlink - remove a session from the list of sessions
+ * @bat_priv: the bat priv with all the soft interface information
+ * @tp_vars: the session to remove
+ *
+ * Must be called with tp_list_lock held.
+ */
+static void batadv_tp_list_unlink(struct batadv_priv *bat_priv,
+				  struct batadv_tp_vars *tp_vars)
+{
+	hlist_del_rcu(&tp_vars->list);
+	atomic_dec(&bat_priv->tp_num);
+	batadv_tp_vars_put(tp_vars);
+}
+
+/**
+ * batadv_tp_list_purge - drop idle receivers and old sender results
+ * @bat_priv: the bat priv with all the soft interface information
+ */
+static void batadv_tp_list_purge(struct batadv_priv *bat_priv)
+{
+	struct batadv_tp_vars *tp_vars;
+	struct hlist_node *node_tmp;
+	unsigned long timeout;
+
+	spin_lock_bh(&bat_priv->tp_list_lock);
+	hlist_for_each_entry_safe(tp_vars, node_tmp, &bat_priv->tp_list,
+				  list) {
+		if (tp_vars->role == BATADV_TP_RECEIVER) {
+			timeout = msecs_to_jiffies(BATADV_TP_RECV_TIMEOUT);
+			if (time_before(jiffies,
+					tp_vars->last_progress + timeout))
+				continue;
+		} else {
+			if (!completion_done(&tp_vars->finished))
+				continue;
+
+			timeout = msecs_to_jiffies(BATADV_TP_RESULT_TIMEOUT);
+			timeout += tp_vars->finish_time;
+			if (time_before(jiffies, timeout))
+				continue;
+		}
+
+		batadv_tp_list_unlink(bat_priv, tp_vars);
+	}
+	spin_unlock_bh(&bat_priv->tp_list_lock);
+}
+
+/**
+ * batadv_tp_list_find_session - find a session by its remote end and id
+ * @bat_priv: the bat priv with all the soft interface information
+ * @role: role of this node in the session
+ * @other_end: mac address of the remote end of the session
+ * @session: session identifier
+ *
+ * Return: the matching session with increased refcounter or NULL
+ */
+static struct batadv_tp_vars *
+batadv_tp_list_find_session(struct batadv_priv *bat_priv,
+			    enum batadv_tp_meter_role role,
+			    const u8 *other_end, const u8 *session)
+{
+	struct batadv_tp_vars *tp_vars, *tp_vars_tmp = NULL;
+
+	rcu_read_lock();
+	hlist_for_each_entry_rcu(tp_vars, &bat_priv->tp_list, list) {
+		if (tp_vars->role != role)
+			continue;
+
+		if (!batadv_compare_eth(tp_vars->other_end, other_end))
+			continue;
+
+		if (memcmp(tp_vars->session, session, sizeof(tp_vars->session)))
+			continue;
+
+		if (!kref_get_unless_zero(&tp_vars->refcount))
+			continue;
+
+		tp_vars_tmp = tp_vars;
+		break;
+	}
+	rcu_read_unlock();
+
+	return tp_vars_tmp;
+}
+
+/**
+ * batadv_tp_list_find_sender - find the running sender towards a node
+ * @bat_priv: the bat priv with all the soft interface information
+ * @dst: mac address of the tested originator
+ *
+ * Must be called with tp_list_lock held.
+ *
+ * Return: the running sender (without increased refcounter) or NULL
+ */
+static struct batadv_tp_vars *
+batadv_tp_list_find_sender(struct batadv_priv *bat_priv, const u8 *dst)
+{
+	struct batadv_tp_vars *tp_vars;
+
+	hlist_for_each_entry(tp_vars, &bat_priv->tp_list, list) {
+		if (tp_vars->role != BATADV_TP_SENDER)
+			continue;
+
+		if (!atomic_read(&tp_vars->sending))
+			continue;
+
+		if (batadv_compare_eth(tp_vars->other_end, dst))
+			return tp_vars;
+	}
+
+	return NULL;
+}
+
+/**
+ * batadv_tp_sender_end - stop a sender and record the reason
+ * @tp_vars: the sender session
+ * @reason: why the test stopped (see enum batadv_tp_meter_reason)
+ *
+ * Only the first reason is recorded, later calls are ignored.
+ */
+static void batadv_tp_sender_end(struct batadv_tp_vars *tp_vars, u8 reason)
+{
+	spin_lock_bh(&tp_vars->lock);
+	if (atomic_read(&tp_vars->sending)) {
+		tp_vars->reason = reason;
+		tp_vars->finish_time = jiffies;
+		atomic_set(&tp_vars->sending, 0);
+	}
+	spin_unlock_bh(&tp_vars->lock);
+
+	wake_up(&tp_vars->more_bytes);
+}
+
+/**
+ * batadv_tp_window_open - check whether another packet fits into the window
+ * @tp_vars: the sender session
+ *
+ * Return: true if the sender may transmit the next packet
+ */
+static bool batadv_tp_window_open(struct batadv_tp_vars *tp_vars)
+{
+	u32 win = min_t(u32, tp_vars->cwnd, BATADV_TP_AWND);
+	u32 in_flight = tp_vars->last_sent - tp_vars->last_acked;
+
+	return in_flight + BATADV_TP_PLEN <= win;
+}
+
+/**
+ * batadv_tp_next_seqno - reserve the next packet of the window
+ * @tp_vars: the sender session
+ * @seqno: set to the byte offset of the reserved packet
+ *
+ * Return: true if a packet was reserved, false if the window is full
+ */
+static bool batadv_tp_next_seqno(struct batadv_tp_vars *tp_vars, u32 *seqno)
+{
+	bool ret = false;
+
+	spin_lock_bh(&tp_vars->lock);
+	if (!batadv_tp_window_open(tp_vars))
+		goto out;
+
+	*seqno = tp_vars->last_sent;
+	tp_vars->last_sent += BATADV_TP_PLEN;
+	tp_vars->tot_sent++;
+
+	if (batadv_seq_after(tp_vars->last_sent, tp_vars->high_sent))
+		tp_vars->high_sent = tp_vars->last_sent;
+	else
+		tp_vars->retransmits++;
+
+	ret = true;
+out:
+	spin_unlock_bh(&tp_vars->lock);
+
+	return ret;
+}
+
+/**
+ * batadv_tp_loss - shrink the window and resend from the first unacked byte
+ * @tp_vars: the sender session
+ * @timeout: whether the loss was detected by the retransmission timeout
+ *
+ * Must be called with tp_vars->lock held.
+ */
+static void batadv_tp_loss(struct batadv_tp_vars *tp_vars, bool timeout)
+{
+	u32 in_flight = tp_vars->last_sent - tp_vars->last_acked;
+
+	tp_vars->ss_threshold = max_t(u32, in_flight / 2, 2 * BATADV_TP_PLEN);
+	if (timeout)
+		tp_vars->cwnd = BATADV_TP_PLEN;
+	else
+		tp_vars->cwnd = tp_vars->ss_threshold;
+
+	tp_vars->recover = tp_vars->high_sent;
+	tp_vars->last_sent = tp_vars->last_acked;
+	tp_vars->dup_acks = 0;
+}
+
+/**
+ * batadv_tp_check_rto - handle an expired retransmission timeout
+ * @tp_vars: the sender session
+ *
+ * Return: false if the receiver did not answer for too long, true otherwise
+ */
+static bool batadv_tp_check_rto(struct batadv_tp_vars *tp_vars)
+{
+	unsigned long expire;
+	bool ret = true;
+
+	spin_lock_bh(&tp_vars->lock);
+	expire = tp_vars->last_progress + msecs_to_jiffies(tp_vars->rto);
+	if (tp_vars->last_sent == tp_vars->last_acked ||
+	    time_before(jiffies, expire))
+		goto out;
+
+	batadv_tp_loss(tp_vars, true);
+	tp_vars->rto = min_t(u32, tp_vars->rto * 2, BATADV_TP_RTO_MAX);
+	tp_vars->last_progress = jiffies;
+
+	if (++tp_vars->backoffs > BATADV_TP_MAX_BACKOFFS)
+		ret = false;
+out:
+	spin_unlock_bh(&tp_vars->lock);
+
+	return ret;
+}
+
+/**
+ * batadv_tp_wait_time - compute how long the sender may sleep
+ * @tp_vars: the sender session
+ *
+ * Return: jiffies until the retransmission timeout expires (at least 1)
+ */
+static long batadv_tp_wait_time(struct batadv_tp_vars *tp_vars)
+{
+	unsigned long expire;
+
+	expire = tp_vars->last_progress + msecs_to_jiffies(tp_vars->rto);
+	if (time_before_eq(expire, jiffies))
+		return 1;
+
+	return expire - jiffies;
+}
+
+/**
+ * batadv_tp_wait_window - sleep until the window opens or the sender stops
+ * @tp_vars: the sender session
+ *
+ * The sleep is bounded by the retransmission timeout.
+ */
+static void batadv_tp_wait_window(struct batadv_tp_vars *tp_vars)
+{
+	long timeout = batadv_tp_wait_time(tp_vars);
+
+	wait_event_interruptible_timeout(tp_vars->more_bytes,
+					 batadv_tp_window_open(tp_vars) ||
+					 !atomic_read(&tp_vars->sending),
+					 timeout);
+}
+
+/**
+ * batadv_tp_send_msg - send one test packet
+ * @tp_vars: the sender session
+ * @src: mac address of the primary interface of this node
+ * @orig_node: the tested originator
+ * @seqno: byte offset of the payload
+ */
+static void batadv_tp_send_msg(struct batadv_tp_vars *tp_vars, const u8 *src,
+			       struct batadv_orig_node *orig_node, u32 seqno)
+{
+	struct batadv_icmp_tp_packet *icmp;
+	struct sk_buff *skb;
+	u8 *data;
+
+	skb = netdev_alloc_skb_ip_align(NULL, BATADV_TP_PACKET_LEN + ETH_HLEN);
+	if (!skb)
+		return;
+
+	skb_reserve(skb, ETH_HLEN);
+	icmp = (struct batadv_icmp_tp_packet *)skb_put(skb, sizeof(*icmp));
+
+	icmp->packet_type = BATADV_ICMP;
+	icmp->version = BATADV_COMPAT_VERSION;
+	icmp->ttl = BATADV_TTL;
+	icmp->msg_type = BATADV_TP;
+	ether_addr_copy(icmp->dst, orig_node->orig);
+	ether_addr_copy(icmp->orig, src);
+	icmp->uid = 0;
+	icmp->subtype = BATADV_TP_MSG;
+	memcpy(icmp->session, tp_vars->session, sizeof(icmp->session));
+	icmp->seqno = htonl(seqno);
+	icmp->timestamp = htonl(batadv_tp_now());
+
+	data = skb_put(skb, BATADV_TP_PLEN);
+	memset(data, 0, BATADV_TP_PLEN);
+
+	/* a dropped packet is recovered like a lost one */
+	if (batadv_send_skb_to_orig(skb, orig_node, NULL) == NET_XMIT_DROP)
+		kfree_skb(skb);
+}
+
+/**
+ * batadv_tp_send - main loop of the sender thread
+ * @arg: the sender session
+ *
+ * The thread holds a reference on the module (taken by batadv_tp_start()) and
+ * drops it while exiting, so the module cannot be unloaded while the thread
+ * still runs its code after signalling tp_vars->finished.
+ *
+ * Return: never returns
+ */
+static int batadv_tp_send(void *arg)
+{
+	struct batadv_tp_vars *tp_vars = arg;
+	struct batadv_priv *bat_priv = tp_vars->bat_priv;
+	struct batadv_hard_iface *primary_if;
+	struct batadv_orig_node *orig_node;
+	unsigned long test_end;
+	u8 src[ETH_ALEN];
+	u32 seqno;
+	u8 reason;
+
+	orig_node = batadv_orig_hash_find(bat_priv, tp_vars->other_end);
+	if (!orig_node) {
+		batadv_tp_sender_end(tp_vars, BATADV_TP_REASON_DST_UNREACHABLE);
+		goto out;
+	}
+
+	primary_if = batadv_primary_if_get_selected(bat_priv);
+	if (!primary_if) {
+		batadv_tp_sender_end(tp_vars, BATADV_TP_REASON_DST_UNREACHABLE);
+		goto out;
+	}
+
+	ether_addr_copy(src, primary_if->net_dev->dev_addr);
+	batadv_hardif_put(primary_if);
+
+	test_end = tp_vars->start_time + msecs_to_jiffies(tp_vars->test_length);
+
+	while (atomic_read(&tp_vars->sending)) {
+		if (time_after(jiffies, test_end)) {
+			reason = BATADV_TP_REASON_COMPLETE;
+			batadv_tp_sender_end(tp_vars, reason);
+			break;
+		}
+
+		if (!batadv_tp_check_rto(tp_vars)) {
+			/* a receiver which never answered is unreachable */
+			reason = BATADV_TP_REASON_DST_UNREACHABLE;
+			if (tp_vars->acked_bytes)
+				reason = BATADV_TP_REASON_RESEND_LIMIT;
+
+			batadv_tp_sender_end(tp_vars, reason);
+			break;
+		}
+
+		if (!batadv_tp_next_seqno(tp_vars, &seqno)) {
+			batadv_tp_wait_window(tp_vars);
+			continue;
+		}
+
+		batadv_tp_send_msg(tp_vars, src, orig_node, seqno);
+		cond_resched();
+	}
+
+out:
+	batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
+		   "Throughput test towards %pM stopped (reason: %u, acked: %llu bytes, rtt: %u us)\n",
+		   tp_vars->other_end, tp_vars->reason, tp_vars->acked_bytes,
+		   tp_vars->srtt);
+
+	if (orig_node)
+		batadv_orig_node_put(orig_node);
+
+	complete(&tp_vars->finished);
+	batadv_tp_vars_put(tp_vars);
+
+	module_put_and_exit(0);
+}
+
+/**
+ * batadv_tp_start - start a throughput test towards an originator
+ * @bat_priv: the bat priv with all the soft interface information
+ * @dst: mac address of the originator to test
+ * @test_length: duration of the test in milliseconds (0 for the default)
+ * @cookie: set to the identifier of the new session
+ *
+ * Return: 0 on success or negative error number in case of failure
+ */
+int batadv_tp_start(struct batadv_priv *bat_priv, const u8 *dst,
+		    u32 test_length, u32 *cookie)
+{
+	struct batadv_tp_vars *tp_vars;
+	struct task_struct *kthread;
+
+	if (!test_length)
+		test_length = BATADV_TP_DEF_TEST_LENGTH;
+
+	if (test_length > BATADV_TP_MAX_TEST_LENGTH)
+		return -EINVAL;
+
+	batadv_tp_list_purge(bat_priv);
+
+	tp_vars = kzalloc(sizeof(*tp_vars), GFP_KERNEL);
+	if (!tp_vars)
+		return -ENOMEM;
+
+	tp_vars->role = BATADV_TP_SENDER;
+	ether_addr_copy(tp_vars->other_end, dst);
+	get_random_bytes(tp_vars->session, sizeof(tp_vars->session));
+	get_random_bytes(&tp_vars->cookie, sizeof(tp_vars->cookie));
+	atomic_set(&tp_vars->sending, 1);
+	tp_vars->start_time = jiffies;
+	tp_vars->test_length = test_length;
+	tp_vars->last_acked = BATADV_TP_FIRST_SEQ;
+	tp_vars->last_sent = BATADV_TP_FIRST_SEQ;
+	tp_vars->high_sent = BATADV_TP_FIRST_SEQ;
+	tp_vars->recover = BATADV_TP_FIRST_SEQ;
+	tp_vars->cwnd = 3 * BATADV_TP_PLEN;
+	tp_vars->ss_threshold = BATADV_TP_AWND;
+	tp_vars->rto = BATADV_TP_RTO_INIT;
+	tp_vars->last_progress = jiffies;
+	spin_lock_init(&tp_vars->lock);
+	init_waitqueue_head(&tp_vars->more_bytes);
+	init_completion(&tp_vars->finished);
+	tp_vars->bat_priv = bat_priv;
+	kref_init(&tp_vars->refcount);
+
+	spin_lock_bh(&bat_priv->tp_list_lock);
+	if (batadv_tp_list_find_sender(bat_priv, dst) ||
+	    atomic_read(&bat_priv->tp_num) >= BATADV_TP_MAX_NUM) {
+		spin_unlock_bh(&bat_priv->tp_list_lock);
+		kfree(tp_vars);
+		return -EBUSY;
+	}
+
+	/* one reference for the list and one for the sender thread */
+	kref_get(&tp_vars->refcount);
+	hlist_add_head_rcu(&tp_vars->list, &bat_priv->tp_list);
+	atomic_inc(&bat_priv->tp_num);
+	spin_unlock_bh(&bat_priv->tp_list_lock);
+
+	kthread = kthread_create(batadv_tp_send, tp_vars, "kbatadv_tp_meter");
+	if (IS_ERR(kthread)) {
+		spin_lock_bh(&bat_priv->tp_list_lock);
+		batadv_tp_list_unlink(bat_priv, tp_vars);
+		spin_unlock_bh(&bat_priv->tp_list_lock);
+		batadv_tp_vars_put(tp_vars);
+		return PTR_ERR(kthread);
+	}
+
+	/* released by the sender thread via module_put_and_exit() */
+	__module_get(THIS_MODULE);
+
+	*cookie = tp_vars->cookie;
+	wake_up_process(kthread);
+
+	return 0;
+}
+
+/**
+ * batadv_tp_stop - cancel the running throughput test towards an originator
+ * @bat_priv: the bat priv with all the soft interface information
+ * @dst: mac address of the tested originator
+ *
+ * Return: 0 on success or -ENOENT if no test towards @dst is running
+ */
+int batadv_tp_stop(struct batadv_priv *bat_priv, const u8 *dst)
+{
+	struct batadv_tp_vars *tp_vars;
+
+	spin_lock_bh(&bat_priv->tp_list_lock);
+	tp_vars = batadv_tp_list_find_sender(bat_priv, dst);
+	if (tp_vars)
+		kref_get(&tp_vars->refcount);
+	spin_unlock_bh(&bat_priv->tp_list_lock);
+
+	if (!tp_vars)
+		return -ENOENT;
+
+	batadv_tp_sender_end(tp_vars, BATADV_TP_REASON_CANCEL);
+	batadv_tp_vars_put(tp_vars);
+
+	return 0;
+}
+
+/**
+ * batadv_tp_update_rtt - feed a round trip time sample into the estimator
+ * @tp_vars: the sender session
+ * @rtt: the measured round trip time in microseconds
+ *
+ * Follows RFC 6298. Must be called with tp_vars->lock held.
+ */
+static void batadv_tp_update_rtt(struct batadv_tp_vars *tp_vars, u32 rtt)
+{
+	s32 delta;
+	u32 rto;
+
+	if (!tp_vars->srtt) {
+		tp_vars->srtt = rtt;
+		tp_vars->rttvar = rtt / 2;
+	} else {
+		delta = rtt - tp_vars->srtt;
+		tp_vars->rttvar -= tp_vars->rttvar / 4;
+		tp_vars->rttvar += abs(delta) / 4;
+		tp_vars->srtt += delta / 8;
+	}
+
+	rto = DIV_ROUND_UP(tp_vars->srtt + 4 * tp_vars->rttvar, 1000);
+	tp_vars->rto = clamp_t(u32, rto, BATADV_TP_RTO_MIN, BATADV_TP_RTO_MAX);
+}
+
+/**
+ * batadv_tp_recv_ack - process an ack received by a sender
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the ack packet
+ */
+static void batadv_tp_recv_ack(struct batadv_priv *bat_priv,
+			       struct sk_buff *skb)
+{
+	struct batadv_icmp_tp_packet *icmp;
+	struct batadv_tp_vars *tp_vars;
+	u32 ack, acked, rtt;
+
+	icmp = (struct batadv_icmp_tp_packet *)skb->data;
+
+	tp_vars = batadv_tp_list_find_session(bat_priv, BATADV_TP_SENDER,
+					      icmp->orig, icmp->session);
+	if (!tp_vars)
+		return;
+
+	ack = ntohl(icmp->seqno);
+	rtt = batadv_tp_now() - ntohl(icmp->timestamp);
+
+	spin_lock_bh(&tp_vars->lock);
+	if (!atomic_read(&tp_vars->sending))
+		goto unlock;
+
+	/* old or bogus ack */
+	if (batadv_seq_before(ack, tp_vars->last_acked) ||
+	    batadv_seq_after(ack, tp_vars->high_sent))
+		goto unlock;
+
+	if (ack == tp_vars->last_acked) {
+		if (tp_vars->last_sent == tp_vars->last_acked)
+			goto unlock;
+
+		tp_vars->dup_acks++;
+		if (tp_vars->dup_acks == 3 &&
+		    !batadv_seq_before(tp_vars->last_acked, tp_vars->recover))
+			batadv_tp_loss(tp_vars, false);
+
+		goto unlock;
+	}
+
+	acked = ack - tp_vars->last_acked;
+	tp_vars->last_acked = ack;
+	tp_vars->acked_bytes += acked;
+	tp_vars->last_progress = jiffies;
+	tp_vars->backoffs = 0;
+	tp_vars->dup_acks = 0;
+
+	/* a resent packet may be acknowledged together with data which was
+	 * still in flight from before the loss
+	 */
+	if (batadv_seq_after(ack, tp_vars->last_sent))
+		tp_vars->last_sent = ack;
+
+	batadv_tp_update_rtt(tp_vars, rtt);
+
+	if (tp_vars->cwnd < tp_vars->ss_threshold)
+		tp_vars->cwnd += min_t(u32, acked, BATADV_TP_PLEN);
+	else
+		tp_vars->cwnd += max_t(u32, BATADV_TP_PLEN * BATADV_TP_PLEN /
+					    tp_vars->cwnd, 1);
+
+	tp_vars->cwnd = min_t(u32, tp_vars->cwnd, BATADV_TP_AWND);
+
+unlock:
+	spin_unlock_bh(&tp_vars->lock);
+
+	wake_up(&tp_vars->more_bytes);
+	batadv_tp_vars_put(tp_vars);
+}
+
+/**
+ * batadv_tp_send_ack - acknowledge the data received so far
+ * @bat_priv: the bat priv with all the soft interface information
+ * @dst: mac address of the sender
+ * @ack: next byte expected by the receiver
+ * @timestamp: timestamp of the packet triggering this ack
+ * @session: session identifier
+ */
+static void batadv_tp_send_ack(struct batadv_priv *bat_priv, const u8 *dst,
+			       u32 ack, __be32 timestamp, const u8 *session)
+{
+	struct batadv_hard_iface *primary_if = NULL;
+	struct batadv_orig_node *orig_node;
+	struct batadv_icmp_tp_packet *icmp;
+	struct sk_buff *skb;
+
+	orig_node = batadv_orig_hash_find(bat_priv, dst);
+	if (!orig_node)
+		return;
+
+	primary_if = batadv_primary_if_get_selected(bat_priv);
+	if (!primary_if)
+		goto out;
+
+	skb = netdev_alloc_skb_ip_align(NULL, sizeof(*icmp) + ETH_HLEN);
+	if (!skb)
+		goto out;
+
+	skb_reserve(skb, ETH_HLEN);
+	icmp = (struct batadv_icmp_tp_packet *)skb_put(skb, sizeof(*icmp));
+
+	icmp->packet_type = BATADV_ICMP;
+	icmp->version = BATADV_COMPAT_VERSION;
+	icmp->ttl = BATADV_TTL;
+	icmp->msg_type = BATADV_TP;
+	ether_addr_copy(icmp->dst, orig_node->orig);
+	ether_addr_copy(icmp->orig, primary_if->net_dev->dev_addr);
+	icmp->uid = 0;
+	icmp->subtype = BATADV_TP_ACK;
+	memcpy(icmp->session, session, sizeof(icmp->session));
+	icmp->seqno = htonl(ack);
+	icmp->timestamp = timestamp;
+
+	if (batadv_send_skb_to_orig(skb, orig_node, NULL) == NET_XMIT_DROP)
+		kfree_skb(skb);
+
+out:
+	if (primary_if)
+		batadv_hardif_put(primary_if);
+	batadv_orig_node_put(orig_node);
+}
+
+/**
+ * batadv_tp_init_recv - create the receiver side of a new session
+ * @bat_priv: the bat priv with all the soft interface information
+ * @icmp: the first packet of the session
+ *
+ * Return: the new session with increased refcounter or NULL
+ */
+static struct batadv_tp_vars *
+batadv_tp_init_recv(struct batadv_priv *bat_priv,
+		    const struct batadv_icmp_tp_packet *icmp)
+{
+	struct batadv_tp_vars *tp_vars;
+
+	batadv_tp_list_purge(bat_priv);
+
+	spin_lock_bh(&bat_priv->tp_list_lock);
+	if (atomic_read(&bat_priv->tp_num) >= BATADV_TP_MAX_NUM) {
+		tp_vars = NULL;
+		goto out;
+	}
+
+	tp_vars = kzalloc(sizeof(*tp_vars), GFP_ATOMIC);
+	if (!tp_vars)
+		goto out;
+
+	tp_vars->role = BATADV_TP_RECEIVER;
+	ether_addr_copy(tp_vars->other_end, icmp->orig);
+	memcpy(tp_vars->session, icmp->session, sizeof(tp_vars->session));
+	tp_vars->start_time = jiffies;
+	tp_vars->last_acked = BATADV_TP_FIRST_SEQ;
+	tp_vars->last_progress = jiffies;
+	spin_lock_init(&tp_vars->lock);
+	init_waitqueue_head(&tp_vars->more_bytes);
+	init_completion(&tp_vars->finished);
+	tp_vars->bat_priv = bat_priv;
+	kref_init(&tp_vars->refcount);
+
+	/* one reference for the list and one for the caller */
+	kref_get(&tp_vars->refcount);
+	hlist_add_head_rcu(&tp_vars->list, &bat_priv->tp_list);
+	atomic_inc(&bat_priv->tp_num);
+out:
+	spin_unlock_bh(&bat_priv->tp_list_lock);
+
+	return tp_vars;
+}
+
+/**
+ * batadv_tp_recv_msg - process a test packet received by a receiver
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the test packet
+ */
+static void batadv_tp_recv_msg(struct batadv_priv *bat_priv,
+			       struct sk_buff *skb)
+{
+	struct batadv_icmp_tp_packet *icmp;
+	struct batadv_tp_vars *tp_vars;
+	u32 seqno, ack;
+
+	icmp = (struct batadv_icmp_tp_packet *)skb->data;
+	seqno = ntohl(icmp->seqno);
+
+	tp_vars = batadv_tp_list_find_session(bat_priv, BATADV_TP_RECEIVER,
+					      icmp->orig, icmp->session);
+	if (!tp_vars) {
+		/* only the first packet may start a new session */
+		if (seqno != BATADV_TP_FIRST_SEQ)
+			return;
+
+		tp_vars = batadv_tp_init_recv(bat_priv, icmp);
+		if (!tp_vars)
+			return;
+	}
+
+	spin_lock_bh(&tp_vars->lock);
+	tp_vars->last_progress = jiffies;
+
+	/* out of order data is dropped and triggers a duplicate ack */
+	if (seqno == tp_vars->last_acked)
+		tp_vars->last_acked += skb->len - sizeof(*icmp);
+
+	ack = tp_vars->last_acked;
+	spin_unlock_bh(&tp_vars->lock);
+
+	batadv_tp_send_ack(bat_priv, icmp->orig, ack, icmp->timestamp,
+			   icmp->session);
+
+	batadv_tp_vars_put(tp_vars);
+}
+
+/**
+ * batadv_tp_meter_recv - process an incoming throughput meter packet
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the packet, consumed by this function
+ */
+void batadv_tp_meter_recv(struct batadv_priv *bat_priv, struct sk_buff *skb)
+{
+	struct batadv_icmp_tp_packet *icmp;
+
+	if (!pskb_may_pull(skb, sizeof(*icmp)))
+		goto out;
+
+	icmp = (struct batadv_icmp_tp_packet *)skb->data;
+
+	switch (icmp->subtype) {
+	case BATADV_TP_MSG:
+		batadv_tp_recv_msg(bat_priv, skb);
+		break;
+	case BATADV_TP_ACK:
+		batadv_tp_recv_ack(bat_priv, skb);
+		break;
+	default:
+		batadv_dbg(BATADV_DBG_BATMAN, bat_priv,
+			   "Received unknown TP packet subtype: %u\n",
+			   icmp->subtype);
+		break;
+	}
+
+out:
+	consume_skb(skb);
+}
+
+/**
+ * batadv_tp_dump_entry - add a sender session to a netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @tp_vars: the sender session to add
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int batadv_tp_dump_entry(struct sk_buff *msg,
+				struct netlink_callback *cb,
+				struct batadv_tp_vars *tp_vars)
+{
+	unsigned long end_time = jiffies;
+	u32 test_time, rtt, packets, retransmits;
+	bool running;
+	u64 bytes;
+	u8 reason;
+	void *hdr;
+
+	spin_lock_bh(&tp_vars->lock);
+	running = atomic_read(&tp_vars->sending);
+	if (!running)
+		end_time = tp_vars->finish_time;
+	test_time = jiffies_to_msecs(end_time - tp_vars->start_time);
+	bytes = tp_vars->acked_bytes;
+	rtt = tp_vars->srtt;
+	packets = tp_vars->tot_sent;
+	retransmits = tp_vars->retransmits;
+	reason = tp_vars->reason;
+	spin_unlock_bh(&tp_vars->lock);
+
+	hdr = batadv_netlink_hdr_put(msg, cb, BATADV_CMD_GET_TP_METER);
+	if (!hdr)
+		return -EMSGSIZE;
+
+	if (nla_put(msg, BATADV_ATTR_ORIG_ADDRESS, ETH_ALEN,
+		    tp_vars->other_end) ||
+	    nla_put_u32(msg, BATADV_ATTR_TPMETER_COOKIE, tp_vars->cookie) ||
+	    nla_put_u32(msg, BATADV_ATTR_TPMETER_TEST_TIME, test_time) ||
+	    nla_put_u64(msg, BATADV_ATTR_TPMETER_BYTES, bytes) ||
+	    nla_put_u32(msg, BATADV_ATTR_TPMETER_RTT, rtt) ||
+	    nla_put_u32(msg, BATADV_ATTR_TPMETER_PACKETS, packets) ||
+	    nla_put_u32(msg, BATADV_ATTR_TPMETER_RETRANSMITS, retransmits))
+		goto nla_put_failure;
+
+	if (!running && nla_put_u8(msg, BATADV_ATTR_TPMETER_RESULT, reason))
+		goto nla_put_failure;
+
+	genlmsg_end(msg, hdr);
+	return 0;
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	return -EMSGSIZE;
+}
+
+/**
+ * batadv_tp_dump - dump the throughput tests started by this node
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @filter: filter of the dump request (only the originator is supported)
+ *
+ * Return: always 0 (the dump continues with the next entry on the next call)
+ */
+int batadv_tp_dump(struct sk_buff *msg, struct netlink_callback *cb,
+		   struct batadv_priv *bat_priv,
+		   const struct batadv_netlink_filter *filter)
+{
+	struct batadv_tp_vars *tp_vars;
+	int idx_skip = cb->args[0];
+	int idx = 0;
+
+	rcu_read_lock();
+	hlist_for_each_entry_rcu(tp_vars, &bat_priv->tp_list, list) {
+		if (tp_vars->role != BATADV_TP_SENDER)
+			continue;
+
+		if (filter->orig_set &&
+		    !batadv_compare_eth(tp_vars->other_end, filter->orig))
+			continue;
+
+		if (idx++ < idx_skip)
+			continue;
+
+		if (batadv_tp_dump_entry(msg, cb, tp_vars)) {
+			idx--;
+			break;
+		}
+	}
+	rcu_read_unlock();
+
+	cb->args[0] = idx;
+
+	return 0;
+}
+
+/**
+ * batadv_tp_meter_init - initialize the throughput meter data of a mesh
+ * @bat_priv: the bat priv with all the soft interface information
+ */
+void batadv_tp_meter_init(struct batadv_priv *bat_priv)
+{
+	INIT_HLIST_HEAD(&bat_priv->tp_list);
+	spin_lock_init(&bat_priv->tp_list_lock);
+	atomic_set(&bat_priv->tp_num, 0);
+}
+
+/**
+ * batadv_tp_meter_free - stop all sessions and free the throughput meter data
+ * @bat_priv: the bat priv with all the soft interface information
+ */
+void batadv_tp_meter_free(struct batadv_priv *bat_priv)
+{
+	struct batadv_tp_vars *tp_vars, *running;
+	struct hlist_node *node_tmp;
+
+	/* the sender threads use bat_priv - wait until they are gone */
+	do {
+		running = NULL;
+
+		spin_lock_bh(&bat_priv->tp_list_lock);
+		hlist_for_each_entry(tp_vars, &bat_priv->tp_list, list) {
+			if (tp_vars->role != BATADV_TP_SENDER)
+				continue;
+
+			if (completion_done(&tp_vars->finished))
+				continue;
+
+			kref_get(&tp_vars->refcount);
+			running = tp_vars;
+			break;
+		}
+		spin_unlock_bh(&bat_priv->tp_list_lock);
+
+		if (!running)
+			break;
+
+		batadv_tp_sender_end(running, BATADV_TP_REASON_CANCEL);
+		wait_for_completion(&running->finished);
+		batadv_tp_vars_put(running);
+	} while (running);
+
+	spin_lock_bh(&bat_priv->tp_list_lock);
+	hlist_for_each_entry_safe(tp_vars, node_tmp, &bat_priv->tp_list, list)
+		batadv_tp_list_unlink(bat_priv, tp_vars);
+	spin_unlock_bh(&bat_priv->tp_list_lock);
+}
@@ -0,0 +1,61 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "main.h"
+
+#include <linux/module.h>
+#include <linux/printk.h>
+#include <stdarg.h>
+
+#define CREATE_TRACE_POINTS
+#include "trace.h"
+
+/**
+ * batadv_trace_dbg - emit a debug message as batadv_dbg trace event
+ * @bat_priv: the bat priv with all the soft interface information
+ * @type: type of the debug message (see batadv_dbg_level)
+ * @fmt: format string of the debug message
+ *
+ * The message is written into the per cpu ring buffer of the tracing
+ * infrastructure. Nothing is formatted or copied as long as the event is not
+ * enabled.
+ */
+void batadv_trace_dbg(struct batadv_priv *bat_priv, int type,
+		      const char *fmt, ...)
+{
+	struct va_format vaf;
+	va_list args;
+
+	va_start(args, fmt);
+
+	vaf.fmt = fmt;
+	vaf.va = &args;
+
+	trace_batadv_dbg(bat_priv, type, &vaf);
+
+	va_end(args);
+}
+
+/**
+ * batadv_trace_drop - emit a batadv_drop trace event for a dropped packet
+ * @bat_priv: the bat priv with all the soft interface information
+ * @skb: the received packet which is dropped
+ * @reason: the cause of the drop
+ */
+void batadv_trace_drop(struct batadv_priv *bat_priv, struct sk_buff *skb,
+		       enum batadv_drop_reason reason)
+{
+	trace_batadv_drop(bat_priv, skb, reason);
+}
@@ -0,0 +1,100 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(_NET_BATMAN_ADV_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define _NET_BATMAN_ADV_TRACE_H_
+
+#include "main.h"
+
+#include <linux/kernel.h>
+#include <linux/netdevice.h>
+#include <linux/printk.h>
+#include <linux/skbuff.h>
+#include <linux/tracepoint.h>
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM batadv
+
+#define BATADV_MAX_MSG_LEN	256
+
+TRACE_EVENT(batadv_dbg,
+
+	    TP_PROTO(struct batadv_priv *bat_priv, int type,
+		     struct va_format *vaf),
+
+	    TP_ARGS(bat_priv, type, vaf),
+
+	    TP_STRUCT__entry(
+		    __string(device, bat_priv->soft_iface->name)
+		    __field(int, type)
+		    __dynamic_array(char, msg, BATADV_MAX_MSG_LEN)
+	    ),
+
+	    TP_fast_assign(
+		    __assign_str(device, bat_priv->soft_iface->name);
+		    __entry->type = type;
+		    vscnprintf(__get_dynamic_array(msg), BATADV_MAX_MSG_LEN,
+			       vaf->fmt, *vaf->va);
+	    ),
+
+	    TP_printk(
+		    "%s type=0x%x %s",
+		    __get_str(device),
+		    __entry->type,
+		    __get_str(msg)
+	    )
+);
+
+TRACE_EVENT(batadv_drop,
+
+	    TP_PROTO(struct batadv_priv *bat_priv, struct sk_buff *skb,
+		     int reason),
+
+	    TP_ARGS(bat_priv, skb, reason),
+
+	    TP_STRUCT__entry(
+		    __string(device, bat_priv->soft_iface->name)
+		    __field(void *, skbaddr)
+		    __field(unsigned int, len)
+		    __field(int, reason)
+	    ),
+
+	    TP_fast_assign(
+		    __assign_str(device, bat_priv->soft_iface->name);
+		    __entry->skbaddr = skb;
+		    __entry->len = skb->len;
+		    __entry->reason = reason;
+	    ),
+
+	    TP_printk(
+		    "%s skbaddr=%p len=%u reason=%d",
+		    __get_str(device),
+		    __entry->skbaddr,
+		    __entry->len,
+		    __entry->reason
+	    )
+);
+
+#endif /* _NET_BATMAN_ADV_TRACE_H_ || TRACE_HEADER_MULTI_READ */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+
+/* we don't want to use include/trace/events */
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE trace
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
@@ -0,0 +1,162 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "traffic.h"
+#include "main.h"
+
+#include <linux/cpumask.h>
+#include <linux/gfp.h>
+#include <linux/netlink.h>
+#include <linux/percpu.h>
+#include <linux/skbuff.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
+
+/**
+ * batadv_traffic_alloc - allocate a zeroed set of traffic counters
+ *
+ * The originator and neighbor objects are created in atomic context. On
+ * kernels which cannot allocate per cpu memory atomically the counters are
+ * not available.
+ *
+ * Return: the per cpu counters or NULL on failure.
+ */
+static u64 __percpu *batadv_traffic_alloc(void)
+{
+	size_t len = sizeof(u64) * BATADV_TRAFFIC_NUM;
+
+	return __alloc_percpu_gfp(len, __alignof__(u64), GFP_ATOMIC);
+}
+
+/**
+ * batadv_traffic_orig_init - allocate the traffic counters of an originator
+ * @orig_node: the newly created originator
+ */
+void batadv_traffic_orig_init(struct batadv_orig_node *orig_node)
+{
+	orig_node->traffic = batadv_traffic_alloc();
+}
+
+/**
+ * batadv_traffic_orig_free - free the traffic counters of an originator
+ * @orig_node: the originator which is freed
+ *
+ * Must only be called after the last RCU reader of @orig_node is gone.
+ */
+void batadv_traffic_orig_free(struct batadv_orig_node *orig_node)
+{
+	free_percpu(orig_node->traffic);
+	orig_node->traffic = NULL;
+}
+
+/**
+ * batadv_traffic_neigh_init - allocate the traffic counters of a neighbor
+ * @neigh_node: the newly created neighbor
+ */
+void batadv_traffic_neigh_init(struct batadv_neigh_node *neigh_node)
+{
+	neigh_node->traffic = batadv_traffic_alloc();
+}
+
+/**
+ * batadv_traffic_neigh_free - free the traffic counters of a neighbor
+ * @neigh_node: the neighbor which is freed
+ *
+ * Must only be called after the last RCU reader of @neigh_node is gone.
+ */
+void batadv_traffic_neigh_free(struct batadv_neigh_node *neigh_node)
+{
+	free_percpu(neigh_node->traffic);
+	neigh_node->traffic = NULL;
+}
+
+/**
+ * batadv_traffic_sum - sum up a traffic counter over all CPUs
+ * @traffic: the per cpu traffic counters
+ * @idx: index of the counter
+ *
+ * Return: the value of the counter.
+ */
+static u64 batadv_traffic_sum(u64 __percpu *traffic,
+			      enum batadv_traffic_counters idx)
+{
+	u64 sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		sum += per_cpu_ptr(traffic, cpu)[idx];
+
+	return sum;
+}
+
+/**
+ * batadv_traffic_put - add a set of traffic counters to a netlink message
+ * @msg: netlink message to fill
+ * @traffic: the per cpu traffic counters (can be NULL)
+ * @attrs: netlink attribute for each of the counters
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int batadv_traffic_put(struct sk_buff *msg, u64 __percpu *traffic,
+			      const int attrs[BATADV_TRAFFIC_NUM])
+{
+	int i;
+
+	if (!traffic)
+		return 0;
+
+	for (i = 0; i < BATADV_TRAFFIC_NUM; i++) {
+		if (nla_put_u64(msg, attrs[i], batadv_traffic_sum(traffic, i)))
+			return -EMSGSIZE;
+	}
+
+	return 0;
+}
+
+static const int batadv_traffic_orig_attrs[BATADV_TRAFFIC_NUM] = {
+	[BATADV_TRAFFIC_TX] = BATADV_ATTR_ORIG_TX_PACKETS,
+	[BATADV_TRAFFIC_TX_BYTES] = BATADV_ATTR_ORIG_TX_BYTES,
+	[BATADV_TRAFFIC_FWD] = BATADV_ATTR_ORIG_FWD_PACKETS,
+	[BATADV_TRAFFIC_FWD_BYTES] = BATADV_ATTR_ORIG_FWD_BYTES,
+};
+
+static const int batadv_traffic_neigh_attrs[BATADV_TRAFFIC_NUM] = {
+	[BATADV_TRAFFIC_TX] = BATADV_ATTR_NEIGH_TX_PACKETS,
+	[BATADV_TRAFFIC_TX_BYTES] = BATADV_ATTR_NEIGH_TX_BYTES,
+	[BATADV_TRAFFIC_FWD] = BATADV_ATTR_NEIGH_FWD_PACKETS,
+	[BATADV_TRAFFIC_FWD_BYTES] = BATADV_ATTR_NEIGH_FWD_BYTES,
+};
+
+/**
+ * batadv_traffic_dump - add the traffic counters of an originator/neighbor
+ *  pair to a netlink message
+ * @msg: netlink message to fill
+ * @orig_node: the originator of the dumped entry
+ * @neigh_node: the neighbor of the dumped entry
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+int batadv_traffic_dump(struct sk_buff *msg,
+			struct batadv_orig_node *orig_node,
+			struct batadv_neigh_node *neigh_node)
+{
+	if (batadv_traffic_put(msg, orig_node->traffic,
+			       batadv_traffic_orig_attrs) ||
+	    batadv_traffic_put(msg, neigh_node->traffic,
+			       batadv_traffic_neigh_attrs))
+		return -EMSGSIZE;
+
+	return 0;
+}
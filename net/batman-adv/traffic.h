@@ -0,0 +1,110 @@
+/* Copyright (C) 2016  B.A.T.M.A.N. contributors:
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of version 2 of the GNU General Public
+ * License as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NET_BATMAN_ADV_TRAFFIC_H_
+#define _NET_BATMAN_ADV_TRAFFIC_H_
+
+#include "main.h"
+
+#include <linux/percpu.h>
+#include <linux/types.h>
+
+struct sk_buff;
+
+#ifdef CONFIG_BATMAN_ADV_TRAFFIC
+
+void batadv_traffic_orig_init(struct batadv_orig_node *orig_node);
+void batadv_traffic_orig_free(struct batadv_orig_node *orig_node);
+void batadv_traffic_neigh_init(struct batadv_neigh_node *neigh_node);
+void batadv_traffic_neigh_free(struct batadv_neigh_node *neigh_node);
+int batadv_traffic_dump(struct sk_buff *msg,
+			struct batadv_orig_node *orig_node,
+			struct batadv_neigh_node *neigh_node);
+
+/**
+ * batadv_traffic_add - account a packet in a set of traffic counters
+ * @traffic: the per cpu traffic counters (can be NULL)
+ * @forward: whether the packet is forwarded or originated by this node
+ * @len: size of the packet including the ethernet header
+ */
+static inline void batadv_traffic_add(u64 __percpu *traffic, bool forward,
+				      unsigned int len)
+{
+	enum batadv_traffic_counters packets = BATADV_TRAFFIC_TX;
+	enum batadv_traffic_counters bytes = BATADV_TRAFFIC_TX_BYTES;
+
+	if (!traffic)
+		return;
+
+	if (forward) {
+		packets = BATADV_TRAFFIC_FWD;
+		bytes = BATADV_TRAFFIC_FWD_BYTES;
+	}
+
+	this_cpu_add(traffic[packets], 1);
+	this_cpu_add(traffic[bytes], len);
+}
+
+/**
+ * batadv_traffic_count - account a unicast packet sent towards an originator
+ * @orig_node: the destination of the packet
+ * @neigh_node: the next hop the packet was handed to
+ * @forward: whether the packet is forwarded or originated by this node
+ * @len: size of the packet including the ethernet header
+ */
+static inline void batadv_traffic_count(struct batadv_orig_node *orig_node,
+					struct batadv_neigh_node *neigh_node,
+					bool forward, unsigned int len)
+{
+	batadv_traffic_add(orig_node->traffic, forward, len);
+	batadv_traffic_add(neigh_node->traffic, forward, len);
+}
+
+#else
+
+static inline void batadv_traffic_orig_init(struct batadv_orig_node *orig_node)
+{
+}
+
+static inline void batadv_traffic_orig_free(struct batadv_orig_node *orig_node)
+{
+}
+
+static inline void
+batadv_traffic_neigh_init(struct batadv_neigh_node *neigh_node)
+{
+}
+
+static inline void
+batadv_traffic_neigh_free(struct batadv_neigh_node *neigh_node)
+{
+}
+
+static inline int batadv_traffic_dump(struct sk_buff *msg,
+				      struct batadv_orig_node *orig_node,
+				      struct batadv_neigh_node *neigh_node)
+{
+	return 0;
+}
+
+static inline void batadv_traffic_count(struct batadv_orig_node *orig_node,
+					struct batadv_neigh_node *neigh_node,
+					bool forward, unsigned int len)
+{
+}
+
+#endif /* CONFIG_BATMAN_ADV_TRAFFIC */
+
+#endif /* _NET_BATMAN_ADV_TRAFFIC_H_ */
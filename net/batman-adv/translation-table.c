@@ -34,23 +34,31 @@
 #include <linux/kref.h>
 #include <linux/list.h>
 #include <linux/lockdep.h>
+#include <linux/log2.h>
 #include <linux/netdevice.h>
+#include <linux/netlink.h>
 #include <linux/rculist.h>
 #include <linux/rcupdate.h>
 #include <linux/seq_file.h>
+#include <linux/skbuff.h>
 #include <linux/slab.h>
 #include <linux/spinlock.h>
 #include <linux/stddef.h>
 #include <linux/string.h>
 #include <linux/workqueue.h>
+#include <net/genetlink.h>
 #include <net/net_namespace.h>
+#include <net/netlink.h>
+#include <uapi/linux/batman_adv.h>
 
 #include "bridge_loop_avoidance.h"
 #include "hard-interface.h"
 #include "hash.h"
 #include "multicast.h"
+#include "netlink.h"
 #include "originator.h"
 #include "packet.h"
+#include "send.h"
 #include "soft-interface.h"
 
 /* hash class keys */
@@ -178,6 +186,18 @@ batadv_tt_local_hash_find(struct batadv_priv *bat_priv, const u8 *addr,
 	return tt_local_entry;
 }
 
+/**
+ * batadv_tt_bloom_key - compute the bloom filter key of a tt entry
+ * @addr: the mac address of the client
+ * @vid: VLAN identifier
+ *
+ * Return: 32 bit hash of addr and vid
+ */
+static u32 batadv_tt_bloom_key(const u8 *addr, unsigned short vid)
+{
+	return jhash(addr, ETH_ALEN, vid);
+}
+
 /**
  * batadv_tt_global_hash_find - search the global table for a given client
  * @bat_priv: the bat priv with all the soft interface information
@@ -194,15 +214,149 @@ batadv_tt_global_hash_find(struct batadv_priv *bat_priv, const u8 *addr,
 	struct batadv_tt_common_entry *tt_common_entry;
 	struct batadv_tt_global_entry *tt_global_entry = NULL;
 
+	if (!batadv_bloom_may_contain(bat_priv->tt.global_bloom,
+				      batadv_tt_bloom_key(addr, vid))) {
+		batadv_inc_counter(bat_priv, BATADV_CNT_TT_BLOOM_SKIP);
+		return NULL;
+	}
+
 	tt_common_entry = batadv_tt_hash_find(bat_priv->tt.global_hash, addr,
 					      vid);
 	if (tt_common_entry)
 		tt_global_entry = container_of(tt_common_entry,
 					       struct batadv_tt_global_entry,
 					       common);
+	else
+		batadv_inc_counter(bat_priv, BATADV_CNT_TT_BLOOM_FALSE_POS);
+
 	return tt_global_entry;
 }
 
+/**
+ * batadv_tt_stats_mod - account for an entry entering or leaving a table
+ * @stats: the counters of the table
+ * @tt_common: the entry
+ * @delta: +1 if the entry was added to the table, -1 if it was removed
+ *
+ * An entry is counted at most once: adding an already accounted entry or
+ * removing an entry which is not accounted (anymore) leaves the counters
+ * untouched.
+ */
+static void batadv_tt_stats_mod(struct batadv_tt_stats *stats,
+				struct batadv_tt_common_entry *tt_common,
+				int delta)
+{
+	bool accounted = delta > 0;
+	unsigned long bits;
+	int bit;
+
+	spin_lock_bh(&stats->lock);
+	if (tt_common->accounted == accounted)
+		goto unlock;
+
+	tt_common->accounted = accounted;
+	bits = tt_common->flags;
+
+	atomic_add(delta, &stats->entries);
+
+	for_each_set_bit(bit, &bits, ARRAY_SIZE(stats->flags))
+		atomic_add(delta, &stats->flags[bit]);
+
+unlock:
+	spin_unlock_bh(&stats->lock);
+}
+
+/**
+ * batadv_tt_flags_mod - change the flags of an entry and update the counters
+ * @stats: the counters of the table the entry belongs to
+ * @tt_common: the entry to modify
+ * @set: the flags to set
+ * @clear: the flags to clear
+ *
+ * Entries which are not accounted (because they never made it into their
+ * table or were already removed from it) get their flags changed without
+ * touching the counters.
+ */
+static void batadv_tt_flags_mod(struct batadv_tt_stats *stats,
+				struct batadv_tt_common_entry *tt_common,
+				u16 set, u16 clear)
+{
+	unsigned long changed;
+	u16 new_flags;
+	int bit;
+
+	spin_lock_bh(&stats->lock);
+	new_flags = (tt_common->flags | set) & ~clear;
+	changed = tt_common->flags ^ new_flags;
+	tt_common->flags = new_flags;
+
+	if (!tt_common->accounted)
+		goto unlock;
+
+	for_each_set_bit(bit, &changed, ARRAY_SIZE(stats->flags)) {
+		if (new_flags & BIT(bit))
+			atomic_inc(&stats->flags[bit]);
+		else
+			atomic_dec(&stats->flags[bit]);
+	}
+
+unlock:
+	spin_unlock_bh(&stats->lock);
+}
+
+/**
+ * batadv_tt_local_flags_mod - change the flags of a local entry
+ * @bat_priv: the bat priv with all the soft interface information
+ * @tt_common: the local entry to modify
+ * @set: the flags to set
+ * @clear: the flags to clear
+ */
+static void batadv_tt_local_flags_mod(struct batadv_priv *bat_priv,
+				      struct batadv_tt_common_entry *tt_common,
+				      u16 set, u16 clear)
+{
+	batadv_tt_flags_mod(&bat_priv->tt.local_stats, tt_common, set, clear);
+}
+
+/**
+ * batadv_tt_global_flags_mod - change the flags of a global entry
+ * @bat_priv: the bat priv with all the soft interface information
+ * @tt_common: the global entry to modify
+ * @set: the flags to set
+ * @clear: the flags to clear
+ */
+static void batadv_tt_global_flags_mod(struct batadv_priv *bat_priv,
+				       struct batadv_tt_common_entry *tt_common,
+				       u16 set, u16 clear)
+{
+	batadv_tt_flags_mod(&bat_priv->tt.global_stats, tt_common, set, clear);
+}
+
+/**
+ * batadv_tt_local_unhashed - account for an entry removed from the local hash
+ * @bat_priv: the bat priv with all the soft interface information
+ * @tt_common: the entry which was removed from the local hash
+ */
+static void batadv_tt_local_unhashed(struct batadv_priv *bat_priv,
+				     struct batadv_tt_common_entry *tt_common)
+{
+	batadv_tt_stats_mod(&bat_priv->tt.local_stats, tt_common, -1);
+}
+
+/**
+ * batadv_tt_global_unhashed - account for an entry removed from the global
+ *  hash and drop it from the bloom filter
+ * @bat_priv: the bat priv with all the soft interface information
+ * @tt_common: the entry which was removed from the global hash
+ */
+static void batadv_tt_global_unhashed(struct batadv_priv *bat_priv,
+				      struct batadv_tt_common_entry *tt_common)
+{
+	batadv_bloom_del(bat_priv->tt.global_bloom,
+			 batadv_tt_bloom_key(tt_common->addr, tt_common->vid));
+	batadv_tt_stats_mod(&bat_priv->tt.global_stats, tt_common, -1);
+}
+
 /**
  * batadv_tt_local_entry_release - release tt_local_entry from lists and queue
  *  for free after rcu grace period
@@ -480,6 +634,8 @@ unlock:
 		atomic_dec(&bat_priv->tt.local_changes);
 	else
 		atomic_inc(&bat_priv->tt.local_changes);
+
+	batadv_ogm_interval_churn(bat_priv);
 }
 
 /**
@@ -559,8 +715,10 @@ static void batadv_tt_global_free(struct batadv_priv *bat_priv,
 		   tt_global->common.addr,
 		   BATADV_PRINT_VID(tt_global->common.vid), message);
 
-	batadv_hash_remove(bat_priv->tt.global_hash, batadv_compare_tt,
-			   batadv_choose_tt, &tt_global->common);
+	if (batadv_hash_remove(bat_priv->tt.global_hash, batadv_compare_tt,
+			       batadv_choose_tt, &tt_global->common))
+		batadv_tt_global_unhashed(bat_priv, &tt_global->common);
+
 	batadv_tt_global_entry_put(tt_global);
 }
 
@@ -594,7 +752,7 @@ bool batadv_tt_local_add(struct net_device *soft_iface, const u8 *addr,
 	u32 match_mark;
 
 	if (ifindex != BATADV_NULL_IFINDEX)
-		in_dev = dev_get_by_index(&init_net, ifindex);
+		in_dev = dev_get_by_index(dev_net(soft_iface), ifindex);
 
 	tt_local = batadv_tt_local_hash_find(bat_priv, addr, vid);
 
@@ -612,7 +770,8 @@ bool batadv_tt_local_add(struct net_device *soft_iface, const u8 *addr,
 			 * this orig_interval. Since it popped up again, the
 			 * flag can be reset like it was never enqueued
 			 */
-			tt_local->common.flags &= ~BATADV_TT_CLIENT_PENDING;
+			batadv_tt_local_flags_mod(bat_priv, &tt_local->common,
+						  0, BATADV_TT_CLIENT_PENDING);
 			goto add_event;
 		}
 
@@ -625,7 +784,8 @@ bool batadv_tt_local_add(struct net_device *soft_iface, const u8 *addr,
 			 * that the client popped up again at its original
 			 * location such flag can be unset
 			 */
-			tt_local->common.flags &= ~BATADV_TT_CLIENT_ROAM;
+			batadv_tt_local_flags_mod(bat_priv, &tt_local->common,
+						  0, BATADV_TT_CLIENT_ROAM);
 			roamed_back = true;
 		}
 		goto check_roaming;
@@ -681,11 +841,15 @@ bool batadv_tt_local_add(struct net_device *soft_iface, const u8 *addr,
 	    is_multicast_ether_addr(addr))
 		tt_local->common.flags |= BATADV_TT_CLIENT_NOPURGE;
 
+	tt_local->common.accounted = false;
+	batadv_tt_stats_mod(&bat_priv->tt.local_stats, &tt_local->common, 1);
+
 	hash_added = batadv_hash_add(bat_priv->tt.local_hash, batadv_compare_tt,
 				     batadv_choose_tt, &tt_local->common,
 				     &tt_local->common.hash_entry);
 
 	if (unlikely(hash_added != 0)) {
+		batadv_tt_local_unhashed(bat_priv, &tt_local->common);
 		/* remove the reference for the hash */
 		batadv_tt_local_entry_put(tt_local);
 		batadv_softif_vlan_put(vlan);
@@ -717,7 +881,9 @@ check_roaming:
 			/* The global entry has to be marked as ROAMING and
 			 * has to be kept for consistency purpose
 			 */
-			tt_global->common.flags |= BATADV_TT_CLIENT_ROAM;
+			batadv_tt_global_flags_mod(bat_priv,
+						   &tt_global->common,
+						   BATADV_TT_CLIENT_ROAM, 0);
 			tt_global->roam_at = jiffies;
 		}
 	}
@@ -728,9 +894,11 @@ check_roaming:
 	remote_flags = tt_local->common.flags & BATADV_TT_REMOTE_MASK;
 
 	if (batadv_is_wifi_netdev(in_dev))
-		tt_local->common.flags |= BATADV_TT_CLIENT_WIFI;
+		batadv_tt_local_flags_mod(bat_priv, &tt_local->common,
+					  BATADV_TT_CLIENT_WIFI, 0);
 	else
-		tt_local->common.flags &= ~BATADV_TT_CLIENT_WIFI;
+		batadv_tt_local_flags_mod(bat_priv, &tt_local->common,
+					  0, BATADV_TT_CLIENT_WIFI);
 
 	/* check the mark in the skb: if it's equal to the configured
 	 * isolation_mark, it means the packet is coming from an isolated
@@ -739,9 +907,11 @@ check_roaming:
 	match_mark = (mark & bat_priv->isolation_mark_mask);
 	if (bat_priv->isolation_mark_mask &&
 	    match_mark == bat_priv->isolation_mark)
-		tt_local->common.flags |= BATADV_TT_CLIENT_ISOLA;
+		batadv_tt_local_flags_mod(bat_priv, &tt_local->common,
+					  BATADV_TT_CLIENT_ISOLA, 0);
 	else
-		tt_local->common.flags &= ~BATADV_TT_CLIENT_ISOLA;
+		batadv_tt_local_flags_mod(bat_priv, &tt_local->common,
+					  0, BATADV_TT_CLIENT_ISOLA);
 
 	/* if any "dynamic" flag has been modified, resend an ADD event for this
 	 * entry so that all the nodes can get the new flags
@@ -1075,7 +1245,8 @@ batadv_tt_local_set_pending(struct batadv_priv *bat_priv,
 	 * to be kept in the table in order to send it in a full table
 	 * response issued before the net ttvn increment (consistency check)
 	 */
-	tt_local_entry->common.flags |= BATADV_TT_CLIENT_PENDING;
+	batadv_tt_local_flags_mod(bat_priv, &tt_local_entry->common,
+				  BATADV_TT_CLIENT_PENDING, 0);
 
 	batadv_dbg(BATADV_DBG_TT, bat_priv,
 		   "Local tt entry (%pM, vid: %d) pending to be removed: %s\n",
@@ -1116,7 +1287,8 @@ u16 batadv_tt_local_remove(struct batadv_priv *bat_priv, const u8 *addr,
 	if (roaming) {
 		flags |= BATADV_TT_CLIENT_ROAM;
 		/* mark the local client as ROAMed */
-		tt_local_entry->common.flags |= BATADV_TT_CLIENT_ROAM;
+		batadv_tt_local_flags_mod(bat_priv, &tt_local_entry->common,
+					  BATADV_TT_CLIENT_ROAM, 0);
 	}
 
 	if (!(tt_local_entry->common.flags & BATADV_TT_CLIENT_NEW)) {
@@ -1136,6 +1308,8 @@ u16 batadv_tt_local_remove(struct batadv_priv *bat_priv, const u8 *addr,
 	if (!tt_entry_exists)
 		goto out;
 
+	batadv_tt_local_unhashed(bat_priv, &tt_local_entry->common);
+
 	/* extra call to free the local tt entry */
 	batadv_tt_local_entry_put(tt_local_entry);
 
@@ -1261,6 +1435,8 @@ static void batadv_tt_local_table_free(struct batadv_priv *bat_priv)
 
 static int batadv_tt_global_init(struct batadv_priv *bat_priv)
 {
+	struct batadv_bloom *bloom;
+
 	if (bat_priv->tt.global_hash)
 		return 0;
 
@@ -1269,6 +1445,15 @@ static int batadv_tt_global_init(struct batadv_priv *bat_priv)
 	if (!bat_priv->tt.global_hash)
 		return -ENOMEM;
 
+	bloom = batadv_bloom_new(BATADV_TT_GLOBAL_BLOOM_BITS);
+	if (!bloom) {
+		batadv_hash_destroy(bat_priv->tt.global_hash);
+		bat_priv->tt.global_hash = NULL;
+		return -ENOMEM;
+	}
+
+	bat_priv->tt.global_bloom = bloom;
+
 	batadv_hash_set_lock_class(bat_priv->tt.global_hash,
 				   &batadv_tt_global_hash_lock_class_key);
 
@@ -1417,6 +1602,7 @@ static bool batadv_tt_global_add(struct batadv_priv *bat_priv,
 	struct batadv_tt_local_entry *tt_local_entry;
 	bool ret = false;
 	int hash_added;
+	u32 bloom_key;
 	struct batadv_tt_common_entry *common;
 	u16 local_flags;
 
@@ -1460,12 +1646,21 @@ static bool batadv_tt_global_add(struct batadv_priv *bat_priv,
 		atomic_set(&tt_global_entry->orig_list_count, 0);
 		spin_lock_init(&tt_global_entry->list_lock);
 
+		batadv_tt_stats_mod(&bat_priv->tt.global_stats, common, 1);
+
+		/* the bloom filter must know the entry before lookups can
+		 * find it
+		 */
+		bloom_key = batadv_tt_bloom_key(common->addr, common->vid);
+		batadv_bloom_add(bat_priv->tt.global_bloom, bloom_key);
+
 		hash_added = batadv_hash_add(bat_priv->tt.global_hash,
 					     batadv_compare_tt,
 					     batadv_choose_tt, common,
 					     &common->hash_entry);
 
 		if (unlikely(hash_added != 0)) {
+			batadv_tt_global_unhashed(bat_priv, common);
 			/* remove the reference for the hash */
 			batadv_tt_global_entry_put(tt_global_entry);
 			goto out_remove;
@@ -1500,14 +1695,15 @@ static bool batadv_tt_global_add(struct batadv_priv *bat_priv,
 		 */
 		if (common->flags & BATADV_TT_CLIENT_TEMP) {
 			batadv_tt_global_del_orig_list(tt_global_entry);
-			common->flags &= ~BATADV_TT_CLIENT_TEMP;
+			batadv_tt_global_flags_mod(bat_priv, common, 0,
+						   BATADV_TT_CLIENT_TEMP);
 		}
 
 		/* the change can carry possible "attribute" flags like the
 		 * TT_CLIENT_WIFI, therefore they have to be copied in the
 		 * client entry
 		 */
-		common->flags |= flags;
+		batadv_tt_global_flags_mod(bat_priv, common, flags, 0);
 
 		/* If there is the BATADV_TT_CLIENT_ROAM flag set, there is only
 		 * one originator left in the list and we previously received a
@@ -1518,7 +1714,8 @@ static bool batadv_tt_global_add(struct batadv_priv *bat_priv,
 		 */
 		if (common->flags & BATADV_TT_CLIENT_ROAM) {
 			batadv_tt_global_del_orig_list(tt_global_entry);
-			common->flags &= ~BATADV_TT_CLIENT_ROAM;
+			batadv_tt_global_flags_mod(bat_priv, common, 0,
+						   BATADV_TT_CLIENT_ROAM);
 			tt_global_entry->roam_at = 0;
 		}
 	}
@@ -1543,13 +1740,15 @@ out_remove:
 	local_flags = batadv_tt_local_remove(bat_priv, tt_addr, vid,
 					     "global tt received",
 					     flags & BATADV_TT_CLIENT_ROAM);
-	tt_global_entry->common.flags |= local_flags & BATADV_TT_CLIENT_WIFI;
+	batadv_tt_global_flags_mod(bat_priv, &tt_global_entry->common,
+				   local_flags & BATADV_TT_CLIENT_WIFI, 0);
 
 	if (!(flags & BATADV_TT_CLIENT_ROAM))
 		/* this is a normal global add. Therefore the client is not in a
 		 * roaming state anymore.
 		 */
-		tt_global_entry->common.flags &= ~BATADV_TT_CLIENT_ROAM;
+		batadv_tt_global_flags_mod(bat_priv, &tt_global_entry->common,
+					   0, BATADV_TT_CLIENT_ROAM);
 
 out:
 	if (tt_global_entry)
@@ -1729,6 +1928,286 @@ out:
 	return 0;
 }
 
+/**
+ * batadv_tt_stats_flag - read the number of entries having a flag set
+ * @stats: the counters of the table
+ * @flag: the flag to look up (one of enum batadv_tt_client_flags)
+ *
+ * Return: the number of entries of the table having @flag set
+ */
+static int batadv_tt_stats_flag(struct batadv_tt_stats *stats, u16 flag)
+{
+	return atomic_read(&stats->flags[ilog2(flag)]);
+}
+
+/**
+ * batadv_tt_stats_print - print the counters of a translation table
+ * @seq: seq file to print on
+ * @name: name of the table
+ * @stats: the counters of the table
+ */
+static void batadv_tt_stats_print(struct seq_file *seq, const char *name,
+				  struct batadv_tt_stats *stats)
+{
+	seq_printf(seq, "%s entries: %d\n", name, atomic_read(&stats->entries));
+	seq_printf(seq,
+		   "\troaming: %d, wifi: %d, isolated: %d, nopurge: %d, new: %d, pending: %d, temporary: %d\n",
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_ROAM),
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_WIFI),
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_ISOLA),
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_NOPURGE),
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_NEW),
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_PENDING),
+		   batadv_tt_stats_flag(stats, BATADV_TT_CLIENT_TEMP));
+}
+
+/**
+ * batadv_tt_stats_print_orig - print the global entry counts of an originator
+ * @seq: seq file to print on
+ * @orig_node: the originator whose VLANs have to be printed
+ *
+ * Must be called with rcu_read_lock held.
+ */
+static void batadv_tt_stats_print_orig(struct seq_file *seq,
+				       struct batadv_orig_node *orig_node)
+{
+	struct batadv_orig_node_vlan *vlan;
+	int num_entries;
+
+	hlist_for_each_entry_rcu(vlan, &orig_node->vlan_list, list) {
+		num_entries = atomic_read(&vlan->tt.num_entries);
+		if (!num_entries)
+			continue;
+
+		seq_printf(seq, "\t%pM %4i %8d\n", orig_node->orig,
+			   BATADV_PRINT_VID(vlan->vid), num_entries);
+	}
+}
+
+/**
+ * batadv_tt_stats_seq_print_text - print aggregated translation table
+ *  statistics
+ * @seq: seq file to print on
+ * @offset: not used
+ *
+ * All the numbers are maintained incrementally while the tables change,
+ * therefore neither the local nor the global hash is walked. Only the list of
+ * originators is traversed to report the per originator/VLAN entry counts.
+ *
+ * Return: always 0
+ */
+int batadv_tt_stats_seq_print_text(struct seq_file *seq, void *offset)
+{
+	struct net_device *net_dev = (struct net_device *)seq->private;
+	struct batadv_priv *bat_priv = netdev_priv(net_dev);
+	struct batadv_hashtable *hash = bat_priv->orig_hash;
+	struct batadv_softif_vlan *vlan;
+	struct batadv_orig_node *orig_node;
+	struct hlist_head *head;
+	u32 i;
+
+	seq_printf(seq, "Translation table statistics of %s (TTVN: %u):\n",
+		   net_dev->name, (u8)atomic_read(&bat_priv->tt.vn));
+	batadv_tt_stats_print(seq, "Local", &bat_priv->tt.local_stats);
+	batadv_tt_stats_print(seq, "Global", &bat_priv->tt.global_stats);
+	seq_printf(seq, "Roaming advertisements: %llu sent, %llu received\n",
+		   batadv_sum_counter(bat_priv, BATADV_CNT_TT_ROAM_ADV_TX),
+		   batadv_sum_counter(bat_priv, BATADV_CNT_TT_ROAM_ADV_RX));
+
+	seq_puts(seq, "\nAnnounced local entries per VLAN:\n");
+	seq_printf(seq, "\t%4s %8s\n", "VID", "Entries");
+
+	rcu_read_lock();
+	hlist_for_each_entry_rcu(vlan, &bat_priv->softif_vlan_list, list)
+		seq_printf(seq, "\t%4i %8d\n", BATADV_PRINT_VID(vlan->vid),
+			   atomic_read(&vlan->tt.num_entries));
+	rcu_read_unlock();
+
+	seq_puts(seq, "\nGlobal entries per originator and VLAN:\n");
+	seq_printf(seq, "\t%-17s %4s %8s\n", "Originator", "VID", "Entries");
+
+	if (!hash)
+		return 0;
+
+	for (i = 0; i < hash->size; i++) {
+		head = &hash->table[i];
+
+		rcu_read_lock();
+		hlist_for_each_entry_rcu(orig_node, head, hash_entry)
+			batadv_tt_stats_print_orig(seq, orig_node);
+		rcu_read_unlock();
+	}
+
+	return 0;
+}
+
+/**
+ * batadv_tt_global_dump_subentry - add an announcement of a global client to a
+ *  netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @common: tt common entry of the client
+ * @orig: originator announcing the client
+ * @best: whether @orig is the one selected for this client
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left
+ */
+static int
+batadv_tt_global_dump_subentry(struct sk_buff *msg,
+			       struct netlink_callback *cb,
+			       struct batadv_tt_common_entry *common,
+			       struct batadv_tt_orig_list_entry *orig,
+			       bool best)
+{
+	struct batadv_orig_node_vlan *vlan;
+	u8 last_ttvn;
+	u32 crc;
+	void *hdr;
+
+	vlan = batadv_orig_node_vlan_get(orig->orig_node, common->vid);
+	if (!vlan)
+		return 0;
+
+	crc = vlan->tt.crc;
+	batadv_orig_node_vlan_put(vlan);
+
+	last_ttvn = atomic_read(&orig->orig_node->last_ttvn);
+
+	hdr = batadv_netlink_hdr_put(msg, cb, BATADV_CMD_GET_TRANSTABLE_GLOBAL);
+	if (!hdr)
+		return -EMSGSIZE;
+
+	if (nla_put(msg, BATADV_ATTR_TT_ADDRESS, ETH_ALEN, common->addr) ||
+	    nla_put(msg, BATADV_ATTR_ORIG_ADDRESS, ETH_ALEN,
+		    orig->orig_node->orig) ||
+	    nla_put_u8(msg, BATADV_ATTR_TT_TTVN, orig->ttvn) ||
+	    nla_put_u8(msg, BATADV_ATTR_TT_LAST_TTVN, last_ttvn) ||
+	    nla_put_u32(msg, BATADV_ATTR_TT_CRC32, crc) ||
+	    nla_put_u16(msg, BATADV_ATTR_TT_VID, common->vid) ||
+	    nla_put_u32(msg, BATADV_ATTR_TT_FLAGS, common->flags))
+		goto nla_put_failure;
+
+	if (best && nla_put_flag(msg, BATADV_ATTR_FLAG_BEST))
+		goto nla_put_failure;
+
+	genlmsg_end(msg, hdr);
+	return 0;
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	return -EMSGSIZE;
+}
+
+/**
+ * batadv_tt_global_dump_entry - add all announcements of a global client to a
+ *  netlink dump
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @common: tt common entry of the client
+ * @filter: filter of the dump request
+ * @sub_s: number of announcements already dumped in a previous message
+ *
+ * Caller must hold rcu_read_lock().
+ *
+ * Return: 0 on success or -EMSGSIZE if @msg has no room left. @sub_s is
+ * updated to the announcement which has to be dumped next.
+ */
+static int
+batadv_tt_global_dump_entry(struct sk_buff *msg, struct netlink_callback *cb,
+			    struct batadv_priv *bat_priv,
+			    struct batadv_tt_common_entry *common,
+			    const struct batadv_netlink_filter *filter,
+			    int *sub_s)
+{
+	struct batadv_tt_orig_list_entry *orig_entry, *best_entry;
+	struct batadv_tt_global_entry *global;
+	int sub = 0;
+
+	global = container_of(common, struct batadv_tt_global_entry, common);
+	best_entry = batadv_transtable_best_orig(bat_priv, global);
+
+	hlist_for_each_entry_rcu(orig_entry, &global->orig_list, list) {
+		if (sub++ < *sub_s)
+			continue;
+
+		if (filter->orig_set &&
+		    !batadv_compare_eth(orig_entry->orig_node->orig,
+					filter->orig))
+			continue;
+
+		if (filter->ttvn_set &&
+		    !batadv_seq_after(orig_entry->ttvn, filter->ttvn))
+			continue;
+
+		if (batadv_tt_global_dump_subentry(msg, cb, common, orig_entry,
+						   orig_entry == best_entry)) {
+			*sub_s = sub - 1;
+			return -EMSGSIZE;
+		}
+	}
+
+	*sub_s = 0;
+	return 0;
+}
+
+/**
+ * batadv_tt_global_dump - dump the global translation table to a netlink
+ *  socket
+ * @msg: netlink message to fill
+ * @cb: control block of the running dump
+ * @bat_priv: the bat priv with all the soft interface information
+ * @filter: filter of the dump request
+ *
+ * Only a single hash bucket is walked per rcu_read_lock() section.
+ *
+ * Return: always 0 - the dump position is kept in cb->args
+ */
+int batadv_tt_global_dump(struct sk_buff *msg, struct netlink_callback *cb,
+			  struct batadv_priv *bat_priv,
+			  const struct batadv_netlink_filter *filter)
+{
+	struct batadv_hashtable *hash = bat_priv->tt.global_hash;
+	struct batadv_tt_common_entry *common;
+	u32 bucket = cb->args[0];
+	int idx_s = cb->args[1];
+	int sub_s = cb->args[2];
+	struct hlist_head *head;
+	int idx;
+
+	for (; bucket < hash->size; bucket++) {
+		head = &hash->table[bucket];
+		idx = 0;
+
+		rcu_read_lock();
+		hlist_for_each_entry_rcu(common, head, hash_entry) {
+			if (idx++ < idx_s)
+				continue;
+
+			if (filter->vid_set && common->vid != filter->vid)
+				continue;
+
+			if (batadv_tt_global_dump_entry(msg, cb, bat_priv,
+							common, filter,
+							&sub_s)) {
+				rcu_read_unlock();
+				idx_s = idx - 1;
+				goto out;
+			}
+		}
+		rcu_read_unlock();
+
+		idx_s = 0;
+	}
+
+out:
+	cb->args[0] = bucket;
+	cb->args[1] = idx_s;
+	cb->args[2] = sub_s;
+
+	return 0;
+}
+
 /**
  * _batadv_tt_global_del_orig_entry - remove and free an orig_entry
  * @tt_global_entry: the global entry to remove the orig_entry from
@@ -1839,7 +2318,8 @@ batadv_tt_global_del_roaming(struct batadv_priv *bat_priv,
 
 	if (last_entry) {
 		/* its the last one, mark for roaming. */
-		tt_global_entry->common.flags |= BATADV_TT_CLIENT_ROAM;
+		batadv_tt_global_flags_mod(bat_priv, &tt_global_entry->common,
+					   BATADV_TT_CLIENT_ROAM, 0);
 		tt_global_entry->roam_at = jiffies;
 	} else
 		/* there is another entry, we can simply delete this
@@ -1965,6 +2445,8 @@ void batadv_tt_global_del_orig(struct batadv_priv *bat_priv,
 					   tt_global->common.addr,
 					   BATADV_PRINT_VID(vid), message);
 				hlist_del_rcu(&tt_common_entry->hash_entry);
+				batadv_tt_global_unhashed(bat_priv,
+							   tt_common_entry);
 				batadv_tt_global_entry_put(tt_global);
 			}
 		}
@@ -2027,6 +2509,7 @@ static void batadv_tt_global_purge(struct batadv_priv *bat_priv)
 				   msg);
 
 			hlist_del_rcu(&tt_common->hash_entry);
+			batadv_tt_global_unhashed(bat_priv, tt_common);
 
 			batadv_tt_global_entry_put(tt_global);
 		}
@@ -2066,8 +2549,10 @@ static void batadv_tt_global_table_free(struct batadv_priv *bat_priv)
 	}
 
 	batadv_hash_destroy(hash);
+	batadv_bloom_destroy(bat_priv->tt.global_bloom);
 
 	bat_priv->tt.global_hash = NULL;
+	bat_priv->tt.global_bloom = NULL;
 }
 
 static bool
@@ -3285,11 +3770,15 @@ static void batadv_tt_local_set_flags(struct batadv_priv *bat_priv, u16 flags,
 			if (enable) {
 				if ((tt_common_entry->flags & flags) == flags)
 					continue;
-				tt_common_entry->flags |= flags;
+				batadv_tt_local_flags_mod(bat_priv,
+							  tt_common_entry,
+							  flags, 0);
 			} else {
 				if (!(tt_common_entry->flags & flags))
 					continue;
-				tt_common_entry->flags &= ~flags;
+				batadv_tt_local_flags_mod(bat_priv,
+							  tt_common_entry,
+							  0, flags);
 			}
 			changed_num++;
 
@@ -3335,6 +3824,7 @@ static void batadv_tt_local_purge_pending_clients(struct batadv_priv *bat_priv)
 
 			batadv_tt_local_size_dec(bat_priv, tt_common->vid);
 			hlist_del_rcu(&tt_common->hash_entry);
+			batadv_tt_local_unhashed(bat_priv, tt_common);
 			tt_local = container_of(tt_common,
 						struct batadv_tt_local_entry,
 						common);
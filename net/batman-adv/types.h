@@ -25,8 +25,11 @@
 #include <linux/average.h>
 #include <linux/bitops.h>
 #include <linux/compiler.h>
+#include <linux/completion.h>
 #include <linux/if_ether.h>
+#include <linux/in6.h>
 #include <linux/kref.h>
+#include <linux/ktime.h>
 #include <linux/netdevice.h>
 #include <linux/sched.h> /* for linux/wait.h */
 #include <linux/spinlock.h>
@@ -36,6 +39,7 @@
 
 #include "packet.h"
 
+struct batadv_bloom;
 struct seq_file;
 
 #ifdef CONFIG_BATMAN_ADV_DAT
@@ -79,11 +83,14 @@ enum batadv_dhcp_recipient {
  * @ogm_buff: buffer holding the OGM packet
  * @ogm_buff_len: length of the OGM packet buffer
  * @ogm_seqno: OGM sequence number - used to identify each OGM
+ * @own_slides: number of own OGM echo window slides performed on this
+ *  interface. Originators catch up lazily, see orig_node->bat_iv.own_slides
  */
 struct batadv_hard_iface_bat_iv {
 	unsigned char *ogm_buff;
 	int ogm_buff_len;
 	atomic_t ogm_seqno;
+	atomic_t own_slides;
 };
 
 /**
@@ -104,6 +111,7 @@ enum batadv_v_hard_iface_flags {
  * @elp_seqno: current ELP sequence number
  * @elp_skb: base skb containing the ELP message to send
  * @elp_wq: workqueue used to schedule ELP transmissions
+ * @ogm_wq: workqueue used to schedule OGM transmissions on this interface
  * @throughput_override: throughput override to disable link auto-detection
  * @flags: interface specific flags
  */
@@ -112,10 +120,35 @@ struct batadv_hard_iface_bat_v {
 	atomic_t elp_seqno;
 	struct sk_buff *elp_skb;
 	struct delayed_work elp_wq;
+	struct delayed_work ogm_wq;
 	atomic_t throughput_override;
 	u8 flags;
 };
 
+/**
+ * struct batadv_hardif_array_entry - hard-interface entry of a mesh interface
+ * @hard_iface: the hard-interface (NULL if it left the mesh interface but the
+ *  array could not be rebuilt)
+ * @addr: MAC address of the hard-interface at the time the array was built
+ */
+struct batadv_hardif_array_entry {
+	struct batadv_hard_iface *hard_iface;
+	u8 addr[ETH_ALEN];
+};
+
+/**
+ * struct batadv_hardif_array - RCU protected array of the hard-interfaces
+ *  assigned to a mesh interface
+ * @num: number of entries in @ifaces
+ * @rcu: struct used for freeing in an RCU-safe manner
+ * @ifaces: the hard-interfaces with their MAC addresses
+ */
+struct batadv_hardif_array {
+	unsigned int num;
+	struct rcu_head rcu;
+	struct batadv_hardif_array_entry ifaces[];
+};
+
 /**
  * struct batadv_hard_iface - network device known to batman-adv
  * @list: list node for batadv_hardif_list
@@ -135,6 +168,12 @@ struct batadv_hard_iface_bat_v {
  * @debug_dir: dentry for nc subdir in batman-adv directory in debugfs
  * @neigh_list: list of unique single hop neighbors via this interface
  * @neigh_list_lock: lock protecting neigh_list
+ * @ogm_interval_min: OGM interval in milliseconds configured for this
+ *  interface, 0 to use batadv_priv::orig_interval
+ * @ogm_interval: interval in milliseconds used to schedule the pending own OGM
+ *  on this interface
+ * @ogm_churn_seen: value of batadv_priv::ogm_churn when the last own OGM was
+ *  scheduled on this interface
  */
 struct batadv_hard_iface {
 	struct list_head list;
@@ -156,6 +195,9 @@ struct batadv_hard_iface {
 	struct hlist_head neigh_list;
 	/* neigh_list_lock protects: neigh_list */
 	spinlock_t neigh_list_lock;
+	atomic_t ogm_interval_min;
+	atomic_t ogm_interval;
+	int ogm_churn_seen;
 };
 
 /**
@@ -182,6 +224,19 @@ struct batadv_orig_ifinfo {
 	struct rcu_head rcu;
 };
 
+/**
+ * struct batadv_orig_ifinfo_table - RCU protected orig_ifinfo lookup array
+ * @num_slots: number of entries in @slots
+ * @rcu: struct used for freeing in an RCU-safe manner
+ * @slots: orig_ifinfo objects indexed by outgoing interface (slot 0 holds
+ *  BATADV_IF_DEFAULT, slot if_num + 1 the hard-interface with that if_num)
+ */
+struct batadv_orig_ifinfo_table {
+	unsigned int num_slots;
+	struct rcu_head rcu;
+	struct batadv_orig_ifinfo __rcu *slots[];
+};
+
 /**
  * struct batadv_frag_table_entry - head in the fragment buffer table
  * @head: head of list with fragments
@@ -244,22 +299,50 @@ struct batadv_orig_node_vlan {
  * the number of our OGMs this orig_node rebroadcasted "back" to us  (relative
  * to last_real_seqno). Every bitfield is BATADV_TQ_LOCAL_WINDOW_SIZE bits long.
  * @bcast_own_sum: sum of bcast_own
- * @ogm_cnt_lock: lock protecting bcast_own, bcast_own_sum,
- *  neigh_node->bat_iv.real_bits & neigh_node->bat_iv.real_packet_count
+ * @own_slides: set of counters (one per hard-interface) holding the value of
+ *  hard_iface->bat_iv.own_slides the matching bcast_own bitfield was last
+ *  shifted to
+ * @num_ifaces: number of hard-interfaces covered by bcast_own, bcast_own_sum
+ *  and own_slides. Grown on demand when a window is accessed
+ * @ogm_cnt_lock: lock protecting bcast_own, bcast_own_sum, own_slides,
+ *  num_ifaces, neigh_node->bat_iv.real_bits &
+ *  neigh_node->bat_iv.real_packet_count
  */
 struct batadv_orig_bat_iv {
 	unsigned long *bcast_own;
 	u8 *bcast_own_sum;
-	/* ogm_cnt_lock protects: bcast_own, bcast_own_sum,
-	 * neigh_node->bat_iv.real_bits & neigh_node->bat_iv.real_packet_count
+	u32 *own_slides;
+	unsigned int num_ifaces;
+	/* ogm_cnt_lock protects: bcast_own, bcast_own_sum, own_slides,
+	 * num_ifaces, neigh_node->bat_iv.real_bits &
+	 * neigh_node->bat_iv.real_packet_count
 	 */
 	spinlock_t ogm_cnt_lock;
 };
 
+/**
+ * enum batadv_traffic_counters - per originator and neighbor traffic counters
+ * @BATADV_TRAFFIC_TX: unicast packets originated by this node and sent towards
+ *  the originator / via the neighbor
+ * @BATADV_TRAFFIC_TX_BYTES: bytes of the BATADV_TRAFFIC_TX packets
+ * @BATADV_TRAFFIC_FWD: unicast packets forwarded towards the originator / via
+ *  the neighbor
+ * @BATADV_TRAFFIC_FWD_BYTES: bytes of the BATADV_TRAFFIC_FWD packets
+ * @BATADV_TRAFFIC_NUM: number of traffic counters
+ */
+enum batadv_traffic_counters {
+	BATADV_TRAFFIC_TX,
+	BATADV_TRAFFIC_TX_BYTES,
+	BATADV_TRAFFIC_FWD,
+	BATADV_TRAFFIC_FWD_BYTES,
+	BATADV_TRAFFIC_NUM,
+};
+
 /**
  * struct batadv_orig_node - structure for orig_list maintaining nodes of mesh
  * @orig: originator ethernet address
  * @ifinfo_list: list for routers per outgoing interface
+ * @ifinfo_table: array of the ifinfo_list entries indexed by outgoing interface
  * @last_bonding_candidate: pointer to last ifinfo of last used router
  * @dat_addr: address of the orig node in the distributed hash
  * @last_seen: time when last packet from this node was received
@@ -286,7 +369,8 @@ struct batadv_orig_bat_iv {
  *  last_bcast_seqno)
  * @last_bcast_seqno: last broadcast sequence number received by this host
  * @neigh_list: list of potential next hop neighbor towards this orig node
- * @neigh_list_lock: lock protecting neigh_list and router
+ * @neigh_list_lock: lock protecting neigh_list, ifinfo_list, ifinfo_table and
+ *  router
  * @hash_entry: hlist node for batadv_priv::orig_hash
  * @bat_priv: pointer to soft_iface this orig node belongs to
  * @bcast_seqno_lock: lock protecting bcast_bits & last_bcast_seqno
@@ -301,10 +385,13 @@ struct batadv_orig_bat_iv {
  *  originator represented by this object
  * @vlan_list_lock: lock protecting vlan_list
  * @bat_iv: B.A.T.M.A.N. IV private structure
+ * @traffic: per cpu traffic counters (see enum batadv_traffic_counters), NULL
+ *  if they could not be allocated
  */
 struct batadv_orig_node {
 	u8 orig[ETH_ALEN];
 	struct hlist_head ifinfo_list;
+	struct batadv_orig_ifinfo_table __rcu *ifinfo_table;
 	struct batadv_orig_ifinfo *last_bonding_candidate;
 #ifdef CONFIG_BATMAN_ADV_DAT
 	batadv_dat_addr_t dat_addr;
@@ -330,7 +417,7 @@ struct batadv_orig_node {
 	DECLARE_BITMAP(bcast_bits, BATADV_TQ_LOCAL_WINDOW_SIZE);
 	u32 last_bcast_seqno;
 	struct hlist_head neigh_list;
-	/* neigh_list_lock protects: neigh_list and router */
+	/* neigh_list_lock protects: neigh_list, ifinfo_table and router */
 	spinlock_t neigh_list_lock;
 	struct hlist_node hash_entry;
 	struct batadv_priv *bat_priv;
@@ -348,6 +435,9 @@ struct batadv_orig_node {
 	struct hlist_head vlan_list;
 	spinlock_t vlan_list_lock; /* protects vlan_list */
 	struct batadv_orig_bat_iv bat_iv;
+#ifdef CONFIG_BATMAN_ADV_TRAFFIC
+	u64 __percpu *traffic;
+#endif
 };
 
 /**
@@ -424,28 +514,49 @@ struct batadv_hardif_neigh_node {
 	struct rcu_head rcu;
 };
 
+/**
+ * struct batadv_neigh_ifinfo_table - RCU protected neigh_ifinfo lookup array
+ * @num_slots: number of entries in @slots
+ * @rcu: struct used for freeing in an RCU-safe manner
+ * @slots: neigh_ifinfo objects indexed by outgoing interface (slot 0 holds
+ *  BATADV_IF_DEFAULT, slot if_num + 1 the hard-interface with that if_num)
+ */
+struct batadv_neigh_ifinfo_table {
+	unsigned int num_slots;
+	struct rcu_head rcu;
+	struct batadv_neigh_ifinfo __rcu *slots[];
+};
+
 /**
  * struct batadv_neigh_node - structure for single hops neighbors
  * @list: list node for batadv_orig_node::neigh_list
  * @orig_node: pointer to corresponding orig_node
  * @addr: the MAC address of the neighboring interface
  * @ifinfo_list: list for routing metrics per outgoing interface
- * @ifinfo_lock: lock protecting private ifinfo members and list
+ * @ifinfo_table: array of the ifinfo_list entries indexed by outgoing interface
+ * @ifinfo_lock: lock protecting private ifinfo members, list and table
  * @if_incoming: pointer to incoming hard-interface
  * @last_seen: when last packet via this neighbor was received
  * @refcount: number of contexts the object is used
  * @rcu: struct used for freeing in an RCU-safe manner
+ * @traffic: per cpu traffic counters (see enum batadv_traffic_counters), NULL
+ *  if they could not be allocated
  */
 struct batadv_neigh_node {
 	struct hlist_node list;
 	struct batadv_orig_node *orig_node;
 	u8 addr[ETH_ALEN];
 	struct hlist_head ifinfo_list;
-	spinlock_t ifinfo_lock;	/* protects ifinfo_list and its members */
+	struct batadv_neigh_ifinfo_table __rcu *ifinfo_table;
+	/* ifinfo_lock protects: ifinfo_list, ifinfo_table and their members */
+	spinlock_t ifinfo_lock;
 	struct batadv_hard_iface *if_incoming;
 	unsigned long last_seen;
 	struct kref refcount;
 	struct rcu_head rcu;
+#ifdef CONFIG_BATMAN_ADV_TRAFFIC
+	u64 __percpu *traffic;
+#endif
 };
 
 /**
@@ -514,6 +625,46 @@ struct batadv_bcast_duplist_entry {
 };
 #endif
 
+/**
+ * enum batadv_drop_reason - causes for dropping a received packet
+ * @BATADV_DROP_UNSPEC: no specific reason was recorded
+ * @BATADV_DROP_MALFORMED: packet too short or with an invalid header
+ * @BATADV_DROP_VERSION: packet of an incompatible batman-adv version
+ * @BATADV_DROP_BAD_ADDR: broadcast source or destination mac address which
+ *  does not match the packet type
+ * @BATADV_DROP_NOT_FOR_ME: unicast packet for another host (promiscuous mode)
+ * @BATADV_DROP_OWN: packet sent or originated by this node
+ * @BATADV_DROP_TTL: time to live exceeded
+ * @BATADV_DROP_NO_ROUTE: no originator or router known for the destination
+ * @BATADV_DROP_DUPLICATE: broadcast which was already received
+ * @BATADV_DROP_TTVN: unicast packet with outdated translation table
+ *  information which could not be re-routed
+ * @BATADV_DROP_FRAG: fragment which could not be buffered or merged
+ * @BATADV_DROP_BLA: packet filtered by the bridge loop avoidance
+ * @BATADV_DROP_NOMEM: packet could not be copied or linearized
+ * @BATADV_DROP_DISABLED: packet for a disabled feature or routing algorithm
+ * @BATADV_DROP_UNHANDLED: packet of an unknown type
+ * @BATADV_DROP_NUM: number of drop reasons
+ */
+enum batadv_drop_reason {
+	BATADV_DROP_UNSPEC,
+	BATADV_DROP_MALFORMED,
+	BATADV_DROP_VERSION,
+	BATADV_DROP_BAD_ADDR,
+	BATADV_DROP_NOT_FOR_ME,
+	BATADV_DROP_OWN,
+	BATADV_DROP_TTL,
+	BATADV_DROP_NO_ROUTE,
+	BATADV_DROP_DUPLICATE,
+	BATADV_DROP_TTVN,
+	BATADV_DROP_FRAG,
+	BATADV_DROP_BLA,
+	BATADV_DROP_NOMEM,
+	BATADV_DROP_DISABLED,
+	BATADV_DROP_UNHANDLED,
+	BATADV_DROP_NUM,
+};
+
 /**
  * enum batadv_counters - indices for traffic counters
  * @BATADV_CNT_TX: transmitted payload traffic packet counter
@@ -523,6 +674,8 @@ struct batadv_bcast_duplist_entry {
  * @BATADV_CNT_RX_BYTES: received payload traffic bytes counter
  * @BATADV_CNT_FORWARD: forwarded payload traffic packet counter
  * @BATADV_CNT_FORWARD_BYTES: forwarded payload traffic bytes counter
+ * @BATADV_CNT_FORWARD_FAST: forwarded payload traffic packets which took the
+ *  transit fast path
  * @BATADV_CNT_MGMT_TX: transmitted routing protocol traffic packet counter
  * @BATADV_CNT_MGMT_TX_BYTES: transmitted routing protocol traffic bytes counter
  * @BATADV_CNT_MGMT_RX: received routing protocol traffic packet counter
@@ -539,12 +692,30 @@ struct batadv_bcast_duplist_entry {
  * @BATADV_CNT_TT_RESPONSE_RX: received tt resp traffic packet counter
  * @BATADV_CNT_TT_ROAM_ADV_TX: transmitted tt roam traffic packet counter
  * @BATADV_CNT_TT_ROAM_ADV_RX: received tt roam traffic packet counter
+ * @BATADV_CNT_TT_BLOOM_SKIP: global tt lookups answered by the bloom filter
+ * @BATADV_CNT_TT_BLOOM_FALSE_POS: global tt lookups which passed the bloom
+ *  filter but missed in the hash
+ * @BATADV_CNT_SKB_ALLOC: skbs allocated for routing protocol packets
+ * @BATADV_CNT_DROP: first of the received packet drop counters, one per
+ *  enum batadv_drop_reason
+ * @BATADV_CNT_DROP_LAST: last of the received packet drop counters
  * @BATADV_CNT_DAT_GET_TX: transmitted dht GET traffic packet counter
  * @BATADV_CNT_DAT_GET_RX: received dht GET traffic packet counter
  * @BATADV_CNT_DAT_PUT_TX: transmitted dht PUT traffic packet counter
  * @BATADV_CNT_DAT_PUT_RX: received dht PUT traffic packet counter
  * @BATADV_CNT_DAT_CACHED_REPLY_TX: transmitted dat cache reply traffic packet
  *  counter
+ * @BATADV_CNT_DAT_BLOOM_SKIP: dat cache lookups answered by the bloom filter
+ * @BATADV_CNT_DAT_BLOOM_FALSE_POS: dat cache lookups which passed the bloom
+ *  filter but missed in the hash
+ * @BATADV_CNT_DAT_CACHE_EVICT: dat cache entries evicted to respect the
+ *  configured cache size
+ * @BATADV_CNT_DAT_CACHE_REFRESH: dat cache entries refreshed via the DHT
+ *  before their expiry
+ * @BATADV_CNT_DAT_ND_CACHE_HIT: neighbor solicitations of local clients
+ *  answered from the dat cache
+ * @BATADV_CNT_DAT_ND_CACHE_MISS: neighbor solicitations of local clients
+ *  which had to be resolved via the DHT or flooded
  * @BATADV_CNT_NC_CODE: transmitted nc-combined traffic packet counter
  * @BATADV_CNT_NC_CODE_BYTES: transmitted nc-combined traffic bytes counter
  * @BATADV_CNT_NC_RECODE: transmitted nc-recombined traffic packet counter
@@ -566,6 +737,7 @@ enum batadv_counters {
 	BATADV_CNT_RX_BYTES,
 	BATADV_CNT_FORWARD,
 	BATADV_CNT_FORWARD_BYTES,
+	BATADV_CNT_FORWARD_FAST,
 	BATADV_CNT_MGMT_TX,
 	BATADV_CNT_MGMT_TX_BYTES,
 	BATADV_CNT_MGMT_RX,
@@ -582,12 +754,23 @@ enum batadv_counters {
 	BATADV_CNT_TT_RESPONSE_RX,
 	BATADV_CNT_TT_ROAM_ADV_TX,
 	BATADV_CNT_TT_ROAM_ADV_RX,
+	BATADV_CNT_TT_BLOOM_SKIP,
+	BATADV_CNT_TT_BLOOM_FALSE_POS,
+	BATADV_CNT_SKB_ALLOC,
+	BATADV_CNT_DROP,
+	BATADV_CNT_DROP_LAST = BATADV_CNT_DROP + BATADV_DROP_NUM - 1,
 #ifdef CONFIG_BATMAN_ADV_DAT
 	BATADV_CNT_DAT_GET_TX,
 	BATADV_CNT_DAT_GET_RX,
 	BATADV_CNT_DAT_PUT_TX,
 	BATADV_CNT_DAT_PUT_RX,
 	BATADV_CNT_DAT_CACHED_REPLY_TX,
+	BATADV_CNT_DAT_BLOOM_SKIP,
+	BATADV_CNT_DAT_BLOOM_FALSE_POS,
+	BATADV_CNT_DAT_CACHE_EVICT,
+	BATADV_CNT_DAT_CACHE_REFRESH,
+	BATADV_CNT_DAT_ND_CACHE_HIT,
+	BATADV_CNT_DAT_ND_CACHE_MISS,
 #endif
 #ifdef CONFIG_BATMAN_ADV_NC
 	BATADV_CNT_NC_CODE,
@@ -603,6 +786,54 @@ enum batadv_counters {
 	BATADV_CNT_NUM,
 };
 
+/* per tx queue counters of the soft interface: packets and bytes of each
+ * queue are stored next to each other
+ */
+#define BATADV_TXQ_CNT_PACKETS(queue) ((queue) * 2)
+#define BATADV_TXQ_CNT_BYTES(queue) ((queue) * 2 + 1)
+#define BATADV_TXQ_CNT_NUM(num_queues) ((num_queues) * 2)
+
+/**
+ * enum batadv_latency_path - code paths covered by the latency histograms
+ * @BATADV_LATENCY_TX: batadv_interface_tx()
+ * @BATADV_LATENCY_RX_UNICAST: batadv_recv_unicast_packet()
+ * @BATADV_LATENCY_OGM: processing of a single (B.A.T.M.A.N. IV or V) OGM
+ * @BATADV_LATENCY_FRAG: batadv_frag_skb_buffer()
+ * @BATADV_LATENCY_BCAST_QUEUE: time a broadcast waited in the broadcast queue
+ *  before its first transmission
+ * @BATADV_LATENCY_NUM: number of latency histograms
+ */
+enum batadv_latency_path {
+	BATADV_LATENCY_TX,
+	BATADV_LATENCY_RX_UNICAST,
+	BATADV_LATENCY_OGM,
+	BATADV_LATENCY_FRAG,
+	BATADV_LATENCY_BCAST_QUEUE,
+	BATADV_LATENCY_NUM,
+};
+
+/**
+ * struct batadv_latency_hist - per cpu latency histograms
+ * @buckets: sample counters per path. Bucket 0 counts durations of 0ns, bucket
+ *  n the durations in [2^(n - 1), 2^n) ns. The last bucket has no upper bound
+ */
+struct batadv_latency_hist {
+	u64 buckets[BATADV_LATENCY_NUM][BATADV_LATENCY_BUCKETS];
+};
+
+/**
+ * struct batadv_tt_stats - incrementally maintained translation table counters
+ * @entries: number of entries currently stored in the table
+ * @flags: number of entries having a given flag set, indexed by the bit
+ *  number of the flag in enum batadv_tt_client_flags
+ * @lock: lock serializing the accounting of entries with their flag changes
+ */
+struct batadv_tt_stats {
+	atomic_t entries;
+	atomic_t flags[BITS_PER_BYTE * sizeof(u16)];
+	spinlock_t lock; /* protects batadv_tt_common_entry::accounted */
+};
+
 /**
  * struct batadv_priv_tt - per mesh interface translation table data
  * @vn: translation table version number
@@ -611,6 +842,9 @@ enum batadv_counters {
  * @changes_list: tracks tt local changes within an originator interval
  * @local_hash: local translation table hash table
  * @global_hash: global translation table hash table
+ * @global_bloom: bloom filter of the keys in @global_hash
+ * @local_stats: counters describing the content of @local_hash
+ * @global_stats: counters describing the content of @global_hash
  * @req_list: list of pending & unanswered tt_requests
  * @roam_list: list of the last roaming events of each client limiting the
  *  number of roaming events to avoid route flapping
@@ -634,6 +868,9 @@ struct batadv_priv_tt {
 	struct list_head changes_list;
 	struct batadv_hashtable *local_hash;
 	struct batadv_hashtable *global_hash;
+	struct batadv_bloom *global_bloom;
+	struct batadv_tt_stats local_stats;
+	struct batadv_tt_stats global_stats;
 	struct hlist_head req_list;
 	struct list_head roam_list;
 	spinlock_t changes_list_lock; /* protects changes */
@@ -732,11 +969,19 @@ struct batadv_priv_tvlv {
  * struct batadv_priv_dat - per mesh interface DAT private data
  * @addr: node DAT address
  * @hash: hashtable representing the local ARP cache
+ * @bloom: bloom filter of the keys in @hash
+ * @num_entries: number of entries currently stored in @hash
+ * @clock_hand: next bucket of @hash visited by the cache eviction
+ * @evict_lock: lock protecting clock_hand and serializing cache evictions
  * @work: work queue callback item for cache purging
  */
 struct batadv_priv_dat {
 	batadv_dat_addr_t addr;
 	struct batadv_hashtable *hash;
+	struct batadv_bloom *bloom;
+	atomic_t num_entries;
+	u32 clock_hand;
+	spinlock_t evict_lock; /* protects clock_hand */
 	struct delayed_work work;
 };
 #endif
@@ -830,13 +1075,18 @@ struct batadv_softif_vlan {
  * @ogm_buff: buffer holding the OGM packet
  * @ogm_buff_len: length of the OGM packet buffer
  * @ogm_seqno: OGM sequence number - used to identify each OGM
- * @ogm_wq: workqueue used to schedule OGM transmissions
+ * @ogm_skb: last own OGM, shared by all interfaces until it expires
+ * @ogm_skb_time: time (jiffies) when ogm_skb was built
+ * @ogm_buff_lock: lock protecting ogm_buff, ogm_buff_len and ogm_skb
  */
 struct batadv_priv_bat_v {
 	unsigned char *ogm_buff;
 	int ogm_buff_len;
 	atomic_t ogm_seqno;
-	struct delayed_work ogm_wq;
+	struct sk_buff *ogm_skb;
+	unsigned long ogm_skb_time;
+	/* ogm_buff_lock protects: ogm_buff, ogm_buff_len, ogm_skb */
+	spinlock_t ogm_buff_lock;
 };
 
 /**
@@ -845,6 +1095,13 @@ struct batadv_priv_bat_v {
  * @soft_iface: net device which holds this struct as private data
  * @stats: structure holding the data for the ndo_get_stats() call
  * @bat_counters: mesh internal traffic statistic counters (see batadv_counters)
+ * @txq_counters: per tx queue traffic statistic counters of the soft interface
+ *  (see BATADV_TXQ_CNT_PACKETS/BATADV_TXQ_CNT_BYTES)
+ * @latency: per cpu latency histograms of the hot paths
+ * @forward_pps: forwarded unicast packets per second during the last
+ *  originator purge period
+ * @forward_last_cnt: BATADV_CNT_FORWARD value at the last forward_pps update
+ * @forward_last_time: time (jiffies) of the last forward_pps update
  * @aggregated_ogms: bool indicating whether OGM aggregation is enabled
  * @bonding: bool indicating whether traffic bonding is enabled
  * @fragmentation: bool indicating whether traffic fragmentation is enabled
@@ -855,11 +1112,17 @@ struct batadv_priv_bat_v {
  *  enabled
  * @distributed_arp_table: bool indicating whether distributed ARP table is
  *  enabled
+ * @dat_max_entries: maximum number of entries kept in the local DAT cache
  * @multicast_mode: Enable or disable multicast optimizations on this node's
  *  sender/originating side
  * @gw_mode: gateway operation: off, client or server (see batadv_gw_modes)
  * @gw_sel_class: gateway selection class (applies if gw_mode client)
  * @orig_interval: OGM broadcast interval in milliseconds
+ * @orig_interval_adaptive: bool indicating whether the OGM interval is
+ *  stretched while the topology is stable
+ * @orig_interval_max: upper bound of the adaptive OGM interval in milliseconds
+ * @ogm_churn: number of topology changes which reset the adaptive OGM interval
+ * @ogm_churn_time: time (jiffies) @ogm_churn was increased last
  * @hop_penalty: penalty which will be applied to an OGM's tq-field on every hop
  * @log_level: configured log level (see batadv_dbg_level)
  * @isolation_mark: the skb->mark value used to match packets for AP isolation
@@ -880,10 +1143,15 @@ struct batadv_priv_bat_v {
  * @cleanup_work: work queue callback item for soft-interface deinit
  * @primary_if: one of the hard-interfaces assigned to this mesh interface
  *  becomes the primary interface
+ * @hardif_array: the hard-interfaces assigned to this mesh interface, saves
+ *  the per packet walks over the global batadv_hardif_list
  * @bat_algo_ops: routing algorithm used by this mesh interface
  * @softif_vlan_list: a list of softif_vlan structs, one per VLAN created on top
  *  of the mesh interface represented by this object
  * @softif_vlan_list_lock: lock protecting softif_vlan_list
+ * @tp_list: list of the throughput meter sessions of this node
+ * @tp_list_lock: lock protecting tp_list & tp_num
+ * @tp_num: number of entries in tp_list
  * @bla: bridge loope avoidance data
  * @debug_log: holding debug logging relevant data
  * @gw: gateway data
@@ -900,6 +1168,13 @@ struct batadv_priv {
 	struct net_device *soft_iface;
 	struct net_device_stats stats;
 	u64 __percpu *bat_counters; /* Per cpu counters */
+	u64 __percpu *txq_counters; /* Per cpu counters */
+#ifdef CONFIG_BATMAN_ADV_LATENCY
+	struct batadv_latency_hist __percpu *latency;
+#endif
+	atomic_t forward_pps;
+	u64 forward_last_cnt;
+	unsigned long forward_last_time;
 	atomic_t aggregated_ogms;
 	atomic_t bonding;
 	atomic_t fragmentation;
@@ -910,6 +1185,7 @@ struct batadv_priv {
 #endif
 #ifdef CONFIG_BATMAN_ADV_DAT
 	atomic_t distributed_arp_table;
+	atomic_t dat_max_entries;
 #endif
 #ifdef CONFIG_BATMAN_ADV_MCAST
 	atomic_t multicast_mode;
@@ -917,6 +1193,10 @@ struct batadv_priv {
 	atomic_t gw_mode;
 	atomic_t gw_sel_class;
 	atomic_t orig_interval;
+	atomic_t orig_interval_adaptive;
+	atomic_t orig_interval_max;
+	atomic_t ogm_churn;
+	unsigned long ogm_churn_time;
 	atomic_t hop_penalty;
 #ifdef CONFIG_BATMAN_ADV_DEBUG
 	atomic_t log_level;
@@ -937,9 +1217,13 @@ struct batadv_priv {
 	struct delayed_work orig_work;
 	struct work_struct cleanup_work;
 	struct batadv_hard_iface __rcu *primary_if;  /* rcu protected pointer */
+	struct batadv_hardif_array __rcu *hardif_array;
 	struct batadv_algo_ops *bat_algo_ops;
 	struct hlist_head softif_vlan_list;
 	spinlock_t softif_vlan_list_lock; /* protects softif_vlan_list */
+	struct hlist_head tp_list;
+	spinlock_t tp_list_lock; /* protects tp_list & tp_num */
+	atomic_t tp_num;
 #ifdef CONFIG_BATMAN_ADV_BLA
 	struct batadv_priv_bla bla;
 #endif
@@ -968,6 +1252,9 @@ struct batadv_priv {
  * struct batadv_socket_client - layer2 icmp socket client data
  * @queue_list: packet queue for packets destined for this socket client
  * @queue_len: number of packets in the packet queue (queue_list)
+ * @queue_max: maximum number of packets kept in the packet queue
+ * @batch: whether the client exchanges batadv_icmp_socket_record framed
+ *  batches instead of single packets
  * @index: socket client's index in the batadv_socket_client_hash
  * @lock: lock protecting queue_list, queue_len & index
  * @queue_wait: socket client's wait queue
@@ -976,6 +1263,8 @@ struct batadv_priv {
 struct batadv_socket_client {
 	struct list_head queue_list;
 	unsigned int queue_len;
+	unsigned int queue_max;
+	bool batch;
 	unsigned char index;
 	spinlock_t lock; /* protects queue_list, queue_len & index */
 	wait_queue_head_t queue_wait;
@@ -986,14 +1275,96 @@ struct batadv_socket_client {
  * struct batadv_socket_packet - layer2 icmp packet for socket client
  * @list: list node for batadv_socket_client::queue_list
  * @icmp_len: size of the layer2 icmp packet
+ * @timestamp: time at which the packet was queued
  * @icmp_packet: layer2 icmp packet
  */
 struct batadv_socket_packet {
 	struct list_head list;
 	size_t icmp_len;
+	ktime_t timestamp;
 	u8 icmp_packet[BATADV_ICMP_MAX_PACKET_SIZE];
 };
 
+/**
+ * enum batadv_tp_meter_role - role of this node in a throughput meter session
+ * @BATADV_TP_RECEIVER: this node receives the test data and sends the acks
+ * @BATADV_TP_SENDER: this node sends the test data
+ */
+enum batadv_tp_meter_role {
+	BATADV_TP_RECEIVER,
+	BATADV_TP_SENDER,
+};
+
+/**
+ * struct batadv_tp_vars - throughput meter session data
+ * @list: list node for batadv_priv::tp_list
+ * @role: role of this node in the session
+ * @other_end: mac address of the remote end of the session
+ * @session: session identifier shared with the remote end
+ * @cookie: session identifier reported to userspace
+ * @sending: whether the sender thread is still transmitting
+ * @reason: why the sender stopped (see enum batadv_tp_meter_reason)
+ * @start_time: jiffies at which the session was created
+ * @finish_time: jiffies at which the sender stopped
+ * @test_length: requested duration of the test in milliseconds
+ * @last_acked: first byte not acknowledged yet (sender) or next byte expected
+ *  in order (receiver)
+ * @last_sent: first byte to send next
+ * @high_sent: first byte never sent so far
+ * @recover: the window is not reduced again before this byte got acknowledged
+ * @cwnd: congestion window in bytes
+ * @ss_threshold: slow start threshold in bytes
+ * @dup_acks: number of duplicate acks received in a row
+ * @backoffs: number of retransmission timeouts without progress in between
+ * @srtt: smoothed round trip time in microseconds (0 before the first sample)
+ * @rttvar: round trip time variation in microseconds
+ * @rto: retransmission timeout in milliseconds
+ * @last_progress: jiffies at which the window advanced (sender) or the last
+ *  packet was received (receiver)
+ * @acked_bytes: payload bytes acknowledged by the receiver
+ * @tot_sent: number of test packets sent including retransmissions
+ * @retransmits: number of test packets sent more than once
+ * @lock: lock protecting the window and the statistics of the session
+ * @more_bytes: wait queue of the sender thread waiting for window space
+ * @finished: completed when the sender thread has terminated
+ * @bat_priv: the bat priv with all the soft interface information
+ * @refcount: number of contexts the object is used
+ * @rcu: struct used for freeing in an RCU-safe manner
+ */
+struct batadv_tp_vars {
+	struct hlist_node list;
+	enum batadv_tp_meter_role role;
+	u8 other_end[ETH_ALEN];
+	u8 session[2];
+	u32 cookie;
+	atomic_t sending;
+	u8 reason;
+	unsigned long start_time;
+	unsigned long finish_time;
+	u32 test_length;
+	u32 last_acked;
+	u32 last_sent;
+	u32 high_sent;
+	u32 recover;
+	u32 cwnd;
+	u32 ss_threshold;
+	u8 dup_acks;
+	u8 backoffs;
+	u32 srtt;
+	u32 rttvar;
+	u32 rto;
+	unsigned long last_progress;
+	u64 acked_bytes;
+	u32 tot_sent;
+	u32 retransmits;
+	spinlock_t lock; /* protects window & statistics */
+	wait_queue_head_t more_bytes;
+	struct completion finished;
+	struct batadv_priv *bat_priv;
+	struct kref refcount;
+	struct rcu_head rcu;
+};
+
 #ifdef CONFIG_BATMAN_ADV_BLA
 
 /**
@@ -1055,6 +1426,7 @@ struct batadv_bla_claim {
  * @hash_entry: hlist node for batadv_priv_tt::local_hash or for
  *  batadv_priv_tt::global_hash
  * @flags: various state handling flags (see batadv_tt_client_flags)
+ * @accounted: whether the entry is currently counted in batadv_tt_stats
  * @added_at: timestamp used for purging stale tt common entries
  * @refcount: number of contexts the object is used
  * @rcu: struct used for freeing in an RCU-safe manner
@@ -1064,6 +1436,7 @@ struct batadv_tt_common_entry {
 	unsigned short vid;
 	struct hlist_node hash_entry;
 	u16 flags;
+	bool accounted;
 	unsigned long added_at;
 	struct kref refcount;
 	struct rcu_head rcu;
@@ -1212,9 +1585,12 @@ struct batadv_nc_packet {
  *  relevant to batman-adv in the skb->cb buffer in skbs.
  * @decoded: Marks a skb as decoded, which is checked when searching for coding
  *  opportunities in network-coding.c
+ * @drop_reason: why a receive handler returned NET_RX_DROP for the skb (see
+ *  enum batadv_drop_reason)
  */
 struct batadv_skb_cb {
 	bool decoded;
+	u8 drop_reason;
 };
 
 /**
@@ -1227,6 +1603,8 @@ struct batadv_skb_cb {
  * @packet_len: size of aggregated OGM packet inside the skb buffer
  * @direct_link_flags: direct link flags for aggregated OGM packets
  * @num_packets: counter for bcast packet retransmission
+ * @queue_time: time the bcast packet was queued (only maintained with
+ *  CONFIG_BATMAN_ADV_LATENCY)
  * @delayed_work: work queue callback item for packet sending
  * @if_incoming: pointer to incoming hard-iface or primary iface if
  *  locally generated packet
@@ -1241,11 +1619,30 @@ struct batadv_forw_packet {
 	u16 packet_len;
 	u32 direct_link_flags;
 	u8 num_packets;
+	ktime_t queue_time;
 	struct delayed_work delayed_work;
 	struct batadv_hard_iface *if_incoming;
 	struct batadv_hard_iface *if_outgoing;
 };
 
+/**
+ * struct batadv_netlink_filter - filter of a netlink table dump request
+ * @orig: only report entries belonging to this originator
+ * @vid: only report entries of this vlan
+ * @ttvn: only report translation table entries announced after this ttvn
+ * @orig_set: whether @orig was supplied by the requester
+ * @vid_set: whether @vid was supplied by the requester
+ * @ttvn_set: whether @ttvn was supplied by the requester
+ */
+struct batadv_netlink_filter {
+	u8 orig[ETH_ALEN];
+	unsigned short vid;
+	u8 ttvn;
+	bool orig_set;
+	bool vid_set;
+	bool ttvn_set;
+};
+
 /**
  * struct batadv_algo_ops - mesh algorithm callbacks
  * @list: list node for the batadv_algo_list
@@ -1257,6 +1654,8 @@ struct batadv_forw_packet {
  * @bat_primary_iface_set: called when primary interface is selected / changed
  * @bat_ogm_schedule: prepare a new outgoing OGM for the send queue
  * @bat_ogm_emit: send scheduled OGM
+ * @bat_ogm_reschedule: send the pending own OGM of a hard-interface within the
+ *  given interval if it is due later (optional)
  * @bat_hardif_neigh_init: called on creation of single hop entry
  * @bat_neigh_cmp: compare the metrics of two neighbors for their respective
  *  outgoing interfaces
@@ -1264,13 +1663,13 @@ struct batadv_forw_packet {
  *  better than neigh2 for their respective outgoing interface from the metric
  *  prospective
  * @bat_neigh_print: print the single hop neighbor list (optional)
+ * @bat_neigh_dump_metric: add the metric of a neighbor towards an outgoing
+ *  interface to a netlink message (optional)
  * @bat_neigh_free: free the resources allocated by the routing algorithm for a
  *  neigh_node object
  * @bat_orig_print: print the originator table (optional)
  * @bat_orig_free: free the resources allocated by the routing algorithm for an
  *  orig_node object
- * @bat_orig_add_if: ask the routing algorithm to apply the needed changes to
- *  the orig_node due to a new hard-interface being added into the mesh
  * @bat_orig_del_if: ask the routing algorithm to apply the needed changes to
  *  the orig_node due to an hard-interface being removed from the mesh
  */
@@ -1283,6 +1682,9 @@ struct batadv_algo_ops {
 	void (*bat_primary_iface_set)(struct batadv_hard_iface *hard_iface);
 	void (*bat_ogm_schedule)(struct batadv_hard_iface *hard_iface);
 	void (*bat_ogm_emit)(struct batadv_forw_packet *forw_packet);
+	void (*bat_ogm_reschedule)(struct batadv_priv *bat_priv,
+				   struct batadv_hard_iface *hard_iface,
+				   unsigned int interval);
 	/* neigh_node handling API */
 	void (*bat_hardif_neigh_init)(struct batadv_hardif_neigh_node *neigh);
 	int (*bat_neigh_cmp)(struct batadv_neigh_node *neigh1,
@@ -1295,33 +1697,48 @@ struct batadv_algo_ops {
 		 struct batadv_neigh_node *neigh2,
 		 struct batadv_hard_iface *if_outgoing2);
 	void (*bat_neigh_print)(struct batadv_priv *priv, struct seq_file *seq);
+	int (*bat_neigh_dump_metric)(struct sk_buff *msg,
+				     struct batadv_neigh_node *neigh,
+				     struct batadv_hard_iface *if_outgoing);
 	void (*bat_neigh_free)(struct batadv_neigh_node *neigh);
 	/* orig_node handling API */
 	void (*bat_orig_print)(struct batadv_priv *priv, struct seq_file *seq,
 			       struct batadv_hard_iface *hard_iface);
 	void (*bat_orig_free)(struct batadv_orig_node *orig_node);
-	int (*bat_orig_add_if)(struct batadv_orig_node *orig_node,
-			       int max_if_num);
 	int (*bat_orig_del_if)(struct batadv_orig_node *orig_node,
 			       int max_if_num, int del_if_num);
 };
 
 /**
  * struct batadv_dat_entry - it is a single entry of batman-adv ARP backend. It
- * is used to stored ARP entries needed for the global DAT cache
- * @ip: the IPv4 corresponding to this DAT/ARP entry
- * @mac_addr: the MAC address associated to the stored IPv4
+ * is used to stored ARP and IPv6 neighbor entries needed for the global DAT
+ * cache
+ * @ip: the IPv4 corresponding to this DAT/ARP entry (AF_INET only)
+ * @ip6: the IPv6 address corresponding to this DAT/ND entry (AF_INET6 only)
+ * @family: address family of the entry (AF_INET or AF_INET6)
+ * @router: whether the owner of @ip6 announced itself as router in its last
+ *  neighbor advertisement
+ * @mac_addr: the MAC address associated to the stored IP address
  * @vid: the vlan ID associated to this entry
  * @last_update: time in jiffies when this entry was refreshed last time
+ * @last_refresh: time in jiffies when a refresh of this entry was last
+ *  requested from the DHT
+ * @referenced: whether the entry was looked up since the cache eviction last
+ *  visited it
  * @hash_entry: hlist node for batadv_priv_dat::hash
  * @refcount: number of contexts the object is used
  * @rcu: struct used for freeing in an RCU-safe manner
  */
 struct batadv_dat_entry {
 	__be32 ip;
+	struct in6_addr ip6;
+	u8 family;
+	bool router;
 	u8 mac_addr[ETH_ALEN];
 	unsigned short vid;
 	unsigned long last_update;
+	unsigned long last_refresh;
+	bool referenced;
 	struct hlist_node hash_entry;
 	struct kref refcount;
 	struct rcu_head rcu;
@@ -0,0 +1,334 @@
+#! /bin/sh
+#
+# Copyright (C) 2016  B.A.T.M.A.N. contributors:
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of version 2 of the GNU General Public
+# License as published by the Free Software Foundation.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, see <http://www.gnu.org/licenses/>.
+#
+# Emulate a chain of batman-adv nodes in network namespaces connected by
+# veth pairs shaped with tc netem, run a fixed set of measurements and tear
+# everything down again. The results are printed as "name value" lines which
+# can be compared against a baseline with "netns-benchmark.sh compare".
+
+set -e
+
+NODES="${NODES:=8}"
+ALGO="${ALGO:=BATMAN_IV}"
+NETEM="${NETEM:=delay 1ms}"
+DURATION="${DURATION:=10}"
+CLIENTS="${CLIENTS:=10000}"
+FRAG_MTU="${FRAG_MTU:=1400}"
+TT_TIMEOUT="${TT_TIMEOUT:=120}"
+STREAMS="${STREAMS:=$(nproc)}"
+TXQS="${TXQS:=$(nproc)}"
+MODULE="${MODULE:=net/batman-adv/batman-adv.ko}"
+PREFIX="${PREFIX:=batbench}"
+DEBUGFS="/sys/kernel/debug/batman_adv"
+
+usage()
+{
+	cat << EOF
+Usage: $0 [run]
+       $0 compare BASELINE RESULT
+
+Environment:
+  NODES       number of nodes in the chain (default: ${NODES})
+  ALGO        routing algorithm (default: ${ALGO})
+  NETEM       netem parameters of every link (default: "${NETEM}")
+  DURATION    seconds per traffic measurement (default: ${DURATION})
+  CLIENTS     clients joining for the TT measurement (default: ${CLIENTS})
+  FRAG_MTU    veth MTU for the fragmentation run (default: ${FRAG_MTU})
+  TT_TIMEOUT  seconds to wait for TT convergence (default: ${TT_TIMEOUT})
+  STREAMS     parallel TCP streams of the tx measurement (default: ${STREAMS})
+  TXQS        tx queues of every mesh interface (default: ${TXQS})
+  MODULE      module loaded when batman-adv is missing (default: ${MODULE})
+EOF
+}
+
+# compare two result files and print the relative change of every value
+compare()
+{
+	awk '
+		NR == FNR { base[$1] = $2; next }
+		!($1 in base) { printf "%-28s %14s %14s\n", $1, "-", $2; next }
+		{
+			change = "n/a"
+			diff = ($2 - base[$1]) * 100
+			if (base[$1] != 0)
+				change = sprintf("%+.1f%%", diff / base[$1])
+			printf "%-28s %14s %14s %8s\n", $1, base[$1], $2, change
+		}
+	' "$1" "$2"
+}
+
+ns()
+{
+	echo "${PREFIX}$1"
+}
+
+ip4()
+{
+	echo "10.0.$(($1 / 250)).$(($1 % 250 + 1))"
+}
+
+# print the ethtool counter $2 of node $1
+counter()
+{
+	ip netns exec "$(ns $1)" ethtool -S "bat$1" | \
+		awk -v name="$2:" '$1 == name { print $2 }'
+}
+
+# print the sum of the ethtool counter $1 over all nodes
+counter_sum()
+{
+	SUM=0
+	for i in $(seq 1 "${NODES}"); do
+		SUM=$((SUM + $(counter "$i" "$1")))
+	done
+	echo "${SUM}"
+}
+
+# print the number of local or global ($2) TT entries of node $1
+tt_entries()
+{
+	awk -v name="$2" '$1 == name && $2 == "entries:" { print $3 }' \
+		"${DEBUGFS}/bat$1/transtable_stats"
+}
+
+now()
+{
+	date +%s.%N
+}
+
+# print the per second rate of $1 over the time from $2 to $3
+rate()
+{
+	echo "$1 $2 $3" | awk '{ printf "%.1f\n", $1 / ($3 - $2) }'
+}
+
+teardown()
+{
+	for i in $(seq 1 "${NODES}"); do
+		ip netns del "$(ns $i)" 2> /dev/null || true
+	done
+}
+
+# connect node $1 and $2 with a shaped veth pair of MTU ${MTU}
+link()
+{
+	A="v$1-$2"
+	B="v$2-$1"
+
+	ip link add "${A}" netns "$(ns $1)" type veth \
+		peer name "${B}" netns "$(ns $2)"
+
+	for end in "$1 ${A}" "$2 ${B}"; do
+		set -- ${end}
+		ip -n "$(ns $1)" link set dev "$2" mtu "${MTU}"
+		ip -n "$(ns $1)" link set dev "$2" master "bat$1"
+		ip -n "$(ns $1)" link set up dev "$2"
+		ip netns exec "$(ns $1)" tc qdisc add dev "$2" root netem \
+			${NETEM}
+	done
+}
+
+setup()
+{
+	MTU="$1"
+
+	teardown
+	for i in $(seq 1 "${NODES}"); do
+		ip netns add "$(ns $i)"
+		ip -n "$(ns $i)" link set up dev lo
+		ip -n "$(ns $i)" link add "bat$i" numtxqueues "${TXQS}" \
+			type batadv
+		ip -n "$(ns $i)" addr add "$(ip4 $i)/16" dev "bat$i"
+		ip -n "$(ns $i)" link set up dev "bat$i"
+	done
+
+	for i in $(seq 2 "${NODES}"); do
+		link $((i - 1)) "$i"
+	done
+
+	# wait until the end nodes can reach each other
+	for try in $(seq 1 60); do
+		ip netns exec "$(ns 1)" ping -q -c 1 -W 1 "$(ip4 ${NODES})" \
+			> /dev/null 2>&1 && return 0
+	done
+
+	echo "mesh did not converge" >&2
+	exit 1
+}
+
+# forwarded packets per second on the intermediate nodes for unicast UDP
+# between the end nodes
+unicast()
+{
+	NAME="$1"
+
+	ip netns exec "$(ns ${NODES})" iperf3 -s -D -1 > /dev/null
+	sleep 1
+
+	FWD="$(counter_sum forward)"
+	FRAG="$(counter_sum frag_fwd)"
+	START="$(now)"
+	BPS="$(ip netns exec "$(ns 1)" iperf3 -c "$(ip4 ${NODES})" -u -b 0 \
+		-t "${DURATION}" -J | \
+		awk -F '[:,]' '/"bits_per_second"/ { v = $2 + 0 }
+			       END { print v }')"
+	END="$(now)"
+	FWD="$(($(counter_sum forward) - FWD))"
+	FRAG="$(($(counter_sum frag_fwd) - FRAG))"
+
+	echo "${NAME}_forward_pps $(rate "${FWD}" "${START}" "${END}")"
+	echo "${NAME}_frag_fwd_pps $(rate "${FRAG}" "${START}" "${END}")"
+	echo "${NAME}_throughput_bps ${BPS}"
+}
+
+# packets per second sent by the mesh interface of the first node while
+# STREAMS TCP connections transmit in parallel to its direct neighbour
+tx()
+{
+	ip netns exec "$(ns 2)" iperf3 -s -D -1 > /dev/null
+	sleep 1
+
+	TX="$(counter 1 tx)"
+	START="$(now)"
+	BPS="$(ip netns exec "$(ns 1)" iperf3 -c "$(ip4 2)" -P "${STREAMS}" \
+		-t "${DURATION}" -J | \
+		awk -F '[:,]' '/"bits_per_second"/ { v = $2 + 0 }
+			       END { print v }')"
+	END="$(now)"
+	TX="$(($(counter 1 tx) - TX))"
+
+	echo "tx_pps $(rate "${TX}" "${START}" "${END}")"
+	echo "tx_throughput_bps ${BPS}"
+}
+
+# print the number of frames sent on all veth links
+link_tx_sum()
+{
+	SUM=0
+	for i in $(seq 1 "${NODES}"); do
+		for dev in $(ip -n "$(ns $i)" -o link show type veth | \
+			awk -F '[:@]' '{ print $2 }'); do
+			STATS="/sys/class/net/${dev}/statistics"
+			SUM=$((SUM + $(ip netns exec "$(ns $i)" \
+				cat "${STATS}/tx_packets")))
+		done
+	done
+	echo "${SUM}"
+}
+
+# frames on the links per broadcast sent by the first node, including the
+# routing protocol messages sent in the meantime
+broadcast()
+{
+	COUNT=$((DURATION * 100))
+
+	TX="$(link_tx_sum)"
+	ip netns exec "$(ns 1)" ping -q -b -i 0.01 -c "${COUNT}" -W 1 \
+		"10.0.255.255" > /dev/null 2>&1 || true
+	TX="$(($(link_tx_sum) - TX))"
+
+	echo "${TX} ${COUNT}" | \
+		awk '{ printf "broadcast_tx_per_packet %.2f\n", $1 / $2 }'
+}
+
+# routing protocol overhead of the idle mesh
+idle()
+{
+	TX="$(counter_sum mgmt_tx)"
+	BYTES="$(counter_sum mgmt_tx_bytes)"
+	START="$(now)"
+	sleep "${DURATION}"
+	END="$(now)"
+	TX="$(($(counter_sum mgmt_tx) - TX))"
+	BYTES="$(($(counter_sum mgmt_tx_bytes) - BYTES))"
+
+	echo "idle_mgmt_tx_pps $(rate "${TX}" "${START}" "${END}")"
+	echo "idle_mgmt_tx_Bps $(rate "${BYTES}" "${START}" "${END}")"
+}
+
+# time until the last node learned all clients joining at the first node
+tt_convergence()
+{
+	LOCAL="$(tt_entries 1 Local)"
+	GLOBAL="$(tt_entries ${NODES} Global)"
+	START="$(now)"
+
+	ip netns exec "$(ns 1)" python3 - "bat1" "${CLIENTS}" << 'EOF'
+import socket, struct, sys
+
+sock = socket.socket(socket.AF_PACKET, socket.SOCK_RAW)
+sock.bind((sys.argv[1], 0))
+for i in range(int(sys.argv[2])):
+    src = struct.pack('!HI', 0x0200, i + 1)
+    sock.send(b'\xff' * 6 + src + b'\x88\xb5' + b'\x00' * 46)
+EOF
+
+	# the local table may refuse clients once it exceeds the maximum
+	# TVLV size, only wait for what was actually announced
+	JOINED=$(($(tt_entries 1 Local) - LOCAL))
+	TARGET=$((GLOBAL + JOINED))
+	while [ "$(tt_entries ${NODES} Global)" -lt "${TARGET}" ]; do
+		if [ "$(echo "$(now) ${START} ${TT_TIMEOUT}" | \
+			awk '{ print ($1 - $2 > $3) }')" = 1 ]; then
+			echo "tt_convergence_s timeout"
+			return 0
+		fi
+		sleep 0.1
+	done
+
+	echo "tt_clients ${JOINED}"
+	echo "tt_convergence_s $(echo "$(now) ${START}" | \
+		awk '{ printf "%.2f\n", $1 - $2 }')"
+}
+
+run()
+{
+	[ "$(id -u)" = 0 ] || { echo "must be run as root" >&2; exit 1; }
+	for tool in ip tc ethtool iperf3 python3; do
+		command -v "${tool}" > /dev/null || {
+			echo "${tool} is missing" >&2
+			exit 1
+		}
+	done
+
+	[ -d /sys/module/batman_adv ] || insmod "${MODULE}"
+	echo "${ALGO}" > /sys/module/batman_adv/parameters/routing_algo
+	trap teardown EXIT INT TERM
+
+	setup 1500
+	unicast unicast
+	tx
+	broadcast
+	idle
+	tt_convergence
+
+	setup "${FRAG_MTU}"
+	unicast frag
+}
+
+case "${1:-run}" in
+run)
+	run
+	;;
+compare)
+	[ "$#" = 3 ] || { usage >&2; exit 1; }
+	compare "$2" "$3"
+	;;
+*)
+	usage >&2
+	exit 1
+	;;
+esac